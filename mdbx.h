@@ -288,6 +288,12 @@ typedef int(MDBX_cmp_func)(const MDBX_val *a, const MDBX_val *b);
 #define MDBX_UTTERLY_NOSYNC (MDBX_NOSYNC | MDBX_MAPASYNC)
 /* debuging option, fill/perturb released pages */
 #define MDBX_PAGEPERTURB 0x8000000u
+/* concurrent committers share a single fsync, which is done in background */
+#define MDBX_GROUPCOMMIT 0x8000u
+/* write dirty pages bypassing the system buffers */
+#define MDBX_DIRECTWRITE 0x2000u
+/* start writeback of pages at once after commit, to make a sync shorter */
+#define MDBX_WRITEBACK 0x1000u
 
 /* Database Flags */
 /* use reverse string keys */
@@ -303,6 +309,10 @@ typedef int(MDBX_cmp_func)(const MDBX_val *a, const MDBX_val *b);
 #define MDBX_INTEGERDUP 0x20u
 /* with MDBX_DUPSORT, use reverse string dups */
 #define MDBX_REVERSEDUP 0x40u
+/* maintain the counts of items within subtrees, for access by rank */
+#define MDBX_COUNTED 0x80u
+/* keep fingerprints of keys next to the node pointers of pages */
+#define MDBX_FPRINT 0x100u
 /* create DB if not already existing */
 #define MDBX_CREATE 0x40000u
 
@@ -326,6 +336,9 @@ typedef int(MDBX_cmp_func)(const MDBX_val *a, const MDBX_val *b);
 #define MDBX_APPENDDUP 0x40000u
 /* Store multiple data items in one call. Only for MDBX_DUPFIXED. */
 #define MDBX_MULTIPLE 0x80000u
+/* For batch operations: the keys are already sorted according to the
+ * database's key comparison function. */
+#define MDBX_SORTED 0x100000u
 
 /* Transaction Flags */
 /* Do not block when starting a write transaction */
@@ -639,6 +652,44 @@ LIBMDBX_API int mdbx_env_create(MDBX_env **penv);
  *      write IPOs in case MDBX_NOSYNC with periodically checkpoints.
  *      FIXME: TODO
  *
+ *  - MDBX_GROUPCOMMIT
+ *      Share a single flush of system buffers between concurrent writers.
+ *      A commit writes a weak meta-page as with mdbx_txn_commit_async(),
+ *      releases the write lock and then waits as mdbx_env_wait_durable()
+ *      does, so the commits which arrive while a flush is running are made
+ *      durable together by the next one. The mdbx_txn_commit() returns only
+ *      once the transaction is durable, but unlike the default mode an error
+ *      of the flush is returned after the changes became visible to others.
+ *      The flag has no effect with MDBX_NOSYNC, and it may be changed at any
+ *      time using mdbx_env_set_flags().
+ *
+ *  - MDBX_DIRECTWRITE
+ *      Write the dirty pages through a second descriptor of the data file
+ *      which is opened with O_DIRECT (F_NOCACHE on OS X). So the committed
+ *      pages are not copied to system buffers for being flushed again by a
+ *      sync, and don't evict hot pages of readers. The memory map is still
+ *      used for reading, and memory for dirty pages is allocated aligned to
+ *      the system page. A sync is still required to flush a disk cache, so
+ *      MDBX_NOSYNC and others keep their meaning. The flag is silently
+ *      ignored with MDBX_WRITEMAP or MDBX_RDONLY, when the DB page size is
+ *      less than the system page, or the filesystem doesn't support direct
+ *      I/O, and mdbx_env_get_flags() shows whether it is in effect.
+ *      Note that each direct write waits for a disk, therefore a commit of
+ *      many scattered pages is faster only if libmdbx is built with the
+ *      MDBX_USE_IOURING option, which keeps them all in flight.
+ *
+ *  - MDBX_WRITEBACK
+ *      Start asynchronous writeback of the pages to disk as soon as they are
+ *      written to system buffers or the map by a commit which doesn't sync,
+ *      e.g. with MDBX_NOSYNC, MDBX_MAPASYNC or mdbx_txn_commit_async(). So a
+ *      sync, which is done by mdbx_env_sync(), or once the amount of unsynced
+ *      data reaches the mdbx_env_set_syncbytes() threshold, only waits for
+ *      the tail rather than writes all of the data at once. It uses the
+ *      sync_file_range() on Linux, otherwise msync(MS_ASYNC) on the range of
+ *      written pages, which is issued by a background thread so the commit
+ *      doesn't wait for it. This flag may be changed at any time using
+ *      mdbx_env_set_flags().
+ *
  * [in] mode The UNIX permissions to set on created files.
  *
  * Returns A non-zero error value on failure and 0 on success, some
@@ -739,6 +790,27 @@ LIBMDBX_API int mdbx_env_info(MDBX_env *env, MDBX_envinfo *info, size_t bytes);
  *  - MDBX_EIO      - an error occurred during synchronization. */
 LIBMDBX_API int mdbx_env_sync(MDBX_env *env, int force);
 
+/* Wait until a committed transaction is durably written to disk.
+ *
+ * This is the counterpart of mdbx_txn_commit_async(), but any txnid could
+ * be passed, e.g. from mdbx_txn_id(). When the transaction is not durable
+ * yet, the background thread of the environment is asked to flush it.
+ *
+ * [in] env         An environment handle returned by mdbx_env_create()
+ * [in] txnid       ID of the transaction to wait for.
+ * [in] timeout_ms  The timeout in milliseconds, zero to just check the
+ *                  state, or MDBX_WAIT_INFINITE to wait without a limit.
+ *
+ * Returns A non-zero error value on failure and 0 on success, some
+ * possible errors are:
+ *  - MDBX_RESULT_TRUE  - the timeout expired, but the transaction
+ *                        is not durable yet.
+ *  - MDBX_EACCES       - the environment is read-only.
+ *  - MDBX_EIO          - an error occurred during synchronization. */
+#define MDBX_WAIT_INFINITE (~0u)
+LIBMDBX_API int mdbx_env_wait_durable(MDBX_env *env, uint64_t txnid,
+                                      unsigned timeout_ms);
+
 /* Close the environment and release the memory map.
  *
  * Only a single thread may call this function. All transactions, databases,
@@ -874,6 +946,36 @@ LIBMDBX_API int mdbx_env_set_maxreaders(MDBX_env *env, unsigned readers);
  *  - MDBX_EINVAL   - an invalid parameter was specified. */
 LIBMDBX_API int mdbx_env_get_maxreaders(MDBX_env *env, unsigned *readers);
 
+/* Set the maximum number of dirty pages within a write transaction.
+ *
+ * The modified pages are kept in memory until commit. Once their number
+ * approaches this limit, a part of them is written to the database file
+ * (spilled) to make a room, and MDBX_TXN_FULL is returned if that isn't
+ * possible. A larger limit allows a bigger transaction to be committed
+ * without spilling, at the cost of memory for the pages. The new limit
+ * takes effect for the next write transaction.
+ *
+ * The default is 131071 pages. Pass 0 to restore the default, or SIZE_MAX
+ * to keep all the dirty pages in memory.
+ *
+ * [in] env    An environment handle returned by mdbx_env_create()
+ * [in] pages  The maximum number of dirty pages, at least 1024.
+ *
+ * Returns A non-zero error value on failure and 0 on success, some
+ * possible errors are:
+ *  - MDBX_EINVAL   - an invalid parameter was specified. */
+LIBMDBX_API int mdbx_env_set_maxdirty(MDBX_env *env, size_t pages);
+
+/* Get the maximum number of dirty pages within a write transaction.
+ *
+ * [in] env     An environment handle returned by mdbx_env_create()
+ * [out] pages  Address of a size_t to store the number of pages
+ *
+ * Returns A non-zero error value on failure and 0 on success, some
+ * possible errors are:
+ *  - MDBX_EINVAL   - an invalid parameter was specified. */
+LIBMDBX_API int mdbx_env_get_maxdirty(MDBX_env *env, size_t *pages);
+
 /* Set the maximum number of named databases for the environment.
  *
  * This function is only needed if multiple databases will be used in the
@@ -1013,6 +1115,33 @@ LIBMDBX_API uint64_t mdbx_txn_id(MDBX_txn *txn);
  *  - MDBX_ENOMEM   - out of memory. */
 LIBMDBX_API int mdbx_txn_commit(MDBX_txn *txn);
 
+/* Commit a write transaction without waiting for its data to be durable.
+ *
+ * Like mdbx_txn_commit(), but the changes are written with a weak meta-page,
+ * as with MDBX_NOSYNC, and the call returns as soon as they are visible to
+ * subsequent transactions. A background thread of the environment, which is
+ * started on demand, then flushes the data and makes the meta-page steady.
+ * Commits which arrive while a flush is running are coalesced into the
+ * next one. The data is flushed without holding the write lock, so the next
+ * transactions are built and committed meanwhile, and only the meta-page is
+ * written and flushed under the lock. Use mdbx_env_wait_durable() to wait
+ * until the returned txnid is durable.
+ *
+ * The transaction handle is freed, just as by mdbx_txn_commit().
+ *
+ * [in] txn     A top-level write transaction handle.
+ * [out] txnid  Address where the ID of the committed transaction will be
+ *              stored, for an empty commit it is ID of the previous one.
+ *
+ * Returns A non-zero error value on failure and 0 on success, some
+ * possible errors are:
+ *  - MDBX_EINVAL   - an invalid parameter was specified, e.g. a nested
+ *                    or a read-only transaction.
+ *  - MDBX_ENOSPC   - no more disk space.
+ *  - MDBX_EIO      - a low-level I/O error occurred while writing.
+ *  - MDBX_ENOMEM   - out of memory. */
+LIBMDBX_API int mdbx_txn_commit_async(MDBX_txn *txn, uint64_t *txnid);
+
 /* Abandon all the operations of the transaction instead of saving them.
  *
  * The transaction handle is freed. It and its cursors must not be used
@@ -1114,6 +1243,30 @@ LIBMDBX_API int mdbx_txn_renew(MDBX_txn *txn);
  *      This option specifies that duplicate data items should be compared as
  *      strings in reverse order (the comparison is performed in the direction
  *      from the last byte to the first).
+ *  - MDBX_COUNTED
+ *      Each branch page keeps the number of items within the subtree of each
+ *      child, including the duplicates for MDBX_DUPSORT. This makes the
+ *      branch nodes 8 bytes longer and every update a bit more expensive,
+ *      but allows mdbx_cursor_seek_rank(), mdbx_cursor_get_rank() and the
+ *      MDBX_ESTIMATE_EXACT mode of mdbx_estimate_range() to run in O(log N).
+ *      The option could be changed only while the table is empty.
+ *      This is a change of the datafile format, the same as for MDBX_FPRINT
+ *      below: former versions of libmdbx refuse to open the datafile once
+ *      such a table is committed.
+ *  - MDBX_FPRINT
+ *      Each page keeps two bytes of every key, which follow the key prefix
+ *      common for the page, right next to the pointer to the node. So the
+ *      binary search within a page runs on this dense array and compares
+ *      only one or two keys in full, instead of touching a node on each
+ *      step. This takes 2 more bytes per item and 4 bytes per page, and is
+ *      only useful with the default comparison of keys, so it can't be
+ *      combined with MDBX_REVERSEKEY or MDBX_INTEGERKEY, and is of no use
+ *      with a custom keycmp. The option could be changed only while the
+ *      table is empty.
+ *      This is a change of the datafile format: once such a table is
+ *      committed, the datafile is marked with the feature for good, even
+ *      if the table is dropped later, and former versions of libmdbx refuse
+ *      to open it with MDBX_VERSION_MISMATCH.
  *  - MDBX_CREATE
  *      Create the named database if it doesn't exist. This option is not
  *      allowed in a read-only transaction or a read-only environment.
@@ -1125,7 +1278,9 @@ LIBMDBX_API int mdbx_txn_renew(MDBX_txn *txn);
  *  - MDBX_NOTFOUND  - the specified database doesn't exist in the
  *                     environment and MDBX_CREATE was not specified.
  *  - MDBX_DBS_FULL  - too many databases have been opened.
- *                     See mdbx_env_set_maxdbs(). */
+ *                     See mdbx_env_set_maxdbs().
+ *  - MDBX_EINVAL    - MDBX_FPRINT is combined with MDBX_REVERSEKEY
+ *                     or MDBX_INTEGERKEY. */
 LIBMDBX_API int mdbx_dbi_open_ex(MDBX_txn *txn, const char *name,
                                  unsigned flags, MDBX_dbi *dbi,
                                  MDBX_cmp_func *keycmp, MDBX_cmp_func *datacmp);
@@ -1160,6 +1315,64 @@ LIBMDBX_API int mdbx_dbi_flags_ex(MDBX_txn *txn, MDBX_dbi dbi, unsigned *flags,
                                   unsigned *state);
 LIBMDBX_API int mdbx_dbi_flags(MDBX_txn *txn, MDBX_dbi dbi, unsigned *flags);
 
+/* Set the page split policy and the merge threshold of a database.
+ *
+ * By default a full page is split in halves, except an insertion at the
+ * end of the page, in which case the left page is kept as full as possible.
+ * A page is merged with a neighbor when it becomes less than 25% full.
+ * With mixed insert/delete workloads this could make pages oscillate
+ * between splits and merges, so a hot database could trade space for
+ * fewer structural modifications.
+ *
+ * The settings are persisted with the database record, i.e. they are
+ * stored at commit of the transaction and remain in effect for all further
+ * transactions. They apply to the leaf pages of the main tree of the
+ * database, but not to the nested trees of MDBX_DUPSORT duplicates.
+ *
+ * [in] txn     A transaction handle returned by mdbx_txn_begin()
+ * [in] dbi     A database handle returned by mdbx_dbi_open()
+ * [in] policy  The split policy, one of the values:
+ *  - MDBX_SPLIT_DEFAULT
+ *      As described above.
+ *  - MDBX_SPLIT_MIDDLE
+ *      Always split in halves, so both pages have room for inserts
+ *      and deletes around the split point.
+ *  - MDBX_SPLIT_APPEND
+ *      An insertion at the end (or the start) of a full page moves only
+ *      the new item to the new page, i.e. the old page stays full.
+ *      The best for append-mostly workloads with keys in multiple
+ *      ascending (or descending) sequences.
+ *  - MDBX_SPLIT_ADAPTIVE
+ *      Split at the insertion point if it continues an ascending or
+ *      descending run of inserts into the page, otherwise in halves.
+ * [in] merge   The merge threshold in percents of page from 1 to 50,
+ *              or 0 for the default. Lower values trade space for fewer
+ *              merges after deletions.
+ *
+ * Returns A non-zero error value on failure and 0 on success, some
+ * possible errors are:
+ *  - MDBX_EACCES   - an attempt was made to modify a read-only transaction.
+ *  - MDBX_EINVAL   - an invalid parameter was specified. */
+#define MDBX_SPLIT_DEFAULT 0u
+#define MDBX_SPLIT_MIDDLE 1u
+#define MDBX_SPLIT_APPEND 2u
+#define MDBX_SPLIT_ADAPTIVE 3u
+LIBMDBX_API int mdbx_dbi_set_policy(MDBX_txn *txn, MDBX_dbi dbi,
+                                    unsigned policy, unsigned merge);
+
+/* Retrieve the page split policy and the merge threshold of a database,
+ * see mdbx_dbi_set_policy().
+ *
+ * [in] txn      A transaction handle returned by mdbx_txn_begin()
+ * [in] dbi      A database handle returned by mdbx_dbi_open()
+ * [out] policy  Address where the split policy will be returned.
+ * [out] merge   Address where the merge threshold will be returned,
+ *               zero means the default.
+ *
+ * Returns A non-zero error value on failure and 0 on success. */
+LIBMDBX_API int mdbx_dbi_get_policy(MDBX_txn *txn, MDBX_dbi dbi,
+                                    unsigned *policy, unsigned *merge);
+
 /* Close a database handle. Normally unnecessary.
  *
  * Use with care:
@@ -1220,6 +1433,121 @@ LIBMDBX_API int mdbx_drop(MDBX_txn *txn, MDBX_dbi dbi, int del);
 LIBMDBX_API int mdbx_get(MDBX_txn *txn, MDBX_dbi dbi, MDBX_val *key,
                          MDBX_val *data);
 
+/* Get items for an array of keys from a database.
+ *
+ * This function is the same as calling mdbx_get() for each key, but the
+ * keys are looked up in sorted order by a single cursor, which only climbs
+ * from the previous key's position as far as needed. Thus neighbouring keys
+ * share the path from the root and the pages loaded for each other.
+ *
+ * The values are returned in the order of the keys and the same way as
+ * mdbx_get() does, see it for restrictions on using the output values.
+ * For keys which are not in the database the corresponding values are set
+ * to the NULL pointer and zero length.
+ *
+ * [in] txn       A transaction handle returned by mdbx_txn_begin()
+ * [in] dbi       A database handle returned by mdbx_dbi_open()
+ * [in] keys      The array of keys to search for in the database
+ * [in] count     The number of keys
+ * [out] values   The array for the data corresponding to the keys
+ * [in] flags     Options for this operation. This parameter must be set to 0
+ *                or to the value described here:
+ *
+ *  - MDBX_SORTED
+ *      The keys are already sorted according to the database's key
+ *      comparison function, so don't check and sort it. Unsorted keys with
+ *      this flag only slow down the lookup, but don't cause an error.
+ *
+ * Returns A non-zero error value on failure and 0 on success, some
+ * possible errors are:
+ *  - MDBX_NOTFOUND  - some of keys were not in the database, but the values
+ *                     are retrieved for others.
+ *  - MDBX_ENOMEM    - out of memory while sorting the keys.
+ *  - MDBX_BAD_VALSIZE - a key has a wrong size for MDBX_INTEGERKEY.
+ *  - MDBX_EINVAL    - an invalid parameter was specified. */
+LIBMDBX_API int mdbx_get_batch(MDBX_txn *txn, MDBX_dbi dbi,
+                               const MDBX_val *keys, size_t count,
+                               MDBX_val *values, unsigned flags);
+
+/* Estimate the number of items and their size within a range of keys.
+ *
+ * This function estimates the number and the size of key/data pairs with
+ * keys in the half-open range [begin, end), where a NULL begin or end means
+ * the range is unbounded on the corresponding side. For MDBX_DUPSORT
+ * databases all duplicates are counted.
+ *
+ * The estimation costs about two lookups. Only the pages on the paths to
+ * the both ends of the range are read, and the items of the leaf pages at
+ * the ends are counted exactly. The part of the tree between these leaves
+ * is estimated from the positions on the paths, assuming the items are
+ * spread evenly over the pages of each level, and from the average size of
+ * items within the edge leaves. So the estimation is exact when the range
+ * is within a leaf or spans two adjacent leaves of the same parent.
+ *
+ * The size includes the overhead of nodes, overflow pages and nested trees
+ * of duplicates, i.e. it is close to the space the items take in the
+ * database, rather than the sum of the lengths of keys and data.
+ *
+ * [in] txn       A transaction handle returned by mdbx_txn_begin()
+ * [in] dbi       A database handle returned by mdbx_dbi_open()
+ * [in] begin     The first key of the range, or NULL.
+ * [in] end       The key following the last key of the range, or NULL.
+ * [out] entries  Address where the number of items will be returned,
+ *                may be NULL.
+ * [out] bytes    Address where the size of items will be returned,
+ *                may be NULL.
+ * [in] flags     Options for this operation. This parameter must be set to 0
+ *                or to the value described here:
+ *
+ *  - MDBX_ESTIMATE_EXACT
+ *      Count the items exactly, also in O(log N). This requires the database
+ *      to be opened with MDBX_COUNTED, otherwise MDBX_INCOMPATIBLE is
+ *      returned. The size is estimated as usual.
+ *
+ * Returns A non-zero error value on failure and 0 on success, some
+ * possible errors are:
+ *  - MDBX_INCOMPATIBLE  - the exact mode is not supported by the database.
+ *  - MDBX_EINVAL        - an invalid parameter was specified. */
+#define MDBX_ESTIMATE_EXACT 1u
+LIBMDBX_API int mdbx_estimate_range(MDBX_txn *txn, MDBX_dbi dbi,
+                                    const MDBX_val *begin, const MDBX_val *end,
+                                    uint64_t *entries, uint64_t *bytes,
+                                    unsigned flags);
+
+/* Split a database into key ranges of about the same size.
+ *
+ * This function chooses separator keys which split the database into the
+ * given number of consecutive half-open ranges, so each range covers about
+ * the same number of leaf pages. The ranges are [NULL, bounds[0]),
+ * [bounds[0], bounds[1]), ... [bounds[count-2], NULL), where NULL means the
+ * range is unbounded on the corresponding side, e.g. for mdbx_cursor_scan().
+ *
+ * The separators are taken from the branch pages near the root. The tree is
+ * descended only until there are enough subtrees at a level to balance the
+ * ranges, so just a few pages are read regardless of the database size.
+ * Fewer ranges are returned if the tree is too small, i.e. the number of
+ * ranges does not exceed the number of leaf pages.
+ *
+ * The returned keys point into the database pages and are valid until the
+ * end of the transaction, or until the next update within a write one. So
+ * a read-only transaction may be used to partition a database for scans
+ * by parallel readers, each of which should use a read-only transaction
+ * of the same snapshot, e.g. by checking its txnid with mdbx_txn_id().
+ *
+ * [in] txn        A transaction handle returned by mdbx_txn_begin()
+ * [in] dbi        A database handle returned by mdbx_dbi_open()
+ * [in,out] count  The number of requested ranges on input, and the number
+ *                 of chosen ones on return.
+ * [out] bounds    The array of (count - 1) items, to which the separator
+ *                 keys are stored, may be NULL if count is 1.
+ *
+ * Returns A non-zero error value on failure and 0 on success, some
+ * possible errors are:
+ *  - MDBX_ENOMEM  - out of memory.
+ *  - MDBX_EINVAL  - an invalid parameter was specified. */
+LIBMDBX_API int mdbx_dbi_partition(MDBX_txn *txn, MDBX_dbi dbi, size_t *count,
+                                   MDBX_val *bounds);
+
 /* Store items into a database.
  *
  * This function stores key/data pairs in the database. The default behavior
@@ -1281,6 +1609,92 @@ LIBMDBX_API int mdbx_get(MDBX_txn *txn, MDBX_dbi dbi, MDBX_val *key,
 LIBMDBX_API int mdbx_put(MDBX_txn *txn, MDBX_dbi dbi, MDBX_val *key,
                          MDBX_val *data, unsigned flags);
 
+/* Store arrays of items into a database.
+ *
+ * This function is the same as calling mdbx_put() for each key/data pair,
+ * but the pairs are stored in sorted order by a single cursor, which only
+ * climbs from the previous pair's position as far as needed. Thus the pairs
+ * are inserted into the current leaf while they belong to it, and a bulk
+ * insert costs about one descent per leaf instead of one per record.
+ * Unlike MDBX_APPEND the keys may interleave with the existing ones.
+ *
+ * [in] txn       A transaction handle returned by mdbx_txn_begin()
+ * [in] dbi       A database handle returned by mdbx_dbi_open()
+ * [in] keys      The array of keys to store
+ * [in] count     The number of key/data pairs
+ * [in,out] data  The array of data to store, one per key
+ * [in] flags     Special options for this operation. This parameter must be
+ *                set to 0 or by bitwise OR'ing together one or more of the
+ *                values described here:
+ *
+ *  - MDBX_SORTED
+ *      The keys are already sorted according to the database's key
+ *      comparison function, so don't check and sort it. Unsorted keys with
+ *      this flag only slow down the insertion, but don't cause an error.
+ *
+ *  - MDBX_NODUPDATA, MDBX_NOOVERWRITE, MDBX_APPEND, MDBX_APPENDDUP
+ *      The same as for mdbx_put(). But the pairs which already appear in
+ *      the database are skipped, and the function returns MDBX_KEYEXIST
+ *      after storing all other ones. For such pairs with MDBX_NOOVERWRITE
+ *      the data is set to point to the existing item.
+ *
+ * Returns A non-zero error value on failure and 0 on success, some
+ * possible errors are:
+ *  - MDBX_KEYEXIST  - some of pairs were already in the database.
+ *  - MDBX_MAP_FULL  - the database is full, see mdbx_env_set_mapsize().
+ *  - MDBX_TXN_FULL  - the transaction has too many dirty pages.
+ *  - MDBX_EACCES    - an attempt was made to write in a read-only transaction.
+ *  - MDBX_ENOMEM    - out of memory while sorting the keys.
+ *  - MDBX_BAD_VALSIZE - a key or data has a wrong size.
+ *  - MDBX_EINVAL    - an invalid parameter was specified. */
+LIBMDBX_API int mdbx_put_batch(MDBX_txn *txn, MDBX_dbi dbi,
+                               const MDBX_val *keys, size_t count,
+                               MDBX_val *data, unsigned flags);
+
+/* A callback function for mdbx_bulk_load(), which provides the next
+ * key/data pair of a sorted stream.
+ *
+ * The pair must stay valid until the next call of the function.
+ *
+ * Returns 0 with the next pair, MDBX_NOTFOUND at the end of the stream,
+ * otherwise an error which is returned by mdbx_bulk_load(). */
+typedef int MDBX_bulk_func(void *context, MDBX_val *key, MDBX_val *data);
+
+/* Bulk load of an empty database from a sorted stream of key/data pairs.
+ *
+ * The B-tree is built bottom-up: leaf pages are filled sequentially up to
+ * the given fill factor, the branch pages above them are built along the
+ * way, and the new root is set into the database record within the given
+ * transaction. So no page is ever split or copied, unlike with mdbx_put().
+ *
+ * The keys must be strictly ascending according to the database's key
+ * comparison function. On the first pair which is not, the function stops
+ * with MDBX_EKEYMISMATCH, while the database contains a valid tree of all
+ * preceding pairs. The offending pair is not stored, so the caller could
+ * store it and the rest of the stream with mdbx_put().
+ *
+ * The database must be empty and must not be MDBX_DUPSORT.
+ *
+ * [in] txn           A transaction handle returned by mdbx_txn_begin()
+ * [in] dbi           A database handle returned by mdbx_dbi_open()
+ * [in] next          The callback providing the sorted pairs
+ * [in] context       An arbitrary context pointer for the callback.
+ * [in] fill_percent  The fill factor of pages from 1 to 100 percents,
+ *                    or 0 for fully packed pages.
+ *
+ * Returns A non-zero error value on failure and 0 on success, some
+ * possible errors are:
+ *  - MDBX_EKEYMISMATCH  - the stream isn't sorted, see above.
+ *  - MDBX_INCOMPATIBLE  - the database is MDBX_DUPSORT.
+ *  - MDBX_MAP_FULL      - the database is full, see mdbx_env_set_mapsize().
+ *  - MDBX_EACCES        - an attempt was made to write in a read-only
+ *                         transaction.
+ *  - MDBX_EINVAL        - an invalid parameter was specified,
+ *                         or the database is not empty. */
+LIBMDBX_API int mdbx_bulk_load(MDBX_txn *txn, MDBX_dbi dbi,
+                               MDBX_bulk_func *next, void *context,
+                               unsigned fill_percent);
+
 /* Delete items from a database.
  *
  * This function removes key/data pairs from the database.
@@ -1304,6 +1718,38 @@ LIBMDBX_API int mdbx_put(MDBX_txn *txn, MDBX_dbi dbi, MDBX_val *key,
 LIBMDBX_API int mdbx_del(MDBX_txn *txn, MDBX_dbi dbi, MDBX_val *key,
                          MDBX_val *data);
 
+/* Delete a range of keys from a database.
+ *
+ * This function removes all key/data pairs with keys in the half-open
+ * range [begin, end), including all duplicates of these keys for databases
+ * with MDBX_DUPSORT flag. A NULL begin or end means the range is unbounded
+ * on the corresponding side.
+ *
+ * Unlike a loop of mdbx_cursor_del() calls, the subtrees which are fully
+ * covered by the range are detached at the branch level and their pages
+ * are freed as a whole, so only the leaf pages at the edges of the range
+ * are copied and rebalanced. The leaves of detached subtrees are just read
+ * for the items accounting, and also for releasing of overflow pages and
+ * nested sub-databases if the database could contain any.
+ *
+ * All cursors of the database within the transaction are invalidated and
+ * must be re-positioned before further use.
+ *
+ * [in] txn    A transaction handle returned by mdbx_txn_begin()
+ * [in] dbi    A database handle returned by mdbx_dbi_open()
+ * [in] begin  The first key of the range, or NULL.
+ * [in] end    The key following the last key of the range, or NULL.
+ *
+ * Returns A non-zero error value on failure and 0 on success, some
+ * possible errors are:
+ *  - MDBX_EACCES       - an attempt was made to write in a read-only
+ *                        transaction.
+ *  - MDBX_INCOMPATIBLE - the range covers a record of a named database
+ *                        within the main database.
+ *  - MDBX_EINVAL       - an invalid parameter was specified. */
+LIBMDBX_API int mdbx_del_range(MDBX_txn *txn, MDBX_dbi dbi,
+                               const MDBX_val *begin, const MDBX_val *end);
+
 /* Create a cursor handle.
  *
  * A cursor is associated with a specific transaction and database.
@@ -1380,6 +1826,83 @@ LIBMDBX_API MDBX_dbi mdbx_cursor_dbi(MDBX_cursor *cursor);
 LIBMDBX_API int mdbx_cursor_get(MDBX_cursor *cursor, MDBX_val *key,
                                 MDBX_val *data, MDBX_cursor_op op);
 
+/* Retrieve multiple key/data pairs by cursor.
+ *
+ * This function retrieves up to the given number of consecutive key/data
+ * pairs, but no further than the end of the leaf page holding the first of
+ * them, so a database is scanned by a page per call. The cursor is positioned
+ * at the last retrieved item, so the next call with MDBX_NEXT continues the
+ * scan. See mdbx_get() for restrictions on using the output values.
+ *
+ * This call is only valid on databases without sorted duplicates, i.e.
+ * which are not opened with MDBX_DUPSORT.
+ *
+ * [in] cursor    A cursor handle returned by mdbx_cursor_open()
+ * [out] count    Address where the number of retrieved pairs will be stored
+ * [out] pairs    The array of (2 * limit) items, to which the keys and data
+ *                are stored one after another, i.e. pairs[2*i] is a key and
+ *                pairs[2*i+1] is its data
+ * [in] limit     The maximum number of pairs to retrieve
+ * [in] op        A cursor operation for the first pair, which must be one
+ *                of MDBX_FIRST, MDBX_NEXT or MDBX_GET_CURRENT.
+ *
+ * Returns A non-zero error value on failure and 0 on success, some
+ * possible errors are:
+ *  - MDBX_NOTFOUND     - no more items, the count is zero.
+ *  - MDBX_INCOMPATIBLE - the database was opened with MDBX_DUPSORT.
+ *  - MDBX_EINVAL       - an invalid parameter was specified. */
+LIBMDBX_API int mdbx_cursor_get_batch(MDBX_cursor *cursor, size_t *count,
+                                      MDBX_val *pairs, size_t limit,
+                                      MDBX_cursor_op op);
+
+/* A callback function used to visit items by mdbx_cursor_scan().
+ *
+ * The key and data point directly into the memory map, with the same
+ * restrictions as the values returned by mdbx_get().
+ *
+ * Returns MDBX_RESULT_FALSE (i.e. 0) to continue the scan, MDBX_RESULT_TRUE
+ * to stop it, or any other value which stops the scan and is returned from
+ * mdbx_cursor_scan() as is. */
+typedef int(MDBX_scan_func)(void *ctx, const MDBX_val *key,
+                            const MDBX_val *data);
+
+/* Scan a range of items by cursor.
+ *
+ * This function calls the given callback for every key/data pair with keys
+ * in the half-open range [from, to), where a NULL from or to means the range
+ * is unbounded on the corresponding side. For MDBX_DUPSORT databases all
+ * duplicates of each key are visited in their order.
+ *
+ * Unlike a loop of mdbx_cursor_get() calls, the items are read directly from
+ * the leaf pages, and the cursor is moved only between the pages. The bounds
+ * are compared only within the leaves they fall into.
+ *
+ * If the callback stops the scan, the cursor is positioned at the item
+ * passed to it. Otherwise, the cursor is positioned at the first item beyond
+ * the range in the direction of the scan, or at the last visited item if
+ * there is no such one.
+ *
+ * [in] cursor  A cursor handle returned by mdbx_cursor_open()
+ * [in] from    The first key of the range, or NULL.
+ * [in] to      The key following the last key of the range, or NULL.
+ * [in] func    The callback function to be called for every item.
+ * [in] ctx     An arbitrary context pointer for the callback.
+ * [in] flags   Options for this operation. This parameter must be set to 0
+ *              or to the value described here:
+ *
+ *  - MDBX_SCAN_REVERSE
+ *      Scan the range backward, i.e. from the last item to the first one.
+ *
+ * Returns MDBX_RESULT_TRUE if the scan was stopped by the callback,
+ * MDBX_RESULT_FALSE (i.e. 0) if the whole range was scanned, or a non-zero
+ * error value on failure (including one returned by the callback), some
+ * possible errors are:
+ *  - MDBX_EINVAL  - an invalid parameter was specified. */
+#define MDBX_SCAN_REVERSE 1u
+LIBMDBX_API int mdbx_cursor_scan(MDBX_cursor *cursor, const MDBX_val *from,
+                                 const MDBX_val *to, MDBX_scan_func *func,
+                                 void *ctx, unsigned flags);
+
 /* Store by cursor.
  *
  * This function stores key/data pairs into the database. The cursor is
@@ -1449,6 +1972,23 @@ LIBMDBX_API int mdbx_cursor_get(MDBX_cursor *cursor, MDBX_val *key,
 LIBMDBX_API int mdbx_cursor_put(MDBX_cursor *cursor, MDBX_val *key,
                                 MDBX_val *data, unsigned flags);
 
+/* Store arrays of items by cursor.
+ *
+ * The same as mdbx_put_batch(), but by the given cursor, which is positioned
+ * at the last stored item, or on failure usually near it.
+ *
+ * [in] cursor    A cursor handle returned by mdbx_cursor_open()
+ * [in] keys      The array of keys to store
+ * [in] count     The number of key/data pairs
+ * [in,out] data  The array of data to store, one per key
+ * [in] flags     Options for this operation, see mdbx_put_batch().
+ *
+ * Returns A non-zero error value on failure and 0 on success,
+ * see mdbx_put_batch() for possible errors. */
+LIBMDBX_API int mdbx_cursor_put_batch(MDBX_cursor *cursor,
+                                      const MDBX_val *keys, size_t count,
+                                      MDBX_val *data, unsigned flags);
+
 /* Delete current key/data pair
  *
  * This function deletes the key/data pair to which the cursor refers.
@@ -1481,6 +2021,43 @@ LIBMDBX_API int mdbx_cursor_del(MDBX_cursor *cursor, unsigned flags);
  *                    was specified. */
 LIBMDBX_API int mdbx_cursor_count(MDBX_cursor *cursor, size_t *countp);
 
+/* Position a cursor at the item of the given rank.
+ *
+ * The rank is the zero-based position of an item in the order of keys, and
+ * of the data items for MDBX_DUPSORT databases, i.e. the number of items
+ * before it. The lookup costs O(log N) by the counts of items within
+ * subtrees, so it is only valid for databases opened with MDBX_COUNTED.
+ *
+ * [in] cursor  A cursor handle returned by mdbx_cursor_open()
+ * [in] rank    The rank of the item, less than the number of items.
+ * [out] key    Address where the key of the item will be stored, may be NULL.
+ * [out] data   Address where the data of the item will be stored,
+ *              may be NULL.
+ *
+ * Returns A non-zero error value on failure and 0 on success, some
+ * possible errors are:
+ *  - MDBX_NOTFOUND      - the rank is not less than the number of items.
+ *  - MDBX_INCOMPATIBLE  - the database is not MDBX_COUNTED.
+ *  - MDBX_EINVAL        - an invalid parameter was specified. */
+LIBMDBX_API int mdbx_cursor_seek_rank(MDBX_cursor *cursor, uint64_t rank,
+                                      MDBX_val *key, MDBX_val *data);
+
+/* Return the rank of the item at the current cursor position.
+ *
+ * This is the reverse of mdbx_cursor_seek_rank(), which also costs
+ * O(log N) and is only valid for databases opened with MDBX_COUNTED.
+ *
+ * [in] cursor  A cursor handle returned by mdbx_cursor_open()
+ * [out] rank   Address where the rank will be stored.
+ *
+ * Returns A non-zero error value on failure and 0 on success, some
+ * possible errors are:
+ *  - MDBX_NOTFOUND      - the cursor is past the last item.
+ *  - MDBX_INCOMPATIBLE  - the database is not MDBX_COUNTED.
+ *  - MDBX_EINVAL        - cursor is not initialized, or an invalid parameter
+ *                         was specified. */
+LIBMDBX_API int mdbx_cursor_get_rank(MDBX_cursor *cursor, uint64_t *rank);
+
 /* Compare two data items according to a particular database.
  *
  * This returns a comparison as if the two data items were keys in the
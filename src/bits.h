@@ -108,6 +108,9 @@
 
 /* The version number for a database's datafile format. */
 #define MDBX_DATA_VERSION ((MDBX_DEVEL) ? 255 : 2)
+/* The version number for a datafile with features of mm_extra_flags,
+ * which former versions refuse to open. */
+#define MDBX_DATA_VERSION_EXTRA ((MDBX_DEVEL) ? 254 : 3)
 /* The version number for a database's lockfile format. */
 #define MDBX_LOCK_VERSION ((MDBX_DEVEL) ? 255 : 2)
 
@@ -232,7 +235,10 @@ typedef struct MDBX_db {
   pgno_t md_overflow_pages; /* number of overflow pages */
   uint64_t md_seq;          /* table sequence counter */
   uint64_t md_entries;      /* number of data items */
-  uint64_t md_merkle;       /* Merkle tree checksum */
+  uint8_t md_split;         /* page split policy, see MDBX_SPLIT_* */
+  uint8_t md_merge;         /* merge threshold in percents, zero for default */
+  uint16_t md_reserved16;   /* zero, reserved for future use */
+  uint32_t md_reserved32;   /* zero, reserved for future use */
 } MDBX_db;
 
 /* Meta page content.
@@ -246,7 +252,7 @@ typedef struct MDBX_meta {
   /* txnid that committed this page, the first of a two-phase-update pair */
   volatile txnid_t mm_txnid_a;
 
-  uint16_t mm_extra_flags;  /* extra DB flags, zero (nothing) for now */
+  uint16_t mm_extra_flags;  /* features of the format, see MDBX_META_* */
   uint8_t mm_validator_id;  /* ID of checksum and page validation method,
                              * zero (nothing) for now */
   uint8_t mm_extra_pagehdr; /* extra bytes in the page header,
@@ -287,6 +293,11 @@ typedef struct MDBX_meta {
  * sorted mp_ptrs[] entries referring to them. Exception: P_LEAF2 pages
  * omit mp_ptrs and pack sorted MDBX_DUPFIXED values after the page header.
  *
+ * P_FPRINT pages of MDBX_FPRINT databases pair each entry of mp_ptrs[] with
+ * a fingerprint of the node's key, i.e. two bytes of the key which follow
+ * the prefix common for all keys of the page. The length of that prefix is
+ * kept in the first pair, ahead of the entries.
+ *
  * P_OVERFLOW records occupy one or more contiguous pages where only the
  * first has a page header. They hold the real data of F_BIGDATA nodes.
  *
@@ -306,6 +317,9 @@ typedef struct MDBX_page {
                                 * which the page has been updated */
   };
   uint16_t mp_leaf2_ksize; /* key size if this is a LEAF2 page */
+/* The last insertion point plus one within a leaf-page (except LEAF2) of
+ * a MDBX_SPLIT_ADAPTIVE database, or zero if unknown */
+#define mp_last_insert mp_leaf2_ksize
 #define P_BRANCH 0x01      /* branch page */
 #define P_LEAF 0x02        /* leaf page */
 #define P_OVERFLOW 0x04    /* overflow page */
@@ -313,6 +327,7 @@ typedef struct MDBX_page {
 #define P_DIRTY 0x10       /* dirty page, also set for P_SUBP pages */
 #define P_LEAF2 0x20       /* for MDBX_DUPFIXED records */
 #define P_SUBP 0x40        /* for MDBX_DUPSORT sub-pages */
+#define P_FPRINT 0x80      /* with key fingerprints, see MDBX_FPRINT */
 #define P_LOOSE 0x4000     /* page was dirtied then freed, can be reused */
 #define P_KEEP 0x8000      /* leave this page alone during spill */
   uint16_t mp_flags;
@@ -429,6 +444,14 @@ typedef struct MDBX_lockinfo {
    (uint16_t)(MDBX_LOCKINFO_WHOLE_SIZE + MDBX_CACHELINE_SIZE - 1))
 
 #define MDBX_DATA_MAGIC ((MDBX_MAGIC << 8) + MDBX_DATA_VERSION)
+#define MDBX_DATA_MAGIC_EXTRA ((MDBX_MAGIC << 8) + MDBX_DATA_VERSION_EXTRA)
+
+/* Features of mm_extra_flags, which change the format of pages. Once a table
+ * using such a feature is committed, the feature stays in the meta and the
+ * datafile is stamped with MDBX_DATA_VERSION_EXTRA. */
+#define MDBX_META_FPRINT 0x0001  /* pages with key fingerprints, P_FPRINT */
+#define MDBX_META_COUNTED 0x0002 /* branch nodes with counts, MDBX_COUNTED */
+#define MDBX_META_FEATURES (MDBX_META_FPRINT | MDBX_META_COUNTED)
 
 #define MDBX_LOCK_MAGIC ((MDBX_MAGIC << 8) + MDBX_LOCK_VERSION)
 
@@ -465,6 +488,26 @@ typedef struct MDBX_ID2 {
  * unused. The array is sorted in ascending order by mid. */
 typedef MDBX_ID2 *MDBX_ID2L;
 
+/* A dirty page list (DPL) is an ID2L of the dirty pages with a header,
+ * which is placed just before the list like the allocated length of PNL.
+ * The pages are appended in the order they became dirty, therefore only
+ * the first `sorted` items are sorted by pgno. The rest (the tail) are
+ * indexed by a hash for lookups, unless MDBX_WRITEMAP where the lookups
+ * are not needed. The tail is merged into the sorted part lazily, once
+ * the list should be traversed in order. */
+typedef struct MDBX_DPL_header {
+  unsigned sorted;    /* number of items sorted by pgno */
+  unsigned allocated; /* max number of items */
+  unsigned hash_bits; /* log2 of the hash size, zero if not indexed */
+  unsigned *hash;     /* open addressing of tail items, zero is vacant */
+} MDBX_DPL_header;
+
+#define MDBX_DPL_HEADER(dl) ((MDBX_DPL_header *)(dl)-1)
+#define MDBX_DPL_SORTED(dl) (MDBX_DPL_HEADER(dl)->sorted)
+#define MDBX_DPL_ALLOCLEN(dl) (MDBX_DPL_HEADER(dl)->allocated)
+/* Initial and minimal size of a DPL */
+#define MDBX_DPL_INITIAL 1024
+
 /* PNL sizes - likely should be even bigger
  * limiting factors: sizeof(pgno_t), thread stack size */
 #define MDBX_PNL_LOGN 16 /* DB_SIZE is 2^16, UM_SIZE is 2^17 */
@@ -480,6 +523,44 @@ typedef MDBX_ID2 *MDBX_ID2L;
 #define MDBX_PNL_FIRST(pl) ((pl)[1])
 #define MDBX_PNL_LAST(pl) ((pl)[(pl)[0]])
 
+/* PNLs of this length and longer are sorted by radix sort, which needs
+ * a temporary buffer of the same size */
+#ifndef MDBX_PNL_RADIXSORT_THRESHOLD
+#define MDBX_PNL_RADIXSORT_THRESHOLD 256
+#endif
+
+/* PNLs are merged by SIMD kernels (see MDBX_SEARCH_SIMD below) only if both
+ * lists are at least of this length */
+#ifndef MDBX_PNL_SIMD_THRESHOLD
+#define MDBX_PNL_SIMD_THRESHOLD 64
+#endif
+
+/* Enables SIMD kernels for searching within sorted arrays of integers,
+ * i.e. LEAF2-pages of MDBX_INTEGERDUP and PNLs. On x86 these are selected
+ * at runtime by CPUID, on AArch64 NEON is always available. */
+#ifndef MDBX_SEARCH_SIMD
+#define MDBX_SEARCH_SIMD 1
+#endif /* MDBX_SEARCH_SIMD */
+
+/* Number of keys which are compared at once by SIMD search kernels */
+#define MDBX_SEARCH_BLOCK 8
+
+#if MDBX_SEARCH_SIMD && (defined(__x86_64__) || defined(__i386__)) &&          \
+    (__GNUC_PREREQ(4, 9) || defined(__clang__))
+#define MDBX_SEARCH_X86 1
+#define MDBX_TARGET_SSE41 __attribute__((target("sse4.1,popcnt")))
+#define MDBX_TARGET_SSE42 __attribute__((target("sse4.2,popcnt")))
+#define MDBX_TARGET_AVX2 __attribute__((target("avx2,popcnt")))
+#else
+#define MDBX_SEARCH_X86 0
+#endif
+
+#if MDBX_SEARCH_SIMD && defined(__aarch64__) && defined(__ARM_NEON)
+#define MDBX_SEARCH_NEON 1
+#else
+#define MDBX_SEARCH_NEON 0
+#endif
+
 /* Current max length of an mdbx_pnl_alloc()ed PNL */
 #define MDBX_PNL_ALLOCLEN(pl) ((pl)[-1])
 
@@ -493,8 +574,19 @@ typedef struct MDBX_dbx {
   MDBX_val md_name;       /* name of the database */
   MDBX_cmp_func *md_cmp;  /* function for comparing keys */
   MDBX_cmp_func *md_dcmp; /* function for comparing data items */
+  uint8_t md_kind;        /* kind of md_cmp, see MDBX_CMP_* */
+  uint8_t md_dkind;       /* kind of md_dcmp, see MDBX_CMP_* */
 } MDBX_dbx;
 
+/* Kinds of comparators, for which mdbx_node_search() and others are
+ * specialized to avoid the indirect call per comparison. */
+enum {
+  MDBX_CMP_CUSTOM /* user-provided or unknown, called by pointer */,
+  MDBX_CMP_MEMN /* mdbx_cmp_memn */,
+  MDBX_CMP_MEMNR /* mdbx_cmp_memnr */,
+  MDBX_CMP_INT /* mdbx_cmp_int_ai, mdbx_cmp_int_a2, mdbx_cmp_int_ua */
+};
+
 /* A database transaction.
  * Every operation requires a transaction handle. */
 struct MDBX_txn {
@@ -524,7 +616,7 @@ struct MDBX_txn {
    * shifted left by 1, deleted slots have the LSB set. */
   MDBX_PNL mt_spill_pages;
   union {
-    /* For write txns: Modified pages. Sorted when not MDBX_WRITEMAP. */
+    /* For write txns: Modified pages, see MDBX_DPL_header. */
     MDBX_ID2L mt_rw_dirtylist;
     /* For read txns: This thread/txn's reader table slot, or NULL. */
     MDBX_reader *mt_ro_reader;
@@ -712,8 +804,15 @@ struct MDBX_env {
   MDBX_page *me_dpages; /* list of malloc'd blocks for re-use */
                         /* PNL of pages that became unused in a write txn */
   MDBX_PNL me_free_pgs;
-  /* ID2L of pages written during a write txn. Length MDBX_PNL_UM_SIZE. */
+  /* DPL of pages written during a write txn, grows on demand. */
   MDBX_ID2L me_dirtylist;
+  /* Max number of dirty pages within a write txn before spilling. */
+  size_t me_maxdirty;
+#if MDBX_USE_IOURING
+  mdbx_ioring_t *me_ioring;    /* batched writes, NULL if unavailable */
+  struct iovec *me_ioring_iov; /* iovecs of all runs to be written */
+  size_t me_ioring_iov_size;   /* allocated length of me_ioring_iov */
+#endif
   /* Max number of freelist items that can fit in a single overflow page */
   unsigned me_maxfree_1pg;
   /* Max size of a node on a page */
@@ -724,6 +823,26 @@ struct MDBX_env {
   size_t me_sync_pending;     /* Total dirty/non-sync'ed bytes
                                * since the last mdbx_env_sync() */
   size_t me_sync_threshold;   /* Treshold of above to force synchronous flush */
+  /* Range of the written pages, which is pending for MDBX_WRITEBACK */
+  size_t me_writeback_begin, me_writeback_end;
+  size_t me_writeback_pending; /* Bytes written within the above range */
+  /* Background syncer for mdbx_txn_commit_async(), started on demand.
+   * The condmutexes must be 8-byte aligned within the packed struct,
+   * this is checked by mdbx_env_create(). */
+  mdbx_thread_t me_syncer;
+  mdbx_condmutex_t me_syncer_cond;  /* wakes the syncer */
+  mdbx_condmutex_t me_durable_cond; /* wakes mdbx_env_wait_durable() */
+  /* Guarded by me_syncer_cond */
+  txnid_t me_syncer_wanna; /* highest txnid requested to be durable */
+  /* Range to start the writeback of, empty if end is zero */
+  size_t me_syncer_wb_begin, me_syncer_wb_end;
+  bool me_syncer_running;
+  bool me_syncer_stop;
+  /* Guarded by me_durable_cond */
+  unsigned me_durable_waiters; /* number of threads blocked on it */
+  unsigned me_durable_serial;  /* count of syncs done by the syncer */
+  int me_durable_rc;           /* result of the last background sync */
+  mdbx_filehandle_t me_dfd;    /* O_DIRECT data file for MDBX_DIRECTWRITE */
   MDBX_oom_func *me_oom_func; /* Callback for kicking laggard readers */
   txnid_t me_oldest_stub;
 #if MDBX_DEBUG
@@ -973,8 +1092,33 @@ static __inline unsigned mdbx_log2(size_t value) {
 /* Address of first usable data byte in a page, after the header */
 #define PAGEDATA(p) ((void *)((char *)(p) + PAGEHDRSZ))
 
+/* The log2 of the number of indx_t per an entry of mp_ptrs[] */
+#define PAGESLOTSHIFT(p) (((p)->mp_flags & P_FPRINT) ? 1u : 0u)
+
+/* The size of an entry of mp_ptrs[] */
+#define PAGESLOTSZ(p) ((unsigned)sizeof(indx_t) << PAGESLOTSHIFT(p))
+
+/* The mp_lower of an empty page */
+#define PAGELOWER0(p) (PAGESLOTSHIFT(p) * 2u * (unsigned)sizeof(indx_t))
+
+/* The items of mp_ptrs[], being addressed without the bounds of the array
+ * which compilers may assume for the index */
+#define PAGEINDX(p, n) (((indx_t *)PAGEDATA(p))[n])
+
+/* The offset of node i within mp_ptrs[] */
+#define PAGEPTR(p, i)                                                          \
+  PAGEINDX(p, ((i) + PAGESLOTSHIFT(p)) << PAGESLOTSHIFT(p))
+
+/* The fingerprint of the key of node i on a P_FPRINT page */
+#define PAGEFPRINT(p, i) PAGEINDX(p, ((i) << 1) + 3)
+
+/* The length of the key prefix common for a P_FPRINT page, which is
+ * followed by a reserved zero */
+#define PAGEPREFIX(p) PAGEINDX(p, 0)
+
 /* Number of nodes on a page */
-#define NUMKEYS(p) ((unsigned)(p)->mp_lower >> 1)
+#define NUMKEYS(p)                                                             \
+  (((unsigned)(p)->mp_lower >> (1 + PAGESLOTSHIFT(p))) - PAGESLOTSHIFT(p))
 
 /* The amount of space remaining in the page */
 #define SIZELEFT(p) (indx_t)((p)->mp_upper - (p)->mp_lower)
@@ -997,6 +1141,8 @@ static __inline unsigned mdbx_log2(size_t value) {
 #define IS_OVERFLOW(p) unlikely(F_ISSET((p)->mp_flags, P_OVERFLOW))
 /* Test if a page is a sub page */
 #define IS_SUBP(p) F_ISSET((p)->mp_flags, P_SUBP)
+/* Test if a page has key fingerprints */
+#define IS_FPRINT(p) F_ISSET((p)->mp_flags, P_FPRINT)
 
 /* The number of overflow pages needed to store the given size. */
 #define OVPAGES(env, size) (bytes2pgno(env, PAGEHDRSZ - 1 + (size)) + 1)
@@ -1071,7 +1217,7 @@ typedef struct MDBX_node {
 /* Address of node i in page p */
 static __inline MDBX_node *NODEPTR(MDBX_page *p, unsigned i) {
   assert(NUMKEYS(p) > (unsigned)(i));
-  return (MDBX_node *)((char *)(p) + (p)->mp_ptrs[i] + PAGEHDRSZ);
+  return (MDBX_node *)((char *)(p) + PAGEPTR(p, i) + PAGEHDRSZ);
 }
 
 /* Address of the key for the node */
@@ -1136,6 +1282,23 @@ static __inline void SETDSZ(MDBX_node *node, size_t size) {
 /* The size of a key in a node */
 #define NODEKSZ(node) ((node)->mn_ksize)
 
+/* Size of the count of items within the subtree, which follows the key
+ * of a branch node in MDBX_COUNTED databases */
+#define NODECOUNTSZ(db)                                                        \
+  (((db)->md_flags & MDBX_COUNTED) ? sizeof(uint64_t) : 0)
+
+/* Get the count of items within the subtree of a branch node */
+static __inline uint64_t NODECOUNT(MDBX_node *node) {
+  uint64_t count;
+  memcpy(&count, NODEDATA(node), sizeof(count));
+  return count;
+}
+
+/* Set the count of items within the subtree of a branch node */
+static __inline void SETCOUNT(MDBX_node *node, uint64_t count) {
+  memcpy(NODEDATA(node), &count, sizeof(count));
+}
+
 /* The address of a key in a LEAF2 page.
  * LEAF2 pages are used for MDBX_DUPFIXED sorted-duplicate sub-DBs.
  * There are no node headers, keys are stored contiguously. */
@@ -1162,7 +1325,8 @@ static __inline void SETDSZ(MDBX_node *node, size_t size) {
 /* mdbx_dbi_open() flags */
 #define VALID_FLAGS                                                            \
   (MDBX_REVERSEKEY | MDBX_DUPSORT | MDBX_INTEGERKEY | MDBX_DUPFIXED |          \
-   MDBX_INTEGERDUP | MDBX_REVERSEDUP | MDBX_CREATE)
+   MDBX_INTEGERDUP | MDBX_REVERSEDUP | MDBX_COUNTED | MDBX_FPRINT |          \
+   MDBX_CREATE)
 
 /* max number of pages to commit in one writev() call */
 #define MDBX_COMMIT_PAGES 64
@@ -1171,6 +1335,10 @@ static __inline void SETDSZ(MDBX_node *node, size_t size) {
 #define MDBX_COMMIT_PAGES IOV_MAX
 #endif
 
+/* Amount of written data to start the MDBX_WRITEBACK, unless the sync
+ * threshold is set by mdbx_env_set_syncbytes() */
+#define MDBX_WRITEBACK_CHUNK (4u << 20)
+
 /* Check txn and dbi arguments to a function */
 #define TXN_DBI_EXIST(txn, dbi, validity)                                      \
   ((dbi) < (txn)->mt_numdbs && ((txn)->mt_dbflags[dbi] & (validity)))
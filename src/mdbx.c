@@ -211,9 +211,9 @@ static bool mdbx_pnl_check(MDBX_PNL pl) {
   return true;
 }
 
-/* Sort an PNL.
+/* Sort an PNL by quicksort.
  * [in,out] pnl The PNL to sort. */
-static void __hot mdbx_pnl_sort(MDBX_PNL pnl) {
+static void __hot mdbx_pnl_qsort(MDBX_PNL pnl) {
   /* Max possible depth of int-indexed tree * 2 items/level */
   int istack[sizeof(int) * CHAR_BIT * 2];
   int i, j, k, l, ir, jstack;
@@ -288,44 +288,371 @@ static void __hot mdbx_pnl_sort(MDBX_PNL pnl) {
   }
 #undef PNL_SMALL
 #undef PNL_SWAP
-  assert(mdbx_pnl_check(pnl));
 }
 
-/* Search for an ID in an PNL.
- * [in] pl The PNL to search.
- * [in] id The ID to search for.
- * Returns The index of the first ID greater than or equal to id. */
-static unsigned __hot mdbx_pnl_search(MDBX_PNL pnl, pgno_t id) {
-  assert(mdbx_pnl_check(pnl));
+/* Sort an PNL by LSD radix sort with 8-bit digits, skipping the digits
+ * which are the same for all items, e.g. the high bytes of pgno.
+ * [in,out] pnl The PNL to sort.
+ * Returns false if the temporary buffer can't be allocated. */
+static bool __hot mdbx_pnl_radixsort(MDBX_PNL pnl) {
+  const unsigned n = pnl[0];
+  pgno_t *src = pnl + 1, *dst = malloc(n * sizeof(pgno_t)), *const tmp = dst;
+  if (unlikely(!tmp))
+    return false;
 
-  /* binary search of id in pl
-   * if found, returns position of id
-   * if not found, returns first position greater than id */
-  unsigned base = 0;
-  unsigned cursor = 1;
-  int val = 0;
-  unsigned n = pnl[0];
+/* for the descending order the inverted pgno is sorted ascending */
+#if MDBX_PNL_ASCENDING
+#define PNL_RADIX_KEY(pgno) (pgno)
+#else
+#define PNL_RADIX_KEY(pgno) (~(pgno))
+#endif
 
-  while (n > 0) {
-    unsigned pivot = n >> 1;
-    cursor = base + pivot + 1;
-    val = MDBX_PNL_ASCENDING ? mdbx_cmp2int(pnl[cursor], id)
-                             : mdbx_cmp2int(id, pnl[cursor]);
+  unsigned hist[sizeof(pgno_t)][256];
+  memset(hist, 0, sizeof(hist));
+  for (unsigned i = 0; i < n; ++i) {
+    const pgno_t key = PNL_RADIX_KEY(src[i]);
+    for (unsigned d = 0; d < sizeof(pgno_t); ++d)
+      hist[d][(key >> (d * 8)) & 255] += 1;
+  }
 
-    if (val < 0) {
-      n = pivot;
-    } else if (val > 0) {
-      base = cursor;
-      n -= pivot + 1;
-    } else {
-      return cursor;
-    }
+  for (unsigned d = 0; d < sizeof(pgno_t); ++d) {
+    const unsigned shift = d * 8;
+    if (hist[d][(PNL_RADIX_KEY(src[0]) >> shift) & 255] == n)
+      continue;
+    unsigned offset = 0;
+    for (unsigned i = 0; i < 256; ++i) {
+      const unsigned count = hist[d][i];
+      hist[d][i] = offset;
+      offset += count;
+    }
+    for (unsigned i = 0; i < n; ++i)
+      dst[hist[d][(PNL_RADIX_KEY(src[i]) >> shift) & 255]++] = src[i];
+    pgno_t *const swap = src;
+    src = dst;
+    dst = swap;
+  }
+#undef PNL_RADIX_KEY
+
+  if (src != pnl + 1)
+    memcpy(pnl + 1, src, n * sizeof(pgno_t));
+  free(tmp);
+  return true;
+}
+
+/* Sort an PNL.
+ * [in,out] pnl The PNL to sort. */
+static void __hot mdbx_pnl_sort(MDBX_PNL pnl) {
+  if (pnl[0] < MDBX_PNL_RADIXSORT_THRESHOLD || !mdbx_pnl_radixsort(pnl))
+    mdbx_pnl_qsort(pnl);
+  assert(mdbx_pnl_check(pnl));
+}
+
+/*----------------------------------------------------------------------------*/
+/* kernels for the lower-bound search within a PNL and for the merge of
+ * PNLs. Both follow MDBX_PNL_ASCENDING, i.e. "earlier" below means an item
+ * which precedes in the PNL order, and are selected at runtime like the
+ * search kernels for LEAF2-pages (SSE4.1 or AVX2 on x86, NEON on AArch64,
+ * otherwise scalar). */
+
+typedef unsigned mdbx_pnl_search_func(const pgno_t *pnl, pgno_t id);
+typedef void mdbx_pnl_xmerge_func(pgno_t *pnl, const pgno_t *merge);
+
+/* Branchless binary search while more than a block remains, then the
+ * count of earlier items within the last block, which is shifted back to be
+ * entirely inside the PNL. See MDBX_SEARCH_FIXED below for the details. */
+#define MDBX_PNL_SEARCH(NAME, ATTRS, BLOCK_EARLIER)                            \
+  static unsigned ATTRS NAME(const pgno_t *pnl, pgno_t id) {                   \
+    const pgno_t *const begin = pnl + 1;                                       \
+    const unsigned total = pnl[0];                                             \
+    unsigned low = 0, n = total;                                               \
+    while (n > MDBX_SEARCH_BLOCK) {                                            \
+      const unsigned half = n >> 1;                                            \
+      low = MDBX_PNL_ORDERED(begin[low + half], id) ? low + half : low;        \
+      n -= half;                                                               \
+    }                                                                          \
+    if (unlikely(total < MDBX_SEARCH_BLOCK)) {                                 \
+      while (n && MDBX_PNL_ORDERED(begin[low], id)) {                          \
+        low += 1;                                                              \
+        n -= 1;                                                                \
+      }                                                                        \
+      return low + 1;                                                          \
+    }                                                                          \
+    if (low > total - MDBX_SEARCH_BLOCK)                                       \
+      low = total - MDBX_SEARCH_BLOCK;                                         \
+    return low + 1 + BLOCK_EARLIER(begin + low, id);                           \
+  }
+
+/* Merges from the tail, so the destination items are moved at most once
+ * and the delimiter in pnl[0] stops the scan of the destination. The carry
+ * is the sorted remainder from a SIMD kernel, which should be merged with
+ * both lists. */
+static void __hot mdbx_pnl_xmerge_tail(pgno_t *pnl, unsigned j,
+                                       const pgno_t *merge, unsigned i,
+                                       const pgno_t *carry, unsigned c) {
+  unsigned k = i + j + c;
+  pnl[0] = MDBX_PNL_ASCENDING ? 0 : ~(pgno_t)0;
+  pgno_t old_id = pnl[j];
+  while (c) {
+    pgno_t id = carry[c - 1];
+    if (i && MDBX_PNL_ORDERED(id, merge[i]))
+      id = merge[i--];
+    else
+      c--;
+    for (; MDBX_PNL_ORDERED(id, old_id); old_id = pnl[--j])
+      pnl[k--] = old_id;
+    pnl[k--] = id;
+  }
+  while (i) {
+    const pgno_t merge_id = merge[i--];
+    for (; MDBX_PNL_ORDERED(merge_id, old_id); old_id = pnl[--j])
+      pnl[k--] = old_id;
+    pnl[k--] = merge_id;
   }
+}
 
-  if (val > 0)
-    ++cursor;
+/* The SIMD merge keeps WIDTH earliest items of already taken ones in
+ * a register and repeatedly takes the next WIDTH items from the list which
+ * tail is later. The bitonic network then splits both vectors into earlier
+ * and later halves, the later one is stored into the destination.
+ * Both lists must be at least WIDTH long. */
+#define MDBX_PNL_XMERGE(NAME, ATTRS, VEC, WIDTH, LOAD, STORE, MERGE)           \
+  static void ATTRS NAME(pgno_t *pnl, const pgno_t *merge) {                   \
+    unsigned i = merge[0], j = pnl[0], k = i + j;                              \
+    VEC earlier, later;                                                        \
+    if (MDBX_PNL_ORDERED(merge[i], pnl[j])) {                                  \
+      earlier = LOAD(pnl + j - (WIDTH - 1));                                   \
+      j -= WIDTH;                                                              \
+    } else {                                                                   \
+      earlier = LOAD(merge + i - (WIDTH - 1));                                 \
+      i -= WIDTH;                                                              \
+    }                                                                          \
+    while (i >= WIDTH && j >= WIDTH) {                                         \
+      VEC next;                                                                \
+      if (MDBX_PNL_ORDERED(merge[i], pnl[j])) {                                \
+        next = LOAD(pnl + j - (WIDTH - 1));                                    \
+        j -= WIDTH;                                                            \
+      } else {                                                                 \
+        next = LOAD(merge + i - (WIDTH - 1));                                  \
+        i -= WIDTH;                                                            \
+      }                                                                        \
+      MERGE(earlier, next, &earlier, &later);                                  \
+      STORE(pnl + k - (WIDTH - 1), later);                                     \
+      k -= WIDTH;                                                              \
+    }                                                                          \
+    pgno_t carry[WIDTH];                                                       \
+    STORE(carry, earlier);                                                     \
+    mdbx_pnl_xmerge_tail(pnl, j, merge, i, carry, WIDTH);                      \
+  }
 
-  return cursor;
+static __inline unsigned mdbx_pnl_block_earlier_scalar(const pgno_t *block,
+                                                       pgno_t id) {
+  unsigned count = 0;
+  for (unsigned i = 0; i < MDBX_SEARCH_BLOCK; ++i)
+    count += MDBX_PNL_ORDERED(block[i], id);
+  return count;
+}
+
+MDBX_PNL_SEARCH(mdbx_pnl_search_scalar, __hot, mdbx_pnl_block_earlier_scalar)
+
+static void __hot mdbx_pnl_xmerge_scalar(pgno_t *pnl, const pgno_t *merge) {
+  mdbx_pnl_xmerge_tail(pnl, pnl[0], merge, merge[0], NULL, 0);
+}
+
+#if MDBX_SEARCH_X86
+/* SSE4.1 provides unsigned min/max for the merge network, but there are
+ * no unsigned comparisons, so items are biased by the sign bit for search. */
+#if MDBX_PNL_ASCENDING
+#define PNL_SSE_EARLIER(a, b) _mm_min_epu32(a, b)
+#define PNL_SSE_LATER(a, b) _mm_max_epu32(a, b)
+#define PNL_SSE_BEFORE(item, id) _mm_cmpgt_epi32(id, item)
+#define PNL_AVX_EARLIER(a, b) _mm256_min_epu32(a, b)
+#define PNL_AVX_LATER(a, b) _mm256_max_epu32(a, b)
+#define PNL_AVX_BEFORE(item, id) _mm256_cmpgt_epi32(id, item)
+#else
+#define PNL_SSE_EARLIER(a, b) _mm_max_epu32(a, b)
+#define PNL_SSE_LATER(a, b) _mm_min_epu32(a, b)
+#define PNL_SSE_BEFORE(item, id) _mm_cmpgt_epi32(item, id)
+#define PNL_AVX_EARLIER(a, b) _mm256_max_epu32(a, b)
+#define PNL_AVX_LATER(a, b) _mm256_min_epu32(a, b)
+#define PNL_AVX_BEFORE(item, id) _mm256_cmpgt_epi32(item, id)
+#endif
+
+static __inline MDBX_TARGET_SSE41 __m128i mdbx_pnl_load_sse41(const pgno_t *p) {
+  return _mm_loadu_si128((const __m128i *)p);
+}
+
+static __inline MDBX_TARGET_SSE41 void mdbx_pnl_store_sse41(pgno_t *p,
+                                                            __m128i v) {
+  _mm_storeu_si128((__m128i *)p, v);
+}
+
+static __inline MDBX_TARGET_SSE41 unsigned
+mdbx_pnl_block_earlier_sse41(const pgno_t *block, pgno_t id) {
+  const __m128i bias = _mm_set1_epi32(INT32_MIN);
+  const __m128i k = _mm_xor_si128(_mm_set1_epi32((int32_t)id), bias);
+  const __m128i a = _mm_xor_si128(mdbx_pnl_load_sse41(block), bias);
+  const __m128i b = _mm_xor_si128(mdbx_pnl_load_sse41(block + 4), bias);
+  const unsigned mask =
+      _mm_movemask_ps(_mm_castsi128_ps(PNL_SSE_BEFORE(a, k))) |
+      _mm_movemask_ps(_mm_castsi128_ps(PNL_SSE_BEFORE(b, k))) << 4;
+  return __builtin_popcount(mask);
+}
+
+/* Sorts a bitonic sequence of 4 items */
+static __inline MDBX_TARGET_SSE41 __m128i mdbx_pnl_bitonic_sse41(__m128i v) {
+  __m128i p = _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2));
+  v = _mm_blend_epi16(PNL_SSE_EARLIER(v, p), PNL_SSE_LATER(v, p), 0xF0);
+  p = _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1));
+  return _mm_blend_epi16(PNL_SSE_EARLIER(v, p), PNL_SSE_LATER(v, p), 0xCC);
+}
+
+static __inline MDBX_TARGET_SSE41 void
+mdbx_pnl_merge_sse41(__m128i a, __m128i b, __m128i *earlier, __m128i *later) {
+  b = _mm_shuffle_epi32(b, _MM_SHUFFLE(0, 1, 2, 3));
+  *earlier = mdbx_pnl_bitonic_sse41(PNL_SSE_EARLIER(a, b));
+  *later = mdbx_pnl_bitonic_sse41(PNL_SSE_LATER(a, b));
+}
+
+static __inline MDBX_TARGET_AVX2 __m256i mdbx_pnl_load_avx2(const pgno_t *p) {
+  return _mm256_loadu_si256((const __m256i *)p);
+}
+
+static __inline MDBX_TARGET_AVX2 void mdbx_pnl_store_avx2(pgno_t *p,
+                                                          __m256i v) {
+  _mm256_storeu_si256((__m256i *)p, v);
+}
+
+static __inline MDBX_TARGET_AVX2 unsigned
+mdbx_pnl_block_earlier_avx2(const pgno_t *block, pgno_t id) {
+  const __m256i bias = _mm256_set1_epi32(INT32_MIN);
+  const __m256i k = _mm256_xor_si256(_mm256_set1_epi32((int32_t)id), bias);
+  const __m256i v = _mm256_xor_si256(mdbx_pnl_load_avx2(block), bias);
+  return __builtin_popcount(
+      _mm256_movemask_ps(_mm256_castsi256_ps(PNL_AVX_BEFORE(v, k))));
+}
+
+/* Sorts a bitonic sequence of 8 items */
+static __inline MDBX_TARGET_AVX2 __m256i mdbx_pnl_bitonic_avx2(__m256i v) {
+  __m256i p = _mm256_permute2x128_si256(v, v, 0x01);
+  v = _mm256_blend_epi32(PNL_AVX_EARLIER(v, p), PNL_AVX_LATER(v, p), 0xF0);
+  p = _mm256_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2));
+  v = _mm256_blend_epi32(PNL_AVX_EARLIER(v, p), PNL_AVX_LATER(v, p), 0xCC);
+  p = _mm256_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1));
+  return _mm256_blend_epi32(PNL_AVX_EARLIER(v, p), PNL_AVX_LATER(v, p), 0xAA);
+}
+
+static __inline MDBX_TARGET_AVX2 void
+mdbx_pnl_merge_avx2(__m256i a, __m256i b, __m256i *earlier, __m256i *later) {
+  b = _mm256_permutevar8x32_epi32(b, _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+  *earlier = mdbx_pnl_bitonic_avx2(PNL_AVX_EARLIER(a, b));
+  *later = mdbx_pnl_bitonic_avx2(PNL_AVX_LATER(a, b));
+}
+
+MDBX_PNL_SEARCH(mdbx_pnl_search_sse41, __hot MDBX_TARGET_SSE41,
+                mdbx_pnl_block_earlier_sse41)
+MDBX_PNL_SEARCH(mdbx_pnl_search_avx2, __hot MDBX_TARGET_AVX2,
+                mdbx_pnl_block_earlier_avx2)
+MDBX_PNL_XMERGE(mdbx_pnl_xmerge_sse41, __hot MDBX_TARGET_SSE41, __m128i, 4,
+                mdbx_pnl_load_sse41, mdbx_pnl_store_sse41, mdbx_pnl_merge_sse41)
+MDBX_PNL_XMERGE(mdbx_pnl_xmerge_avx2, __hot MDBX_TARGET_AVX2, __m256i, 8,
+                mdbx_pnl_load_avx2, mdbx_pnl_store_avx2, mdbx_pnl_merge_avx2)
+#endif /* MDBX_SEARCH_X86 */
+
+#if MDBX_SEARCH_NEON
+#if MDBX_PNL_ASCENDING
+#define PNL_NEON_EARLIER(a, b) vminq_u32(a, b)
+#define PNL_NEON_LATER(a, b) vmaxq_u32(a, b)
+#define PNL_NEON_BEFORE(item, id) vcltq_u32(item, id)
+#else
+#define PNL_NEON_EARLIER(a, b) vmaxq_u32(a, b)
+#define PNL_NEON_LATER(a, b) vminq_u32(a, b)
+#define PNL_NEON_BEFORE(item, id) vcgtq_u32(item, id)
+#endif
+
+static __inline unsigned mdbx_pnl_block_earlier_neon(const pgno_t *block,
+                                                     pgno_t id) {
+  const uint32x4_t k = vdupq_n_u32(id);
+  const uint32x4_t a = PNL_NEON_BEFORE(vld1q_u32(block), k);
+  const uint32x4_t b = PNL_NEON_BEFORE(vld1q_u32(block + 4), k);
+  /* each matched lane is all-ones, i.e. -1 */
+  return 0u - vaddvq_u32(vaddq_u32(a, b));
+}
+
+/* Sorts a bitonic sequence of 4 items */
+static __inline uint32x4_t mdbx_pnl_bitonic_neon(uint32x4_t v) {
+  static const uint32_t upper[4] = {0, 0, ~0u, ~0u};
+  static const uint32_t odd[4] = {0, ~0u, 0, ~0u};
+  uint32x4_t p = vextq_u32(v, v, 2);
+  v = vbslq_u32(vld1q_u32(upper), PNL_NEON_LATER(v, p),
+                PNL_NEON_EARLIER(v, p));
+  p = vrev64q_u32(v);
+  return vbslq_u32(vld1q_u32(odd), PNL_NEON_LATER(v, p),
+                   PNL_NEON_EARLIER(v, p));
+}
+
+static __inline void mdbx_pnl_merge_neon(uint32x4_t a, uint32x4_t b,
+                                         uint32x4_t *earlier,
+                                         uint32x4_t *later) {
+  b = vrev64q_u32(b);
+  b = vextq_u32(b, b, 2);
+  *earlier = mdbx_pnl_bitonic_neon(PNL_NEON_EARLIER(a, b));
+  *later = mdbx_pnl_bitonic_neon(PNL_NEON_LATER(a, b));
+}
+
+MDBX_PNL_SEARCH(mdbx_pnl_search_neon, __hot, mdbx_pnl_block_earlier_neon)
+MDBX_PNL_XMERGE(mdbx_pnl_xmerge_neon, __hot, uint32x4_t, 4, vld1q_u32,
+                vst1q_u32, mdbx_pnl_merge_neon)
+#endif /* MDBX_SEARCH_NEON */
+
+static unsigned mdbx_pnl_search_resolve(const pgno_t *pnl, pgno_t id);
+static void mdbx_pnl_xmerge_resolve(pgno_t *pnl, const pgno_t *merge);
+
+/* resolved on first use, the race is harmless
+ * since any thread stores the same values. */
+static mdbx_pnl_search_func *mdbx_pnl_search_kernel = mdbx_pnl_search_resolve;
+static mdbx_pnl_xmerge_func *mdbx_pnl_xmerge_kernel = mdbx_pnl_xmerge_resolve;
+
+static void __cold mdbx_pnl_kernels_setup(void) {
+  mdbx_pnl_search_func *search = mdbx_pnl_search_scalar;
+  mdbx_pnl_xmerge_func *xmerge = mdbx_pnl_xmerge_scalar;
+#if MDBX_SEARCH_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("popcnt")) {
+    if (__builtin_cpu_supports("avx2")) {
+      search = mdbx_pnl_search_avx2;
+      xmerge = mdbx_pnl_xmerge_avx2;
+    } else if (__builtin_cpu_supports("sse4.1")) {
+      search = mdbx_pnl_search_sse41;
+      xmerge = mdbx_pnl_xmerge_sse41;
+    }
+  }
+#elif MDBX_SEARCH_NEON
+  search = mdbx_pnl_search_neon;
+  xmerge = mdbx_pnl_xmerge_neon;
+#endif
+  mdbx_pnl_search_kernel = search;
+  mdbx_pnl_xmerge_kernel = xmerge;
+}
+
+static unsigned __cold mdbx_pnl_search_resolve(const pgno_t *pnl, pgno_t id) {
+  mdbx_pnl_kernels_setup();
+  return mdbx_pnl_search_kernel(pnl, id);
+}
+
+static void __cold mdbx_pnl_xmerge_resolve(pgno_t *pnl, const pgno_t *merge) {
+  mdbx_pnl_kernels_setup();
+  mdbx_pnl_xmerge_kernel(pnl, merge);
+}
+
+/* Search for an ID in an PNL.
+ * [in] pl The PNL to search.
+ * [in] id The ID to search for.
+ * Returns The index of the first ID which is not earlier than id in the PNL
+ * order, i.e. the position of id if found, otherwise the position where id
+ * should be inserted. */
+static unsigned __hot mdbx_pnl_search(MDBX_PNL pnl, pgno_t id) {
+  assert(mdbx_pnl_check(pnl));
+  return mdbx_pnl_search_kernel(pnl, id);
 }
 
 /* Shrink an PNL.
@@ -472,16 +799,12 @@ static int mdbx_pnl_append_range(MDBX_PNL *ppl, pgno_t id, size_t n) {
 static void __hot mdbx_pnl_xmerge(MDBX_PNL pnl, MDBX_PNL merge) {
   assert(mdbx_pnl_check(pnl));
   assert(mdbx_pnl_check(merge));
-  pgno_t old_id, merge_id, i = merge[0], j = pnl[0], k = i + j, total = k;
-  pnl[0] =
-      MDBX_PNL_ASCENDING ? 0 : ~(pgno_t)0; /* delimiter for pl scan below */
-  old_id = pnl[j];
-  while (i) {
-    merge_id = merge[i--];
-    for (; MDBX_PNL_ORDERED(merge_id, old_id); old_id = pnl[--j])
-      pnl[k--] = old_id;
-    pnl[k--] = merge_id;
-  }
+  STATIC_ASSERT(MDBX_PNL_SIMD_THRESHOLD >= MDBX_SEARCH_BLOCK);
+  const pgno_t total = pnl[0] + merge[0];
+  if (merge[0] < MDBX_PNL_SIMD_THRESHOLD || pnl[0] < MDBX_PNL_SIMD_THRESHOLD)
+    mdbx_pnl_xmerge_scalar(pnl, merge);
+  else
+    mdbx_pnl_xmerge_kernel(pnl, merge);
   pnl[0] = total;
   assert(mdbx_pnl_check(pnl));
 }
@@ -528,51 +851,341 @@ static unsigned __hot mdbx_mid2l_search(MDBX_ID2L pnl, pgno_t id) {
   return cursor;
 }
 
-/* Insert an ID2 into a ID2L.
- * [in,out] pnl The ID2L to insert into.
- * [in] id The ID2 to insert.
- * Returns 0 on success, -1 if the ID was already present in the ID2L. */
-static int mdbx_mid2l_insert(MDBX_ID2L pnl, MDBX_ID2 *id) {
-  unsigned x = mdbx_mid2l_search(pnl, id->mid);
-  if (unlikely(x < 1))
-    return /* internal error */ -2;
+/* Allocate a DPL for the given number of items.
+ * Returns DPL on success, NULL on failure. */
+static MDBX_ID2L mdbx_dpl_alloc(size_t size) {
+  MDBX_DPL_header *hdr =
+      malloc(sizeof(MDBX_DPL_header) + (size + 1) * sizeof(MDBX_ID2));
+  if (unlikely(!hdr))
+    return NULL;
+  hdr->sorted = 0;
+  hdr->allocated = (unsigned)size;
+  hdr->hash_bits = 0;
+  hdr->hash = NULL;
+  MDBX_ID2L dl = (MDBX_ID2L)(hdr + 1);
+  dl[0].mid = 0;
+  return dl;
+}
+
+static void mdbx_dpl_free(MDBX_ID2L dl) {
+  if (likely(dl)) {
+    free(MDBX_DPL_HEADER(dl)->hash);
+    free(MDBX_DPL_HEADER(dl));
+  }
+}
 
-  if (x <= pnl[0].mid && pnl[x].mid == id->mid)
-    return /* duplicate */ -1;
+static __inline unsigned mdbx_dpl_hash(const MDBX_DPL_header *hdr,
+                                       pgno_t pgno) {
+  /* Fibonacci hashing */
+  return (uint32_t)(pgno * UINT32_C(2654435769)) >> (32 - hdr->hash_bits);
+}
 
-  if (unlikely(pnl[0].mid >= MDBX_PNL_UM_MAX))
-    return /* too big */ -2;
+static void mdbx_dpl_hash_put(MDBX_ID2L dl, unsigned x) {
+  MDBX_DPL_header *hdr = MDBX_DPL_HEADER(dl);
+  const unsigned mask = (1u << hdr->hash_bits) - 1;
+  unsigned i = mdbx_dpl_hash(hdr, dl[x].mid);
+  while (hdr->hash[i])
+    i = (i + 1) & mask;
+  hdr->hash[i] = x;
+}
 
-  /* insert id */
-  pnl[0].mid++;
-  for (unsigned i = (unsigned)pnl[0].mid; i > x; i--)
-    pnl[i] = pnl[i - 1];
-  pnl[x] = *id;
-  return 0;
+/* Returns the slot of the index which refers to the x-th item. */
+static unsigned mdbx_dpl_hash_slot(MDBX_ID2L dl, unsigned x) {
+  const MDBX_DPL_header *hdr = MDBX_DPL_HEADER(dl);
+  const unsigned mask = (1u << hdr->hash_bits) - 1;
+  unsigned i = mdbx_dpl_hash(hdr, dl[x].mid);
+  while (hdr->hash[i] != x) {
+    assert(hdr->hash[i] != 0);
+    i = (i + 1) & mask;
+  }
+  return i;
+}
+
+/* Delete the slot of the index by backward-shift, so the probe sequences
+ * of the rest stay unbroken without tombstones. */
+static void mdbx_dpl_hash_del(MDBX_ID2L dl, unsigned i) {
+  MDBX_DPL_header *hdr = MDBX_DPL_HEADER(dl);
+  const unsigned mask = (1u << hdr->hash_bits) - 1;
+  for (unsigned j = (i + 1) & mask, x; (x = hdr->hash[j]) != 0;
+       j = (j + 1) & mask) {
+    /* the entry could be moved back to the hole only if its home slot
+     * isn't cyclically within (i, j] */
+    const unsigned home = mdbx_dpl_hash(hdr, dl[x].mid);
+    if (((j - home) & mask) >= ((j - i) & mask)) {
+      hdr->hash[i] = x;
+      i = j;
+    }
+  }
+  hdr->hash[i] = 0;
+}
+
+/* Rebuild the index of the unsorted tail, which must be allocated.
+ * The index is cleared entirely if the tail is empty. */
+static void mdbx_dpl_reindex(MDBX_ID2L dl) {
+  MDBX_DPL_header *hdr = MDBX_DPL_HEADER(dl);
+  memset(hdr->hash, 0, sizeof(unsigned) << hdr->hash_bits);
+  for (unsigned x = hdr->sorted; ++x <= dl[0].mid;)
+    mdbx_dpl_hash_put(dl, x);
+}
+
+/* Make the list empty, keeping the allocated memory. */
+static void mdbx_dpl_clear(MDBX_ID2L dl) {
+  MDBX_DPL_header *hdr = MDBX_DPL_HEADER(dl);
+  if (hdr->hash)
+    memset(hdr->hash, 0, sizeof(unsigned) << hdr->hash_bits);
+  hdr->sorted = 0;
+  dl[0].mid = 0;
 }
 
-/* Append an ID2 into a ID2L.
- * [in,out] pnl The ID2L to append into.
- * [in] id The ID2 to append.
- * Returns 0 on success, -2 if the ID2L is too big. */
-static int mdbx_mid2l_append(MDBX_ID2L pnl, MDBX_ID2 *id) {
+/* Sort the items of a DPL by pgno, i.e. merge the unsorted tail into the
+ * sorted part. There is always a room for a copy of the tail past the end
+ * of the list, so no allocation is needed. */
+static void __hot mdbx_dpl_sort(MDBX_ID2L dl) {
+  MDBX_DPL_header *hdr = MDBX_DPL_HEADER(dl);
+  const unsigned n = (unsigned)dl[0].mid, tail = n - hdr->sorted;
+  if (tail == 0)
+    return;
+
+  /* Quicksort + Insertion sort of the tail copy */
+  MDBX_ID2 *const tmp = dl + n, a;
+  memcpy(tmp + 1, dl + hdr->sorted + 1, tail * sizeof(MDBX_ID2));
+  int istack[sizeof(int) * CHAR_BIT * 2];
+  int i, j, k, l = 1, ir = (int)tail, jstack = 0;
+
+#define DPL_SMALL 8
+#define DPL_SWAP(a, b)                                                         \
+  do {                                                                         \
+    MDBX_ID2 tmp_id2 = (a);                                                    \
+    (a) = (b);                                                                 \
+    (b) = tmp_id2;                                                             \
+  } while (0)
+
+  while (1) {
+    if (ir - l < DPL_SMALL) { /* Insertion sort */
+      for (j = l + 1; j <= ir; j++) {
+        a = tmp[j];
+        for (i = j - 1; i >= 1; i--) {
+          if (tmp[i].mid < a.mid)
+            break;
+          tmp[i + 1] = tmp[i];
+        }
+        tmp[i + 1] = a;
+      }
+      if (jstack == 0)
+        break;
+      ir = istack[jstack--];
+      l = istack[jstack--];
+    } else {
+      k = (l + ir) >> 1; /* Choose median of left, center, right */
+      DPL_SWAP(tmp[k], tmp[l + 1]);
+      if (tmp[l].mid > tmp[ir].mid)
+        DPL_SWAP(tmp[l], tmp[ir]);
+      if (tmp[l + 1].mid > tmp[ir].mid)
+        DPL_SWAP(tmp[l + 1], tmp[ir]);
+      if (tmp[l].mid > tmp[l + 1].mid)
+        DPL_SWAP(tmp[l], tmp[l + 1]);
+
+      i = l + 1;
+      j = ir;
+      a = tmp[l + 1];
+      while (1) {
+        do
+          i++;
+        while (tmp[i].mid < a.mid);
+        do
+          j--;
+        while (tmp[j].mid > a.mid);
+        if (j < i)
+          break;
+        DPL_SWAP(tmp[i], tmp[j]);
+      }
+      tmp[l + 1] = tmp[j];
+      tmp[j] = a;
+      jstack += 2;
+      if (ir - i + 1 >= j - l) {
+        istack[jstack] = ir;
+        istack[jstack - 1] = i;
+        ir = j - 1;
+      } else {
+        istack[jstack] = j - 1;
+        istack[jstack - 1] = l;
+        l = i;
+      }
+    }
+  }
+#undef DPL_SMALL
+#undef DPL_SWAP
+
+  /* Merge from the end, so each item of the sorted part moves once */
+  unsigned x = hdr->sorted, y = tail, w = n;
+  while (y) {
+    if (x && dl[x].mid > tmp[y].mid)
+      dl[w--] = dl[x--];
+    else
+      dl[w--] = tmp[y--];
+  }
+
+  if (hdr->hash)
+    memset(hdr->hash, 0, sizeof(unsigned) << hdr->hash_bits);
+  hdr->sorted = n;
 #if MDBX_DEBUG
-  for (unsigned i = pnl[0].mid; i > 0; --i) {
-    assert(pnl[i].mid != id->mid);
-    if (unlikely(pnl[i].mid == id->mid))
-      return -1;
+  for (const MDBX_ID2 *ptr = dl + dl[0].mid; --ptr > dl;) {
+    assert(ptr[0].mid < ptr[1].mid);
+    assert(ptr[0].mid >= NUM_METAS);
   }
 #endif
+}
 
-  /* Too big? */
-  if (unlikely(pnl[0].mid >= MDBX_PNL_UM_MAX))
-    return -2;
+/* Search for a page in a DPL.
+ * Returns the index of the page, or zero if not found. */
+static unsigned __hot mdbx_dpl_search(MDBX_ID2L dl, pgno_t pgno) {
+  const MDBX_DPL_header *hdr = MDBX_DPL_HEADER(dl);
+  unsigned base = 0, n = hdr->sorted;
+  while (n > 0) {
+    const unsigned pivot = n >> 1;
+    const unsigned cursor = base + pivot + 1;
+    if (pgno < dl[cursor].mid) {
+      n = pivot;
+    } else if (pgno > dl[cursor].mid) {
+      base = cursor;
+      n -= pivot + 1;
+    } else {
+      return cursor;
+    }
+  }
 
-  pnl[0].mid++;
-  pnl[pnl[0].mid] = *id;
+  if (dl[0].mid > hdr->sorted) {
+    if (hdr->hash) {
+      const unsigned mask = (1u << hdr->hash_bits) - 1;
+      for (unsigned i = mdbx_dpl_hash(hdr, pgno), x; (x = hdr->hash[i]) != 0;
+           i = (i + 1) & mask)
+        if (likely(x <= dl[0].mid) && dl[x].mid == pgno)
+          return x;
+    } else {
+      for (unsigned x = hdr->sorted; ++x <= dl[0].mid;)
+        if (dl[x].mid == pgno)
+          return x;
+    }
+  }
   return 0;
 }
 
+/* Find a page in a DPL.
+ * Returns the page, or NULL if not found. */
+static __inline MDBX_page *mdbx_dpl_find(MDBX_ID2L dl, pgno_t pgno) {
+  const unsigned x = mdbx_dpl_search(dl, pgno);
+  return x ? dl[x].mptr : NULL;
+}
+
+/* Remove an item from a DPL, keeping the sorted part in order.
+ * The hole is filled by the last item of the unsorted tail, so only
+ * two slots of the tail index are changed. */
+static void mdbx_dpl_remove(MDBX_ID2L dl, unsigned x) {
+  MDBX_DPL_header *hdr = MDBX_DPL_HEADER(dl);
+  const unsigned n = (unsigned)dl[0].mid;
+  assert(x > 0 && x <= n);
+  if (x <= hdr->sorted) {
+    memmove(dl + x, dl + x + 1, (hdr->sorted - x) * sizeof(MDBX_ID2));
+    x = hdr->sorted;
+    hdr->sorted -= 1;
+  } else if (hdr->hash)
+    mdbx_dpl_hash_del(dl, mdbx_dpl_hash_slot(dl, x));
+
+  if (x < n) {
+    if (hdr->hash)
+      hdr->hash[mdbx_dpl_hash_slot(dl, n)] = x;
+    dl[x] = dl[n];
+  }
+  dl[0].mid = n - 1;
+}
+
+/* Make sure the txn's DPL has a room for the given number of items,
+ * including a copy of the unsorted tail to be sorted. */
+static int mdbx_dpl_reserve(MDBX_txn *txn, size_t wanna) {
+  MDBX_ID2L dl = txn->mt_rw_dirtylist;
+  MDBX_DPL_header *hdr = MDBX_DPL_HEADER(dl);
+  if (likely(wanna <= hdr->allocated))
+    return MDBX_SUCCESS;
+
+  size_t size = hdr->allocated;
+  while (size < wanna)
+    size += size;
+  if (unlikely(size > UINT_MAX / 2))
+    return MDBX_TXN_FULL;
+  hdr = realloc(hdr, sizeof(MDBX_DPL_header) + (size + 1) * sizeof(MDBX_ID2));
+  if (unlikely(!hdr))
+    return MDBX_ENOMEM;
+  hdr->allocated = (unsigned)size;
+  dl = (MDBX_ID2L)(hdr + 1);
+  txn->mt_rw_dirtylist = dl;
+  if (!txn->mt_parent)
+    txn->mt_env->me_dirtylist = dl;
+  return MDBX_SUCCESS;
+}
+
+/* Append a page to the txn's DPL.
+ * Returns 0 on success, non-zero on failure. */
+static int mdbx_dpl_append(MDBX_txn *txn, pgno_t pgno, MDBX_page *page) {
+  MDBX_ID2L dl = txn->mt_rw_dirtylist;
+  MDBX_DPL_header *hdr = MDBX_DPL_HEADER(dl);
+  mdbx_tassert(txn, mdbx_dpl_search(dl, pgno) == 0);
+  const unsigned n = (unsigned)dl[0].mid + 1;
+  const bool sorted = hdr->sorted + 1 == n && (n == 1 || dl[n - 1].mid < pgno);
+  /* the list is never sorted with MDBX_WRITEMAP */
+  const unsigned tail = (sorted || (txn->mt_flags & MDBX_TXN_WRITEMAP))
+                            ? 0
+                            : n - hdr->sorted;
+  int rc = mdbx_dpl_reserve(txn, n + tail);
+  if (unlikely(rc != MDBX_SUCCESS))
+    return rc;
+  dl = txn->mt_rw_dirtylist;
+  hdr = MDBX_DPL_HEADER(dl);
+
+  dl[n].mid = pgno;
+  dl[n].mptr = page;
+  dl[0].mid = n;
+  if (sorted) {
+    hdr->sorted = n;
+    return MDBX_SUCCESS;
+  }
+
+  /* lookups of pages aren't needed with MDBX_WRITEMAP */
+  if (txn->mt_flags & MDBX_TXN_WRITEMAP)
+    return MDBX_SUCCESS;
+
+  if (unlikely(tail + tail > (1u << hdr->hash_bits))) {
+    unsigned bits = hdr->hash_bits ? hdr->hash_bits + 1 : 10;
+    while ((tail + tail) >> bits)
+      bits += 1;
+    unsigned *hash = realloc(hdr->hash, sizeof(unsigned) << bits);
+    if (unlikely(!hash)) {
+      dl[0].mid = n - 1;
+      return MDBX_ENOMEM;
+    }
+    hdr->hash = hash;
+    hdr->hash_bits = bits;
+    mdbx_dpl_reindex(dl);
+  } else
+    mdbx_dpl_hash_put(dl, n);
+  return MDBX_SUCCESS;
+}
+
+/* Shrink the DPL of a finished top-level txn if it has grown too much. */
+static void mdbx_dpl_shrink(MDBX_env *env) {
+  MDBX_DPL_header *hdr = MDBX_DPL_HEADER(env->me_dirtylist);
+  if (unlikely(hdr->allocated > MDBX_PNL_UM_SIZE)) {
+    free(hdr->hash);
+    hdr->hash = NULL;
+    hdr->hash_bits = 0;
+    hdr = realloc(hdr, sizeof(MDBX_DPL_header) +
+                           (MDBX_PNL_UM_SIZE + 1) * sizeof(MDBX_ID2));
+    if (likely(hdr)) {
+      hdr->allocated = MDBX_PNL_UM_SIZE;
+      env->me_dirtylist = (MDBX_ID2L)(hdr + 1);
+    }
+  }
+}
+
 /*----------------------------------------------------------------------------*/
 
 int mdbx_runtime_flags = MDBX_DBG_PRINT
@@ -629,6 +1242,7 @@ static int mdbx_page_search_root(MDBX_cursor *mc, MDBX_val *key, int modify);
 #define MDBX_PS_ROOTONLY 2
 #define MDBX_PS_FIRST 4
 #define MDBX_PS_LAST 8
+#define MDBX_PS_GALLOP 16 /* gallop from the current position on first page */
 static int mdbx_page_search(MDBX_cursor *mc, MDBX_val *key, int flags);
 static int mdbx_page_merge(MDBX_cursor *csrc, MDBX_cursor *cdst);
 
@@ -648,8 +1262,10 @@ static void mdbx_node_del(MDBX_cursor *mc, size_t ksize);
 static void mdbx_node_shrink(MDBX_page *mp, unsigned indx);
 static int mdbx_node_move(MDBX_cursor *csrc, MDBX_cursor *cdst, int fromleft);
 static int mdbx_node_read(MDBX_cursor *mc, MDBX_node *leaf, MDBX_val *data);
-static size_t mdbx_leaf_size(MDBX_env *env, MDBX_val *key, MDBX_val *data);
-static size_t mdbx_branch_size(MDBX_env *env, MDBX_val *key);
+static size_t mdbx_leaf_size(MDBX_env *env, const MDBX_page *mp, MDBX_val *key,
+                             MDBX_val *data);
+static size_t mdbx_branch_size(MDBX_cursor *mc, const MDBX_page *mp,
+                               MDBX_val *key);
 
 static int mdbx_rebalance(MDBX_cursor *mc);
 static int mdbx_update_key(MDBX_cursor *mc, MDBX_val *key);
@@ -924,7 +1540,7 @@ static void mdbx_page_list(MDBX_page *mp) {
       else
         nsize += NODEDSZ(node);
       total += nsize;
-      nsize += sizeof(indx_t);
+      nsize += PAGESLOTSZ(mp);
       mdbx_print("key %u: nsize %u, %s%s\n", i, nsize, DKEY(&key),
                  mdbx_leafnode_type(node));
     }
@@ -1035,7 +1651,13 @@ static MDBX_page *mdbx_page_malloc(MDBX_txn *txn, unsigned num) {
     env->me_dpages = np->mp_next;
   } else {
     size = pgno2bytes(env, num);
-    np = malloc(size);
+    if (env->me_flags & MDBX_DIRECTWRITE) {
+      /* the pages will be written by O_DIRECT */
+      if (unlikely(mdbx_memalign_alloc(env->me_os_psize, size,
+                                       (void **)&np) != MDBX_SUCCESS))
+        np = NULL;
+    } else
+      np = malloc(size);
     if (unlikely(!np)) {
       txn->mt_flags |= MDBX_TXN_ERROR;
       return np;
@@ -1080,7 +1702,10 @@ static void mdbx_dpage_free(MDBX_env *env, MDBX_page *dp) {
   } else {
     /* large pages just get freed directly */
     VALGRIND_MEMPOOL_FREE(env, dp);
-    free(dp);
+    if (env->me_flags & MDBX_DIRECTWRITE)
+      mdbx_memalign_free(dp);
+    else
+      free(dp);
   }
 }
 
@@ -1093,7 +1718,7 @@ static void mdbx_dlist_free(MDBX_txn *txn) {
   for (i = 1; i <= n; i++)
     mdbx_dpage_free(env, dl[i].mptr);
 
-  dl[0].mid = 0;
+  mdbx_dpl_clear(dl);
 }
 
 static size_t bytes_align2os_bytes(const MDBX_env *env, size_t bytes) {
@@ -1139,8 +1764,8 @@ static int mdbx_page_loose(MDBX_cursor *mc, MDBX_page *mp) {
       /* If txn has a parent,
        * make sure the page is in our dirty list. */
       if (dl[0].mid) {
-        unsigned x = mdbx_mid2l_search(dl, pgno);
-        if (x <= dl[0].mid && dl[x].mid == pgno) {
+        unsigned x = mdbx_dpl_search(dl, pgno);
+        if (x) {
           if (unlikely(mp != dl[x].mptr)) { /* bad cursor? */
             mdbx_error("wrong page 0x%p #%" PRIaPGNO
                        " in the dirtylist[%d], expecting %p",
@@ -1245,7 +1870,7 @@ mark_done:
   return rc;
 }
 
-static int mdbx_page_flush(MDBX_txn *txn, pgno_t keep);
+static int mdbx_page_flush(MDBX_txn *txn, pgno_t keep, bool datasync);
 
 /* Spill pages from the dirty list back to disk.
  * This is intended to prevent running into MDBX_TXN_FULL situations,
@@ -1328,8 +1953,13 @@ static int mdbx_page_spill(MDBX_cursor *m0, MDBX_val *key, MDBX_val *data) {
    * of those pages will need to be used again. So now we spill only 1/8th
    * of the dirty pages. Testing revealed this to be a good tradeoff,
    * better than 1/2, 1/4, or 1/10. */
-  if (need < MDBX_PNL_UM_MAX / 8)
-    need = MDBX_PNL_UM_MAX / 8;
+  if (need < txn->mt_env->me_maxdirty / 8)
+    need = (pgno_t)(txn->mt_env->me_maxdirty / 8);
+
+  /* the pages are flushed in order, and without MDBX_WRITEMAP the
+   * order should be of pgno for the write coalescing */
+  if (!(txn->mt_flags & MDBX_TXN_WRITEMAP))
+    mdbx_dpl_sort(dl);
 
   /* Save the page IDs of all the pages we're flushing */
   /* flush from the tail forward, this saves a lot of shifting later on. */
@@ -1362,7 +1992,7 @@ static int mdbx_page_spill(MDBX_cursor *m0, MDBX_val *key, MDBX_val *data) {
   mdbx_pnl_sort(txn->mt_spill_pages);
 
   /* Flush the spilled part of dirty list */
-  rc = mdbx_page_flush(txn, i);
+  rc = mdbx_page_flush(txn, i, false);
   if (unlikely(rc != MDBX_SUCCESS))
     goto bailout;
 
@@ -1598,20 +2228,14 @@ static txnid_t mdbx_find_oldest(MDBX_txn *txn) {
 }
 
 /* Add a page to the txn's dirty list */
-static void mdbx_page_dirty(MDBX_txn *txn, MDBX_page *mp) {
-  MDBX_ID2 mid;
-  int rc, (*insert)(MDBX_ID2L, MDBX_ID2 *);
-
-  if (txn->mt_flags & MDBX_TXN_WRITEMAP) {
-    insert = mdbx_mid2l_append;
-  } else {
-    insert = mdbx_mid2l_insert;
+static int mdbx_page_dirty(MDBX_txn *txn, MDBX_page *mp) {
+  int rc = mdbx_dpl_append(txn, mp->mp_pgno, mp);
+  if (unlikely(rc != MDBX_SUCCESS)) {
+    txn->mt_flags |= MDBX_TXN_ERROR;
+    return rc;
   }
-  mid.mid = mp->mp_pgno;
-  mid.mptr = mp;
-  rc = insert(txn->mt_rw_dirtylist, &mid);
-  mdbx_tassert(txn, rc == 0);
   txn->mt_dirtyroom--;
+  return MDBX_SUCCESS;
 }
 
 static int mdbx_mapresize(MDBX_env *env, const pgno_t size_pgno,
@@ -2085,7 +2709,13 @@ done:
   np->mp_leaf2_ksize = 0;
   np->mp_flags = 0;
   np->mp_pages = num;
-  mdbx_page_dirty(txn, np);
+  rc = mdbx_page_dirty(txn, np);
+  if (unlikely(rc != MDBX_SUCCESS)) {
+    if (!(env->me_flags & MDBX_WRITEMAP))
+      mdbx_dpage_free(env, np);
+    *mp = NULL;
+    return rc;
+  }
   *mp = np;
 
   mdbx_tassert(txn, mdbx_pnl_check(env->me_reclaimed_pglist));
@@ -2162,7 +2792,12 @@ static int mdbx_page_unspill(MDBX_txn *txn, MDBX_page *mp, MDBX_page **ret) {
       } /* otherwise, if belonging to a parent txn, the
          * page remains spilled until child commits */
 
-      mdbx_page_dirty(txn, np);
+      int rc = mdbx_page_dirty(txn, np);
+      if (unlikely(rc != MDBX_SUCCESS)) {
+        if (np != mp)
+          mdbx_dpage_free(env, np);
+        return rc;
+      }
       np->mp_flags |= P_DIRTY;
       *ret = np;
       break;
@@ -2213,12 +2848,12 @@ static int mdbx_page_touch(MDBX_cursor *mc) {
     }
   } else if (txn->mt_parent && !IS_SUBP(mp)) {
     mdbx_tassert(txn, (txn->mt_env->me_flags & MDBX_WRITEMAP) == 0);
-    MDBX_ID2 mid, *dl = txn->mt_rw_dirtylist;
+    MDBX_ID2 *dl = txn->mt_rw_dirtylist;
     pgno = mp->mp_pgno;
     /* If txn has a parent, make sure the page is in our dirty list. */
     if (dl[0].mid) {
-      unsigned x = mdbx_mid2l_search(dl, pgno);
-      if (x <= dl[0].mid && dl[x].mid == pgno) {
+      unsigned x = mdbx_dpl_search(dl, pgno);
+      if (x) {
         if (unlikely(mp != dl[x].mptr)) { /* bad cursor? */
           mdbx_error("wrong page 0x%p #%" PRIaPGNO
                      " in the dirtylist[%d], expecting %p",
@@ -2232,15 +2867,15 @@ static int mdbx_page_touch(MDBX_cursor *mc) {
     }
 
     mdbx_debug("clone db %d page %" PRIaPGNO, DDBI(mc), mp->mp_pgno);
-    mdbx_cassert(mc, dl[0].mid < MDBX_PNL_UM_MAX);
     /* No - copy it */
     np = mdbx_page_malloc(txn, 1);
     if (unlikely(!np))
       return MDBX_ENOMEM;
-    mid.mid = pgno;
-    mid.mptr = np;
-    rc = mdbx_mid2l_insert(dl, &mid);
-    mdbx_cassert(mc, rc == 0);
+    rc = mdbx_dpl_append(txn, pgno, np);
+    if (unlikely(rc != MDBX_SUCCESS)) {
+      mdbx_dpage_free(txn->mt_env, np);
+      goto fail;
+    }
   } else {
     return MDBX_SUCCESS;
   }
@@ -2281,7 +2916,19 @@ fail:
   return rc;
 }
 
-int mdbx_env_sync(MDBX_env *env, int force) {
+/* All written data became durable, so nothing is pending for the sync
+ * nor for the MDBX_WRITEBACK. */
+static __inline void mdbx_sync_pending_reset(MDBX_env *env) {
+  env->me_sync_pending = 0;
+  env->me_writeback_begin = env->me_writeback_end = 0;
+  env->me_writeback_pending = 0;
+}
+
+/* Makes the head meta steady. If more than nolock_threshold pages are pending,
+ * then the data is flushed without holding the writer lock, so writers could
+ * proceed meanwhile, and only the meta is written under the lock. */
+static int mdbx_env_sync_ex(MDBX_env *env, int force,
+                            pgno_t nolock_threshold) {
   if (unlikely(!env))
     return MDBX_EINVAL;
 
@@ -2312,19 +2959,27 @@ int mdbx_env_sync(MDBX_env *env, int force) {
       flags &= MDBX_WRITEMAP /* clear flags for full steady sync */;
 
     if (outside_txn &&
-        env->me_sync_pending >
-            pgno2bytes(env, 16 /* FIXME: define threshold */) &&
+        env->me_sync_pending > pgno2bytes(env, nolock_threshold) &&
         (flags & MDBX_NOSYNC) == 0) {
       assert(((flags ^ env->me_flags) & MDBX_WRITEMAP) == 0);
       const size_t usedbytes = pgno_align2os_bytes(env, head->mm_geo.next);
+      /* all pending bytes are already written, since we hold the lock */
+      const size_t presync_bytes = env->me_sync_pending;
+      const MDBX_meta *const steady = mdbx_meta_steady(env);
+      const txnid_t presync_steady = mdbx_meta_txnid_stable(env, steady);
+      const bool grown = head->mm_geo.next > steady->mm_geo.now;
 
       mdbx_txn_unlock(env);
 
       /* LY: pre-sync without holding lock to reduce latency for writer(s) */
-      int rc = (flags & MDBX_WRITEMAP)
-                   ? mdbx_msync(&env->me_dxb_mmap, 0, usedbytes,
-                                flags & MDBX_MAPASYNC)
-                   : mdbx_filesync(env->me_fd, false);
+      int rc;
+      if (flags & MDBX_WRITEMAP) {
+        rc = mdbx_msync(&env->me_dxb_mmap, 0, usedbytes, flags & MDBX_MAPASYNC);
+        if (likely(rc == MDBX_SUCCESS) && grown &&
+            (flags & MDBX_MAPASYNC) == 0)
+          rc = mdbx_filesize_sync(env->me_fd);
+      } else
+        rc = mdbx_filesync(env->me_fd, grown);
       if (unlikely(rc != MDBX_SUCCESS))
         return rc;
 
@@ -2332,6 +2987,20 @@ int mdbx_env_sync(MDBX_env *env, int force) {
       if (unlikely(rc != MDBX_SUCCESS))
         return rc;
 
+      /* the pre-synced bytes are durable now, so mdbx_sync_locked() will
+       * flush only the data written meanwhile, if any. Unless the counter was
+       * reset by a steady commit, then it just stays larger than need. */
+      if ((flags & MDBX_MAPASYNC) == 0 &&
+          mdbx_meta_txnid_stable(env, mdbx_meta_steady(env)) ==
+              presync_steady &&
+          env->me_sync_pending >= presync_bytes) {
+        env->me_sync_pending -= presync_bytes;
+        /* the range pending for MDBX_WRITEBACK is durable too, except
+         * the data written meanwhile, which the next chunk will cover. */
+        env->me_writeback_begin = env->me_writeback_end = 0;
+        env->me_writeback_pending = 0;
+      }
+
       /* LY: head may be changed. */
       head = mdbx_meta_head(env);
     }
@@ -2355,11 +3024,201 @@ int mdbx_env_sync(MDBX_env *env, int force) {
   return MDBX_SUCCESS;
 }
 
-/* Back up parent txn's cursors, then grab the originals for tracking */
-static int mdbx_cursor_shadow(MDBX_txn *src, MDBX_txn *dst) {
-  MDBX_cursor *mc, *bk;
-  MDBX_xcursor *mx;
-  size_t size;
+int mdbx_env_sync(MDBX_env *env, int force) {
+  return mdbx_env_sync_ex(env, force, 16 /* FIXME: define threshold */);
+}
+
+/* Checks whether the given txnid is covered by a steady meta,
+ * i.e. was already durably written to the disk. */
+static bool mdbx_env_is_durable(const MDBX_env *env, txnid_t txnid) {
+  const MDBX_meta *steady = mdbx_meta_steady(env);
+  return META_IS_STEADY(steady) &&
+         mdbx_meta_txnid_fluid(env, steady) >= txnid;
+}
+
+/* the syncer coalesces all requests which came while a sync was
+ * running into a single subsequent mdbx_env_sync(). It also starts the
+ * writeback for MDBX_WRITEBACK, since sync_file_range() blocks until the
+ * writes are queued to the device, which the committing thread shouldn't
+ * wait for. */
+static THREAD_RESULT THREAD_CALL mdbx_syncer_thread(void *arg) {
+  MDBX_env *env = arg;
+  txnid_t done = 0;
+
+  mdbx_ensure(env, mdbx_condmutex_lock(&env->me_syncer_cond) == MDBX_SUCCESS);
+  while (!env->me_syncer_stop) {
+    if (env->me_syncer_wb_end) {
+      const size_t offset = env->me_syncer_wb_begin;
+      const size_t length = env->me_syncer_wb_end - offset;
+      env->me_syncer_wb_begin = env->me_syncer_wb_end = 0;
+      mdbx_ensure(env,
+                  mdbx_condmutex_unlock(&env->me_syncer_cond) == MDBX_SUCCESS);
+      const int rc = mdbx_mwriteback(&env->me_dxb_mmap, offset, length);
+      if (unlikely(rc != MDBX_SUCCESS))
+        mdbx_debug("Writeback error: %s", strerror(rc));
+      mdbx_ensure(env,
+                  mdbx_condmutex_lock(&env->me_syncer_cond) == MDBX_SUCCESS);
+      continue;
+    }
+
+    if (env->me_syncer_wanna <= done) {
+      mdbx_ensure(env,
+                  mdbx_condmutex_wait(&env->me_syncer_cond) == MDBX_SUCCESS);
+      continue;
+    }
+
+    done = env->me_syncer_wanna;
+    mdbx_ensure(env,
+                mdbx_condmutex_unlock(&env->me_syncer_cond) == MDBX_SUCCESS);
+    /* always flush the data without holding the writer lock, so the
+     * next writers are pipelined with the flush of the previous ones. */
+    const int rc = mdbx_env_sync_ex(env, true, 0);
+    if (unlikely(rc != MDBX_SUCCESS))
+      mdbx_error("background sync failed, error %d", rc);
+
+    mdbx_ensure(env,
+                mdbx_condmutex_lock(&env->me_durable_cond) == MDBX_SUCCESS);
+    env->me_durable_rc = rc;
+    env->me_durable_serial += 1;
+    /* there is no broadcast, but each signal wakes a distinct waiter
+     * since none of them could wait again until we release the mutex. */
+    for (unsigned i = 0; i < env->me_durable_waiters; ++i)
+      mdbx_condmutex_signal(&env->me_durable_cond);
+    mdbx_ensure(env,
+                mdbx_condmutex_unlock(&env->me_durable_cond) == MDBX_SUCCESS);
+
+    mdbx_ensure(env, mdbx_condmutex_lock(&env->me_syncer_cond) == MDBX_SUCCESS);
+  }
+  mdbx_ensure(env, mdbx_condmutex_unlock(&env->me_syncer_cond) == MDBX_SUCCESS);
+  return (THREAD_RESULT)0;
+}
+
+/* Starts the syncer if need, the me_syncer_cond must be locked. */
+static int mdbx_syncer_start(MDBX_env *env) {
+  if (likely(env->me_syncer_running))
+    return MDBX_SUCCESS;
+
+  int rc = mdbx_thread_create(&env->me_syncer, mdbx_syncer_thread, env);
+  if (likely(rc == MDBX_SUCCESS))
+    env->me_syncer_running = true;
+  return rc;
+}
+
+/* Asks the syncer to make the given txnid durable, starting it if need. */
+static int mdbx_syncer_request(MDBX_env *env, txnid_t txnid) {
+  int rc = mdbx_condmutex_lock(&env->me_syncer_cond);
+  if (unlikely(rc != MDBX_SUCCESS))
+    return rc;
+
+  rc = mdbx_syncer_start(env);
+  if (likely(rc == MDBX_SUCCESS) && env->me_syncer_wanna < txnid) {
+    env->me_syncer_wanna = txnid;
+    rc = mdbx_condmutex_signal(&env->me_syncer_cond);
+  }
+
+  mdbx_ensure(env, mdbx_condmutex_unlock(&env->me_syncer_cond) == MDBX_SUCCESS);
+  return rc;
+}
+
+/* Asks the syncer to start the writeback of the given range of the file,
+ * which is merged with a range still pending, if any. */
+static int mdbx_syncer_writeback(MDBX_env *env, size_t begin, size_t end) {
+  int rc = mdbx_condmutex_lock(&env->me_syncer_cond);
+  if (unlikely(rc != MDBX_SUCCESS))
+    return rc;
+
+  rc = mdbx_syncer_start(env);
+  if (likely(rc == MDBX_SUCCESS)) {
+    if (env->me_syncer_wb_end == 0 || env->me_syncer_wb_begin > begin)
+      env->me_syncer_wb_begin = begin;
+    if (env->me_syncer_wb_end < end)
+      env->me_syncer_wb_end = end;
+    rc = mdbx_condmutex_signal(&env->me_syncer_cond);
+  }
+
+  mdbx_ensure(env, mdbx_condmutex_unlock(&env->me_syncer_cond) == MDBX_SUCCESS);
+  return rc;
+}
+
+static void __cold mdbx_syncer_stop(MDBX_env *env) {
+  mdbx_ensure(env, mdbx_condmutex_lock(&env->me_syncer_cond) == MDBX_SUCCESS);
+  const bool running = env->me_syncer_running;
+  env->me_syncer_running = false;
+  env->me_syncer_stop = true;
+  mdbx_condmutex_signal(&env->me_syncer_cond);
+  mdbx_ensure(env, mdbx_condmutex_unlock(&env->me_syncer_cond) == MDBX_SUCCESS);
+
+  if (running)
+    mdbx_ensure(env, mdbx_thread_join(env->me_syncer) == MDBX_SUCCESS);
+}
+
+int mdbx_env_wait_durable(MDBX_env *env, uint64_t txnid, unsigned timeout_ms) {
+  if (unlikely(!env))
+    return MDBX_EINVAL;
+
+  if (unlikely(env->me_signature != MDBX_ME_SIGNATURE))
+    return MDBX_EBADSIGN;
+
+  if (unlikely(env->me_flags & (MDBX_RDONLY | MDBX_FATAL_ERROR)))
+    return MDBX_EACCESS;
+
+  if (unlikely(!env->me_map))
+    return MDBX_EPERM;
+
+  if (mdbx_env_is_durable(env, txnid))
+    return MDBX_SUCCESS;
+
+  if (timeout_ms == 0)
+    return MDBX_RESULT_TRUE;
+
+  const uint64_t deadline =
+      (timeout_ms != MDBX_WAIT_INFINITE)
+          ? mdbx_osal_monotime() + timeout_ms * UINT64_C(1000000)
+          : 0;
+
+  int rc = mdbx_condmutex_lock(&env->me_durable_cond);
+  if (unlikely(rc != MDBX_SUCCESS))
+    return rc;
+
+  /* request the sync while holding the mutex, so the completion
+   * can't be signaled before we start waiting for it. */
+  const unsigned serial = env->me_durable_serial;
+  rc = mdbx_syncer_request(env, txnid);
+  env->me_durable_waiters += 1;
+  while (rc == MDBX_SUCCESS && !mdbx_env_is_durable(env, txnid)) {
+    if (unlikely(env->me_durable_serial != serial &&
+                 env->me_durable_rc != MDBX_SUCCESS)) {
+      rc = env->me_durable_rc;
+      break;
+    }
+
+    if (timeout_ms == MDBX_WAIT_INFINITE) {
+      rc = mdbx_condmutex_wait(&env->me_durable_cond);
+      continue;
+    }
+
+    const uint64_t now = mdbx_osal_monotime();
+    if (now >= deadline) {
+      rc = MDBX_RESULT_TRUE;
+      break;
+    }
+    rc = mdbx_condmutex_timedwait(&env->me_durable_cond,
+                                  (unsigned)((deadline - now + 999999) /
+                                             UINT64_C(1000000)));
+    if (rc == MDBX_RESULT_TRUE)
+      rc = MDBX_SUCCESS /* the deadline will be checked above */;
+  }
+  env->me_durable_waiters -= 1;
+  mdbx_ensure(env,
+              mdbx_condmutex_unlock(&env->me_durable_cond) == MDBX_SUCCESS);
+  return rc;
+}
+
+/* Back up parent txn's cursors, then grab the originals for tracking */
+static int mdbx_cursor_shadow(MDBX_txn *src, MDBX_txn *dst) {
+  MDBX_cursor *mc, *bk;
+  MDBX_xcursor *mx;
+  size_t size;
   int i;
 
   for (i = src->mt_numdbs; --i >= 0;) {
@@ -2593,9 +3452,9 @@ static int mdbx_txn_renew0(MDBX_txn *txn, unsigned flags) {
     txn->mt_child = NULL;
     txn->mt_loose_pages = NULL;
     txn->mt_loose_count = 0;
-    txn->mt_dirtyroom = MDBX_PNL_UM_MAX;
+    txn->mt_dirtyroom = (unsigned)env->me_maxdirty;
     txn->mt_rw_dirtylist = env->me_dirtylist;
-    txn->mt_rw_dirtylist[0].mid = 0;
+    mdbx_dpl_clear(txn->mt_rw_dirtylist);
     txn->mt_befree_pages = env->me_free_pgs;
     txn->mt_befree_pages[0] = 0;
     txn->mt_spill_pages = NULL;
@@ -2738,22 +3597,22 @@ int mdbx_txn_begin(MDBX_env *env, MDBX_txn *parent, unsigned flags,
     unsigned i;
     txn->mt_cursors = (MDBX_cursor **)(txn->mt_dbs + env->me_maxdbs);
     txn->mt_dbiseqs = parent->mt_dbiseqs;
-    txn->mt_rw_dirtylist = malloc(sizeof(MDBX_ID2) * MDBX_PNL_UM_SIZE);
+    txn->mt_rw_dirtylist = mdbx_dpl_alloc(MDBX_DPL_INITIAL);
     if (!txn->mt_rw_dirtylist ||
         !(txn->mt_befree_pages = mdbx_pnl_alloc(MDBX_PNL_UM_MAX))) {
-      free(txn->mt_rw_dirtylist);
+      mdbx_dpl_free(txn->mt_rw_dirtylist);
       free(txn);
       return MDBX_ENOMEM;
     }
     txn->mt_txnid = parent->mt_txnid;
     txn->mt_dirtyroom = parent->mt_dirtyroom;
-    txn->mt_rw_dirtylist[0].mid = 0;
     txn->mt_spill_pages = NULL;
     txn->mt_next_pgno = parent->mt_next_pgno;
     txn->mt_end_pgno = parent->mt_end_pgno;
     parent->mt_flags |= MDBX_TXN_HAS_CHILD;
     parent->mt_child = txn;
     txn->mt_parent = parent;
+    txn->mt_owner = parent->mt_owner;
     txn->mt_numdbs = parent->mt_numdbs;
     memcpy(txn->mt_dbs, parent->mt_dbs, txn->mt_numdbs * sizeof(MDBX_db));
     /* Copy parent's mt_dbflags, but clear DB_NEW */
@@ -2897,6 +3756,7 @@ static int mdbx_txn_end(MDBX_txn *txn, unsigned mode) {
     if (!txn->mt_parent) {
       mdbx_pnl_shrink(&txn->mt_befree_pages);
       env->me_free_pgs = txn->mt_befree_pages;
+      mdbx_dpl_shrink(env);
       /* me_pgstate: */
       env->me_reclaimed_pglist = NULL;
       env->me_last_reclaimed = 0;
@@ -2914,7 +3774,7 @@ static int mdbx_txn_end(MDBX_txn *txn, unsigned mode) {
       env->me_pgstate = ((MDBX_ntxn *)txn)->mnt_pgstate;
       mdbx_pnl_free(txn->mt_befree_pages);
       mdbx_pnl_free(txn->mt_spill_pages);
-      free(txn->mt_rw_dirtylist);
+      mdbx_dpl_free(txn->mt_rw_dirtylist);
     }
 
     mdbx_pnl_free(pghead);
@@ -3110,23 +3970,33 @@ again_on_freelist_change:
         mdbx_pnl_xmerge(env->me_reclaimed_pglist, loose);
       }
 
+      /* remove all the loose pages from the dirty list at once,
+       * keeping the order of others */
       MDBX_ID2L dl = txn->mt_rw_dirtylist;
-      for (MDBX_page *mp = txn->mt_loose_pages; mp;) {
-        mdbx_tassert(txn, mp->mp_pgno < txn->mt_next_pgno);
-        mdbx_ensure(env, mp->mp_pgno >= NUM_METAS);
-
-        unsigned s, d;
-        for (s = d = 0; ++s <= dl[0].mid;)
-          if (dl[s].mid != mp->mp_pgno)
-            dl[++d] = dl[s];
-
-        dl[0].mid -= 1;
-        mdbx_tassert(txn, dl[0].mid == d);
-
-        MDBX_page *dp = mp;
-        mp = NEXT_LOOSE_PAGE(mp);
-        if ((env->me_flags & MDBX_WRITEMAP) == 0)
+      MDBX_DPL_header *const hdr = MDBX_DPL_HEADER(dl);
+      unsigned s, d, sorted = hdr->sorted;
+      for (s = d = 0; ++s <= dl[0].mid;) {
+        MDBX_page *dp = dl[s].mptr;
+        if (dp->mp_flags & P_LOOSE) {
+          mdbx_tassert(txn, dp->mp_pgno < txn->mt_next_pgno);
+          mdbx_ensure(env, dp->mp_pgno >= NUM_METAS);
+          if (s <= hdr->sorted)
+            sorted -= 1;
+        } else
+          dl[++d] = dl[s];
+      }
+      mdbx_tassert(txn, dl[0].mid - d == txn->mt_loose_count);
+      dl[0].mid = d;
+      hdr->sorted = sorted;
+      if (hdr->hash)
+        mdbx_dpl_reindex(dl);
+
+      if ((env->me_flags & MDBX_WRITEMAP) == 0) {
+        for (MDBX_page *mp = txn->mt_loose_pages; mp;) {
+          MDBX_page *dp = mp;
+          mp = NEXT_LOOSE_PAGE(mp);
           mdbx_dpage_free(env, dp);
+        }
       }
 
       txn->mt_loose_pages = NULL;
@@ -3400,20 +4270,29 @@ bailout:
 }
 
 /* Flush (some) dirty pages to the map, after clearing their dirty flag.
- * [in] txn   the transaction that's being committed
- * [in] keep  number of initial pages in dirtylist to keep dirty.
+ * [in] txn       the transaction that's being committed
+ * [in] keep      number of initial pages in dirtylist to keep dirty.
+ * [in] datasync  sync the written pages when it could be done together,
+ *                then me_sync_pending is reset. Otherwise the writeback
+ *                is started in MDBX_WRITEBACK mode.
  * Returns 0 on success, non-zero on failure. */
-static int mdbx_page_flush(MDBX_txn *txn, pgno_t keep) {
+static int mdbx_page_flush(MDBX_txn *txn, pgno_t keep, bool datasync) {
   MDBX_env *env = txn->mt_env;
   MDBX_ID2L dl = txn->mt_rw_dirtylist;
   unsigned i, j, pagecount = dl[0].mid;
   int rc;
   size_t size = 0, pos = 0;
+  mdbx_tassert(txn, keep <= MDBX_DPL_SORTED(dl) ||
+                        (env->me_flags & MDBX_WRITEMAP) != 0);
   pgno_t pgno = 0;
   MDBX_page *dp = NULL;
-  struct iovec iov[MDBX_COMMIT_PAGES];
+  struct iovec iov_stack[MDBX_COMMIT_PAGES], *iov = iov_stack;
+  const mdbx_filehandle_t fd =
+      (env->me_dfd != INVALID_HANDLE_VALUE) ? env->me_dfd : env->me_fd;
   intptr_t wpos = 0, wsize = 0;
   size_t next_pos = 1; /* impossible pos, so pos != next_pos */
+  size_t flushed_begin = SIZE_MAX, flushed_end = 0;
+  const size_t pending_before = env->me_sync_pending;
   int n = 0;
 
   j = i = keep;
@@ -3430,12 +4309,36 @@ static int mdbx_page_flush(MDBX_txn *txn, pgno_t keep) {
       }
       dp->mp_flags &= ~P_DIRTY;
       dp->mp_validator = 0 /* TODO */;
-      env->me_sync_pending +=
-          IS_OVERFLOW(dp) ? pgno2bytes(env, dp->mp_pages) : env->me_psize;
+      pos = pgno2bytes(env, dl[i].mid);
+      size = IS_OVERFLOW(dp) ? pgno2bytes(env, dp->mp_pages) : env->me_psize;
+      env->me_sync_pending += size;
+      if (flushed_begin > pos)
+        flushed_begin = pos;
+      if (flushed_end < pos + size)
+        flushed_end = pos + size;
     }
     goto done;
   }
 
+  mdbx_dpl_sort(dl);
+
+#if MDBX_USE_IOURING
+  /* queue all runs of pages and submit them at once, therefore
+   * the iovecs must live until the end. */
+  mdbx_ioring_t *const ring = env->me_ioring;
+  if (ring) {
+    if (unlikely(env->me_ioring_iov_size < pagecount - keep)) {
+      const unsigned wanna = pagecount - keep + MDBX_COMMIT_PAGES;
+      struct iovec *ptr = realloc(env->me_ioring_iov, wanna * sizeof(*ptr));
+      if (unlikely(!ptr))
+        return MDBX_ENOMEM;
+      env->me_ioring_iov = ptr;
+      env->me_ioring_iov_size = wanna;
+    }
+    iov = env->me_ioring_iov;
+  }
+#endif
+
   /* Write the pages */
   for (;;) {
     if (++i <= pagecount) {
@@ -3453,14 +4356,28 @@ static int mdbx_page_flush(MDBX_txn *txn, pgno_t keep) {
       pos = pgno2bytes(env, pgno);
       size = IS_OVERFLOW(dp) ? pgno2bytes(env, dp->mp_pages) : env->me_psize;
       env->me_sync_pending += size;
+      if (flushed_begin > pos)
+        flushed_begin = pos;
+      if (flushed_end < pos + size)
+        flushed_end = pos + size;
     }
     /* Write up to MDBX_COMMIT_PAGES dirty pages at a time. */
     if (pos != next_pos || n == MDBX_COMMIT_PAGES || wsize + size > MAX_WRITE) {
       if (n) {
         /* Write previous page(s) */
-        rc = mdbx_pwritev(env->me_fd, iov, n, wpos, wsize);
+#if MDBX_USE_IOURING
+        if (ring) {
+          rc = mdbx_ioring_pwritev(ring, fd, iov, n, wpos, wsize);
+          iov += n;
+        } else
+#endif
+          rc = mdbx_pwritev(fd, iov, n, wpos, wsize);
         if (unlikely(rc != MDBX_SUCCESS)) {
           mdbx_debug("Write error: %s", strerror(rc));
+#if MDBX_USE_IOURING
+          if (ring)
+            (void)mdbx_ioring_wait(ring);
+#endif
           return rc;
         }
         n = 0;
@@ -3478,6 +4395,25 @@ static int mdbx_page_flush(MDBX_txn *txn, pgno_t keep) {
     n++;
   }
 
+#if MDBX_USE_IOURING
+  if (ring) {
+    rc = MDBX_SUCCESS;
+    if (datasync)
+      rc = mdbx_ioring_filesync(
+          ring, env->me_fd,
+          txn->mt_next_pgno > mdbx_meta_steady(env)->mm_geo.now);
+    const int err = mdbx_ioring_wait(ring);
+    if (rc == MDBX_SUCCESS)
+      rc = err;
+    if (unlikely(rc != MDBX_SUCCESS)) {
+      mdbx_debug("Write error: %s", strerror(rc));
+      return rc;
+    }
+    if (datasync)
+      mdbx_sync_pending_reset(env);
+  }
+#endif
+
   mdbx_invalidate_cache(env->me_map, pgno2bytes(env, txn->mt_next_pgno));
 
   for (i = keep; ++i <= pagecount;) {
@@ -3492,12 +4428,57 @@ static int mdbx_page_flush(MDBX_txn *txn, pgno_t keep) {
   }
 
 done:
+  if ((env->me_flags & MDBX_WRITEBACK) && !datasync &&
+      flushed_end > flushed_begin && env->me_dfd == INVALID_HANDLE_VALUE) {
+    if (env->me_writeback_pending == 0 ||
+        env->me_writeback_begin > flushed_begin)
+      env->me_writeback_begin = flushed_begin;
+    if (env->me_writeback_pending == 0 || env->me_writeback_end < flushed_end)
+      env->me_writeback_end = flushed_end;
+    env->me_writeback_pending += env->me_sync_pending - pending_before;
+    /* starting the writeback costs about the same as writing itself,
+     * so do it by chunks rather than on each commit. Then a later sync
+     * will wait only for the rest. */
+    const size_t chunk = env->me_sync_threshold ? env->me_sync_threshold / 8
+                                                : MDBX_WRITEBACK_CHUNK;
+    if (env->me_writeback_pending >= chunk) {
+      const size_t offset =
+          env->me_writeback_begin & ~(size_t)(env->me_os_psize - 1);
+      rc = mdbx_syncer_writeback(env, offset, env->me_writeback_end);
+      if (unlikely(rc != MDBX_SUCCESS))
+        rc = mdbx_mwriteback(&env->me_dxb_mmap, offset,
+                             env->me_writeback_end - offset);
+      if (unlikely(rc != MDBX_SUCCESS))
+        mdbx_debug("Writeback error: %s", strerror(rc));
+      env->me_writeback_pending = 0;
+    }
+  }
+
   i--;
   txn->mt_dirtyroom += i - j;
   dl[0].mid = j;
+  /* the kept pages are still sorted, except with MDBX_WRITEMAP where
+   * the order doesn't matter and the list isn't indexed */
+  MDBX_DPL_SORTED(dl) = (env->me_flags & MDBX_WRITEMAP) ? 0 : j;
   return MDBX_SUCCESS;
 }
 
+/* Features of the format used by the tables known to the txn,
+ * see MDBX_META_FEATURES. */
+static unsigned mdbx_txn_features(const MDBX_txn *txn) {
+  unsigned flags = 0;
+  for (MDBX_dbi i = MAIN_DBI; i < txn->mt_numdbs; i++)
+    if (txn->mt_dbflags[i] & DB_VALID)
+      flags |= txn->mt_dbs[i].md_flags;
+
+  unsigned features = 0;
+  if (flags & MDBX_FPRINT)
+    features |= MDBX_META_FPRINT;
+  if (flags & MDBX_COUNTED)
+    features |= MDBX_META_COUNTED;
+  return features;
+}
+
 int mdbx_txn_commit(MDBX_txn *txn) {
   int rc;
 
@@ -3516,6 +4497,17 @@ int mdbx_txn_commit(MDBX_txn *txn) {
     return MDBX_PANIC;
   }
 
+  if ((env->me_flags & MDBX_GROUPCOMMIT) && !txn->mt_parent &&
+      !((env->me_flags | txn->mt_flags) & (MDBX_NOSYNC | MDBX_TXN_RDONLY))) {
+    /* commit a weak meta, then wait for the syncer which makes it
+     * steady together with all others committed meanwhile. */
+    uint64_t txnid;
+    rc = mdbx_txn_commit_async(txn, &txnid);
+    if (likely(rc == MDBX_SUCCESS))
+      rc = mdbx_env_wait_durable(env, txnid, MDBX_WAIT_INFINITE);
+    return rc;
+  }
+
   if (txn->mt_child) {
     rc = mdbx_txn_commit(txn->mt_child);
     txn->mt_child = NULL;
@@ -3557,6 +4549,12 @@ int mdbx_txn_commit(MDBX_txn *txn) {
       txn->mt_lifo_reclaimed = NULL;
     }
 
+    /* Room for merging our dirty list with parent's */
+    rc = mdbx_dpl_reserve(parent, parent->mt_rw_dirtylist[0].mid +
+                                      txn->mt_rw_dirtylist[0].mid);
+    if (unlikely(rc != MDBX_SUCCESS))
+      goto fail;
+
     /* Append our free list to parent's */
     rc = mdbx_pnl_append_list(&parent->mt_befree_pages, txn->mt_befree_pages);
     if (unlikely(rc != MDBX_SUCCESS))
@@ -3585,6 +4583,8 @@ int mdbx_txn_commit(MDBX_txn *txn) {
 
     dst = parent->mt_rw_dirtylist;
     src = txn->mt_rw_dirtylist;
+    mdbx_dpl_sort(dst);
+    mdbx_dpl_sort(src);
     /* Remove anything in our dirty list from parent's spill list */
     if ((pspill = parent->mt_spill_pages) && (ps_len = pspill[0])) {
       x = y = ps_len;
@@ -3628,20 +4628,16 @@ int mdbx_txn_commit(MDBX_txn *txn) {
     /* Find len = length of merging our dirty list with parent's */
     x = dst[0].mid;
     dst[0].mid = 0; /* simplify loops */
-    if (parent->mt_parent) {
-      len = x + src[0].mid;
-      y = mdbx_mid2l_search(src, dst[x].mid + 1) - 1;
-      for (i = x; y && i; y--) {
-        pgno_t yp = src[y].mid;
-        while (yp < dst[i].mid)
-          i--;
-        if (yp == dst[i].mid) {
-          i--;
-          len--;
-        }
+    len = x + src[0].mid;
+    y = mdbx_mid2l_search(src, dst[x].mid + 1) - 1;
+    for (i = x; y && i; y--) {
+      pgno_t yp = src[y].mid;
+      while (yp < dst[i].mid)
+        i--;
+      if (yp == dst[i].mid) {
+        i--;
+        len--;
       }
-    } else { /* Simplify the above for single-ancestor case */
-      len = MDBX_PNL_UM_MAX - txn->mt_dirtyroom;
     }
     /* Merge our dirty list with parent's */
     y = src[0].mid;
@@ -3654,7 +4650,8 @@ int mdbx_txn_commit(MDBX_txn *txn) {
     }
     mdbx_tassert(txn, i == x);
     dst[0].mid = len;
-    free(txn->mt_rw_dirtylist);
+    MDBX_DPL_SORTED(dst) = len;
+    mdbx_dpl_free(txn->mt_rw_dirtylist);
     parent->mt_dirtyroom = txn->mt_dirtyroom;
     if (txn->mt_spill_pages) {
       if (parent->mt_spill_pages) {
@@ -3733,12 +4730,17 @@ int mdbx_txn_commit(MDBX_txn *txn) {
   if (mdbx_audit_enabled())
     mdbx_audit(txn);
 
-  rc = mdbx_page_flush(txn, 0);
+  /* the data-pages will be synced by mdbx_sync_locked() anyway,
+   * but could be synced together with writing. */
+  rc = mdbx_page_flush(
+      txn, 0, ((env->me_flags | txn->mt_flags) & MDBX_NOSYNC) == 0);
   if (likely(rc == MDBX_SUCCESS)) {
     MDBX_meta meta, *head = mdbx_meta_head(env);
 
-    meta.mm_magic_and_version = head->mm_magic_and_version;
-    meta.mm_extra_flags = head->mm_extra_flags;
+    meta.mm_extra_flags =
+        (uint16_t)(head->mm_extra_flags | mdbx_txn_features(txn));
+    meta.mm_magic_and_version =
+        meta.mm_extra_flags ? MDBX_DATA_MAGIC_EXTRA : MDBX_DATA_MAGIC;
     meta.mm_validator_id = head->mm_validator_id;
     meta.mm_extra_pagehdr = head->mm_extra_pagehdr;
 
@@ -3766,6 +4768,39 @@ fail:
   return rc;
 }
 
+int mdbx_txn_commit_async(MDBX_txn *txn, uint64_t *txnid) {
+  if (unlikely(!txn || !txnid))
+    return MDBX_EINVAL;
+
+  if (unlikely(txn->mt_signature != MDBX_MT_SIGNATURE))
+    return MDBX_EBADSIGN;
+
+  if (unlikely(txn->mt_owner != mdbx_thread_self()))
+    return MDBX_THREAD_MISMATCH;
+
+  if (unlikely(txn->mt_parent || (txn->mt_flags & MDBX_TXN_RDONLY)))
+    return MDBX_EINVAL;
+
+  /* the commit writes a weak meta, which the syncer makes steady later. */
+  MDBX_env *env = txn->mt_env;
+  const txnid_t wanna = txn->mt_txnid;
+  txn->mt_flags |= MDBX_TXN_NOSYNC;
+  int rc = mdbx_txn_commit(txn);
+  if (unlikely(rc != MDBX_SUCCESS))
+    return rc;
+
+  /* an empty commit doesn't write a meta, so the caller should wait
+   * for the previous one. Also a concurrent writer may already reuse this
+   * txnid, but then waiting for it is just more conservative. */
+  *txnid = (mdbx_meta_txnid_fluid(env, mdbx_meta_head(env)) >= wanna)
+               ? wanna
+               : wanna - 1;
+  if (mdbx_env_is_durable(env, *txnid))
+    return MDBX_SUCCESS;
+
+  return mdbx_syncer_request(env, *txnid);
+}
+
 /* Read the environment parameters of a DB environment
  * before mapping it into memory. */
 static int __cold mdbx_read_header(MDBX_env *env, MDBX_meta *meta) {
@@ -3828,7 +4863,8 @@ static int __cold mdbx_read_header(MDBX_env *env, MDBX_meta *meta) {
       return MDBX_INVALID;
     }
 
-    if (page.mp_meta.mm_magic_and_version != MDBX_DATA_MAGIC) {
+    if (page.mp_meta.mm_magic_and_version != MDBX_DATA_MAGIC &&
+        page.mp_meta.mm_magic_and_version != MDBX_DATA_MAGIC_EXTRA) {
       mdbx_error("meta[%u] has invalid magic/version MDBX_DEVEL=%d",
                  meta_number, MDBX_DEVEL);
       return ((page.mp_meta.mm_magic_and_version >> 8) != MDBX_MAGIC)
@@ -3836,6 +4872,12 @@ static int __cold mdbx_read_header(MDBX_env *env, MDBX_meta *meta) {
                  : MDBX_VERSION_MISMATCH;
     }
 
+    if (page.mp_meta.mm_extra_flags & ~MDBX_META_FEATURES) {
+      mdbx_error("meta[%u] has unknown features 0x%x", meta_number,
+                 page.mp_meta.mm_extra_flags & ~MDBX_META_FEATURES);
+      return MDBX_VERSION_MISMATCH;
+    }
+
     if (page.mp_meta.mm_txnid_a != page.mp_meta.mm_txnid_b) {
       mdbx_warning("meta[%u] not completely updated, skip it", meta_number);
       continue;
@@ -4072,7 +5114,15 @@ static int mdbx_sync_locked(MDBX_env *env, unsigned flags,
   mdbx_assert(env,
               pending < METAPAGE(env, 0) || pending > METAPAGE(env, NUM_METAS));
   mdbx_assert(env, (env->me_flags & (MDBX_RDONLY | MDBX_FATAL_ERROR)) == 0);
+#if MDBX_USE_IOURING
+  /* the io_uring backend of mdbx_page_flush() syncs the data pages
+   * together with the write, so nothing could be pending for a new txn. */
+  mdbx_assert(env, !META_IS_STEADY(head) || env->me_sync_pending != 0 ||
+                       mdbx_meta_txnid_stable(env, head) !=
+                           pending->mm_txnid_a);
+#else
   mdbx_assert(env, !META_IS_STEADY(head) || env->me_sync_pending != 0);
+#endif /* MDBX_USE_IOURING */
   mdbx_assert(env, pending->mm_geo.next <= pending->mm_geo.now);
 
   const size_t usedbytes = pgno_align2os_bytes(env, pending->mm_geo.next);
@@ -4094,13 +5144,13 @@ static int mdbx_sync_locked(MDBX_env *env, unsigned flags,
           if (unlikely(rc != MDBX_SUCCESS))
             goto fail;
         }
-        env->me_sync_pending = 0;
+        mdbx_sync_pending_reset(env);
       }
     } else {
       rc = mdbx_filesync(env->me_fd, pending->mm_geo.next > steady->mm_geo.now);
       if (unlikely(rc != MDBX_SUCCESS))
         goto fail;
-      env->me_sync_pending = 0;
+      mdbx_sync_pending_reset(env);
     }
   }
 
@@ -4209,6 +5259,8 @@ static int mdbx_sync_locked(MDBX_env *env, unsigned flags,
 #endif
 
       /* LY: update info */
+      target->mm_magic_and_version = pending->mm_magic_and_version;
+      target->mm_extra_flags = pending->mm_extra_flags;
       target->mm_geo = pending->mm_geo;
       target->mm_dbs[FREE_DBI] = pending->mm_dbs[FREE_DBI];
       target->mm_dbs[MAIN_DBI] = pending->mm_dbs[MAIN_DBI];
@@ -4351,13 +5403,19 @@ static void __cold mdbx_setup_pagesize(MDBX_env *env, const size_t pagesize) {
 }
 
 int __cold mdbx_env_create(MDBX_env **penv) {
+  /* MDBX_env is packed, but pthread objects must be aligned */
+  STATIC_ASSERT(offsetof(MDBX_env, me_dbi_lock) % 8 == 0);
+  STATIC_ASSERT(offsetof(MDBX_env, me_syncer_cond) % 8 == 0);
+  STATIC_ASSERT(offsetof(MDBX_env, me_durable_cond) % 8 == 0);
   MDBX_env *env = calloc(1, sizeof(MDBX_env));
   if (!env)
     return MDBX_ENOMEM;
 
   env->me_maxreaders = DEFAULT_READERS;
+  env->me_maxdirty = MDBX_PNL_UM_MAX;
   env->me_maxdbs = env->me_numdbs = CORE_DBS;
   env->me_fd = INVALID_HANDLE_VALUE;
+  env->me_dfd = INVALID_HANDLE_VALUE;
   env->me_lfd = INVALID_HANDLE_VALUE;
   env->me_pid = mdbx_getpid();
 
@@ -4375,6 +5433,19 @@ int __cold mdbx_env_create(MDBX_env **penv) {
   if (unlikely(rc != MDBX_SUCCESS))
     goto bailout;
 
+  rc = mdbx_condmutex_init(&env->me_syncer_cond);
+  if (unlikely(rc != MDBX_SUCCESS)) {
+    mdbx_fastmutex_destroy(&env->me_dbi_lock);
+    goto bailout;
+  }
+
+  rc = mdbx_condmutex_init(&env->me_durable_cond);
+  if (unlikely(rc != MDBX_SUCCESS)) {
+    mdbx_condmutex_destroy(&env->me_syncer_cond);
+    mdbx_fastmutex_destroy(&env->me_dbi_lock);
+    goto bailout;
+  }
+
   VALGRIND_CREATE_MEMPOOL(env, 0, 0);
   env->me_signature = MDBX_ME_SIGNATURE;
   *penv = env;
@@ -4713,6 +5784,36 @@ int __cold mdbx_env_get_maxreaders(MDBX_env *env, unsigned *readers) {
   return MDBX_SUCCESS;
 }
 
+int __cold mdbx_env_set_maxdirty(MDBX_env *env, size_t pages) {
+  if (unlikely(!env))
+    return MDBX_EINVAL;
+
+  if (unlikely(env->me_signature != MDBX_ME_SIGNATURE))
+    return MDBX_EBADSIGN;
+
+  if (pages == 0)
+    pages = MDBX_PNL_UM_MAX;
+  else if (unlikely(pages < MDBX_DPL_INITIAL))
+    return MDBX_EINVAL;
+  /* room for the unsorted tail to be merged should be addressable */
+  if (pages > UINT_MAX / 4)
+    pages = UINT_MAX / 4;
+
+  env->me_maxdirty = pages;
+  return MDBX_SUCCESS;
+}
+
+int __cold mdbx_env_get_maxdirty(MDBX_env *env, size_t *pages) {
+  if (!env || !pages)
+    return MDBX_EINVAL;
+
+  if (unlikely(env->me_signature != MDBX_ME_SIGNATURE))
+    return MDBX_EBADSIGN;
+
+  *pages = env->me_maxdirty;
+  return MDBX_SUCCESS;
+}
+
 /* Further setup required for opening an MDBX environment */
 static int __cold mdbx_setup_dxb(MDBX_env *env, int lck_rc) {
   MDBX_meta meta;
@@ -5140,15 +6241,44 @@ static int __cold mdbx_setup_lck(MDBX_env *env, char *lck_pathname,
  * environment and re-opening it with the new flags. */
 #define CHANGEABLE                                                             \
   (MDBX_NOSYNC | MDBX_NOMETASYNC | MDBX_MAPASYNC | MDBX_NOMEMINIT |            \
-   MDBX_COALESCE | MDBX_PAGEPERTURB)
+   MDBX_COALESCE | MDBX_PAGEPERTURB | MDBX_GROUPCOMMIT | MDBX_WRITEBACK)
 #define CHANGELESS                                                             \
   (MDBX_NOSUBDIR | MDBX_RDONLY | MDBX_WRITEMAP | MDBX_NOTLS | MDBX_NORDAHEAD | \
-   MDBX_LIFORECLAIM)
+   MDBX_LIFORECLAIM | MDBX_DIRECTWRITE)
 
 #if VALID_FLAGS & PERSISTENT_FLAGS & (CHANGEABLE | CHANGELESS)
 #error "Persistent DB flags & env flags overlap, but both go in mm_flags"
 #endif
 
+/* Opens the second descriptor of the data file for MDBX_DIRECTWRITE.
+ * Returns non-zero if direct I/O is not applicable or not supported. */
+static int __cold mdbx_setup_directwrite(MDBX_env *env, const char *pathname) {
+  if ((env->me_flags & MDBX_WRITEMAP) || env->me_psize < env->me_os_psize)
+    return MDBX_RESULT_TRUE;
+
+#if defined(F_NOCACHE) || (defined(O_DIRECT) && defined(F_GETFL))
+  int rc = mdbx_openfile(pathname, O_RDWR, 0, &env->me_dfd);
+  if (unlikely(rc != MDBX_SUCCESS))
+    return rc;
+#ifdef F_NOCACHE /* __APPLE__ */
+  if (fcntl(env->me_dfd, F_NOCACHE, 1) != -1)
+    return MDBX_SUCCESS;
+#else
+  /* fails if the filesystem doesn't support O_DIRECT */
+  rc = fcntl(env->me_dfd, F_GETFL);
+  if (rc != -1 && fcntl(env->me_dfd, F_SETFL, rc | O_DIRECT) != -1)
+    return MDBX_SUCCESS;
+#endif
+  rc = errno;
+  (void)mdbx_closefile(env->me_dfd);
+  env->me_dfd = INVALID_HANDLE_VALUE;
+  return rc;
+#else
+  (void)pathname;
+  return MDBX_ENOSYS;
+#endif
+}
+
 int __cold mdbx_env_open_ex(MDBX_env *env, const char *path, unsigned flags,
                             mode_t mode, int *exclusive) {
   if (unlikely(!env || !path))
@@ -5188,11 +6318,18 @@ int __cold mdbx_env_open_ex(MDBX_env *env, const char *path, unsigned flags,
     /* LY: silently ignore irrelevant flags when
      * we're only getting read access */
     flags &= ~(MDBX_WRITEMAP | MDBX_MAPASYNC | MDBX_NOSYNC | MDBX_NOMETASYNC |
-               MDBX_COALESCE | MDBX_LIFORECLAIM | MDBX_NOMEMINIT);
+               MDBX_COALESCE | MDBX_LIFORECLAIM | MDBX_NOMEMINIT |
+               MDBX_DIRECTWRITE | MDBX_WRITEBACK);
   } else {
     if (!((env->me_free_pgs = mdbx_pnl_alloc(MDBX_PNL_UM_MAX)) &&
-          (env->me_dirtylist = calloc(MDBX_PNL_UM_SIZE, sizeof(MDBX_ID2)))))
+          (env->me_dirtylist = mdbx_dpl_alloc(MDBX_DPL_INITIAL))))
       rc = MDBX_ENOMEM;
+#if MDBX_USE_IOURING
+    /* silently fallback to pwritev() if io_uring is unavailable */
+    if ((flags & MDBX_WRITEMAP) == 0 &&
+        mdbx_ioring_create(&env->me_ioring, 256) != MDBX_SUCCESS)
+      env->me_ioring = NULL;
+#endif
   }
   env->me_flags = flags |= MDBX_ENV_ACTIVE;
   if (rc)
@@ -5207,6 +6344,7 @@ int __cold mdbx_env_open_ex(MDBX_env *env, const char *path, unsigned flags,
     goto bailout;
   }
   env->me_dbxs[FREE_DBI].md_cmp = mdbx_cmp_int_ai; /* aligned MDBX_INTEGERKEY */
+  env->me_dbxs[FREE_DBI].md_kind = MDBX_CMP_INT;
 
   int oflags;
   if (F_ISSET(flags, MDBX_RDONLY))
@@ -5230,6 +6368,10 @@ int __cold mdbx_env_open_ex(MDBX_env *env, const char *path, unsigned flags,
     goto bailout;
   }
 
+  if ((env->me_flags & MDBX_DIRECTWRITE) &&
+      mdbx_setup_directwrite(env, dxb_pathname) != MDBX_SUCCESS)
+    env->me_flags &= ~MDBX_DIRECTWRITE;
+
   mdbx_debug("opened dbenv %p", (void *)env);
   const unsigned mode_flags =
       MDBX_WRITEMAP | MDBX_NOSYNC | MDBX_NOMETASYNC | MDBX_MAPASYNC;
@@ -5343,7 +6485,16 @@ static void __cold mdbx_env_close0(MDBX_env *env) {
   free(env->me_dbiseqs);
   free(env->me_dbflags);
   free(env->me_path);
-  free(env->me_dirtylist);
+  mdbx_dpl_free(env->me_dirtylist);
+#if MDBX_USE_IOURING
+  if (env->me_ioring) {
+    mdbx_ioring_destroy(env->me_ioring);
+    env->me_ioring = NULL;
+  }
+  free(env->me_ioring_iov);
+  env->me_ioring_iov = NULL;
+  env->me_ioring_iov_size = 0;
+#endif
   if (env->me_txn0) {
     mdbx_txl_free(env->me_txn0->mt_lifo_reclaimed);
     free(env->me_txn0);
@@ -5366,6 +6517,10 @@ static void __cold mdbx_env_close0(MDBX_env *env) {
     (void)mdbx_closefile(env->me_fd);
     env->me_fd = INVALID_HANDLE_VALUE;
   }
+  if (env->me_dfd != INVALID_HANDLE_VALUE) {
+    (void)mdbx_closefile(env->me_dfd);
+    env->me_dfd = INVALID_HANDLE_VALUE;
+  }
 
   if (env->me_lck)
     mdbx_munmap(&env->me_lck_mmap);
@@ -5388,6 +6543,7 @@ int __cold mdbx_env_close_ex(MDBX_env *env, int dont_sync) {
   if (unlikely(env->me_signature != MDBX_ME_SIGNATURE))
     return MDBX_EBADSIGN;
 
+  mdbx_syncer_stop(env);
   if (!dont_sync && !(env->me_flags & MDBX_RDONLY))
     rc = mdbx_env_sync(env, true);
 
@@ -5396,11 +6552,16 @@ int __cold mdbx_env_close_ex(MDBX_env *env, int dont_sync) {
     ASAN_UNPOISON_MEMORY_REGION(&dp->mp_next, sizeof(dp->mp_next));
     VALGRIND_MAKE_MEM_DEFINED(&dp->mp_next, sizeof(dp->mp_next));
     env->me_dpages = dp->mp_next;
-    free(dp);
+    if (env->me_flags & MDBX_DIRECTWRITE)
+      mdbx_memalign_free(dp);
+    else
+      free(dp);
   }
 
   mdbx_env_close0(env);
   mdbx_ensure(env, mdbx_fastmutex_destroy(&env->me_dbi_lock) == MDBX_SUCCESS);
+  mdbx_condmutex_destroy(&env->me_durable_cond);
+  mdbx_condmutex_destroy(&env->me_syncer_cond);
   env->me_signature = 0;
   free(env);
 
@@ -5545,32 +6706,320 @@ static int __hot mdbx_cmp_memnr(const MDBX_val *a, const MDBX_val *b) {
   return mdbx_cmp2int(a->iov_len, b->iov_len);
 }
 
-/* Search for key within a page, using binary search.
- * Returns the smallest entry larger or equal to the key.
- * If exactp is non-null, stores whether the found entry was an exact match
- * in *exactp (1 or 0).
- * Updates the cursor index with the index of the found entry.
- * If no entry larger or equal to the key is found, returns NULL. */
-static MDBX_node *__hot mdbx_node_search(MDBX_cursor *mc, MDBX_val *key,
-                                         int *exactp) {
-  unsigned i = 0, nkeys;
-  int low, high;
-  int rc = 0;
-  MDBX_page *mp = mc->mc_pg[mc->mc_top];
-  MDBX_node *node = NULL;
-  MDBX_val nodekey;
-  MDBX_cmp_func *cmp;
-  DKBUF;
+/*----------------------------------------------------------------------------*/
+/* search kernels for fixed-width (4 or 8 bytes) unsigned integer keys,
+ * which are compared natively by mdbx_cmp_int_ai/a2/ua.
+ *
+ * A kernel returns the lower-bound index within a dense array of keys, i.e.
+ * the keys of LEAF2-page for MDBX_INTEGERDUP|MDBX_DUPFIXED. The binary search
+ * narrows down to a block of MDBX_SEARCH_BLOCK keys, which then are compared
+ * at once (via SSE4.2 or AVX2 if available, otherwise scalar). */
+
+typedef unsigned mdbx_search_fixed_func(const uint8_t *base, unsigned n,
+                                        uint64_t key);
+
+static __inline uint32_t mdbx_peek_u32(const void *ptr) {
+  uint32_t value;
+  memcpy(&value, ptr, sizeof(value));
+  return value;
+}
+
+static __inline uint64_t mdbx_peek_u64(const void *ptr) {
+  uint64_t value;
+  memcpy(&value, ptr, sizeof(value));
+  return value;
+}
+
+/* Returns the number of keys which are less than the given one within a block
+ * of MDBX_SEARCH_BLOCK keys. Since the keys are sorted, this is also the
+ * lower-bound index within the block. */
+static __inline unsigned mdbx_block_lt_u32_scalar(const uint8_t *block,
+                                                  uint64_t key) {
+  unsigned count = 0;
+  for (unsigned i = 0; i < MDBX_SEARCH_BLOCK; ++i)
+    count += mdbx_peek_u32(block + i * sizeof(uint32_t)) < key;
+  return count;
+}
+
+static __inline unsigned mdbx_block_lt_u64_scalar(const uint8_t *block,
+                                                  uint64_t key) {
+  unsigned count = 0;
+  for (unsigned i = 0; i < MDBX_SEARCH_BLOCK; ++i)
+    count += mdbx_peek_u64(block + i * sizeof(uint64_t)) < key;
+  return count;
+}
+
+/* Branchless binary search while more than a block remains. The answer is
+ * always within [low, low + n], all keys before low are less than the given,
+ * and all keys since low + n are not less. Therefore the final block could be
+ * shifted back to be entirely inside the array. */
+#define MDBX_SEARCH_FIXED(NAME, ATTRS, PEEK, WIDTH, BLOCK_LT)                  \
+  static unsigned ATTRS NAME(const uint8_t *base, unsigned n, uint64_t key) {  \
+    const unsigned total = n;                                                  \
+    unsigned low = 0;                                                          \
+    while (n > MDBX_SEARCH_BLOCK) {                                            \
+      const unsigned half = n >> 1;                                            \
+      low = (PEEK(base + (low + half) * WIDTH) < key) ? low + half : low;      \
+      n -= half;                                                               \
+    }                                                                          \
+    if (unlikely(total < MDBX_SEARCH_BLOCK)) {                                 \
+      while (n && PEEK(base + low * WIDTH) < key) {                            \
+        low += 1;                                                              \
+        n -= 1;                                                                \
+      }                                                                        \
+      return low;                                                              \
+    }                                                                          \
+    if (low > total - MDBX_SEARCH_BLOCK)                                       \
+      low = total - MDBX_SEARCH_BLOCK;                                         \
+    return low + BLOCK_LT(base + low * WIDTH, key);                            \
+  }
+
+MDBX_SEARCH_FIXED(mdbx_search_u32_scalar, __hot, mdbx_peek_u32, 4,
+                  mdbx_block_lt_u32_scalar)
+MDBX_SEARCH_FIXED(mdbx_search_u64_scalar, __hot, mdbx_peek_u64, 8,
+                  mdbx_block_lt_u64_scalar)
+
+#if MDBX_SEARCH_X86
+/* there are no unsigned comparisons in SSE/AVX, so both operands are
+ * biased by the sign bit before signed compare. */
+
+static __inline MDBX_TARGET_SSE42 unsigned
+mdbx_block_lt_u32_sse42(const uint8_t *block, uint64_t key) {
+  const __m128i bias = _mm_set1_epi32(INT32_MIN);
+  const __m128i k = _mm_xor_si128(_mm_set1_epi32((int32_t)key), bias);
+  const __m128i a =
+      _mm_xor_si128(_mm_loadu_si128((const __m128i *)block), bias);
+  const __m128i b =
+      _mm_xor_si128(_mm_loadu_si128((const __m128i *)block + 1), bias);
+  const unsigned mask =
+      _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(k, a))) |
+      _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(k, b))) << 4;
+  return __builtin_popcount(mask);
+}
+
+static __inline MDBX_TARGET_SSE42 unsigned
+mdbx_block_lt_u64_sse42(const uint8_t *block, uint64_t key) {
+  const __m128i bias = _mm_set1_epi64x(INT64_MIN);
+  const __m128i k = _mm_xor_si128(_mm_set1_epi64x((int64_t)key), bias);
+  unsigned mask = 0;
+  for (unsigned i = 0; i < MDBX_SEARCH_BLOCK / 2; ++i) {
+    const __m128i v =
+        _mm_xor_si128(_mm_loadu_si128((const __m128i *)block + i), bias);
+    mask |= _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(k, v))) << (i * 2);
+  }
+  return __builtin_popcount(mask);
+}
+
+static __inline MDBX_TARGET_AVX2 unsigned
+mdbx_block_lt_u32_avx2(const uint8_t *block, uint64_t key) {
+  const __m256i bias = _mm256_set1_epi32(INT32_MIN);
+  const __m256i k = _mm256_xor_si256(_mm256_set1_epi32((int32_t)key), bias);
+  const __m256i v =
+      _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)block), bias);
+  return __builtin_popcount(
+      _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(k, v))));
+}
+
+static __inline MDBX_TARGET_AVX2 unsigned
+mdbx_block_lt_u64_avx2(const uint8_t *block, uint64_t key) {
+  const __m256i bias = _mm256_set1_epi64x(INT64_MIN);
+  const __m256i k = _mm256_xor_si256(_mm256_set1_epi64x((int64_t)key), bias);
+  const __m256i a =
+      _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)block), bias);
+  const __m256i b =
+      _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)block + 1), bias);
+  const unsigned mask =
+      _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(k, a))) |
+      _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(k, b))) << 4;
+  return __builtin_popcount(mask);
+}
+
+MDBX_SEARCH_FIXED(mdbx_search_u32_sse42, __hot MDBX_TARGET_SSE42,
+                  mdbx_peek_u32, 4, mdbx_block_lt_u32_sse42)
+MDBX_SEARCH_FIXED(mdbx_search_u64_sse42, __hot MDBX_TARGET_SSE42,
+                  mdbx_peek_u64, 8, mdbx_block_lt_u64_sse42)
+MDBX_SEARCH_FIXED(mdbx_search_u32_avx2, __hot MDBX_TARGET_AVX2, mdbx_peek_u32,
+                  4, mdbx_block_lt_u32_avx2)
+MDBX_SEARCH_FIXED(mdbx_search_u64_avx2, __hot MDBX_TARGET_AVX2, mdbx_peek_u64,
+                  8, mdbx_block_lt_u64_avx2)
+#endif /* MDBX_SEARCH_X86 */
+
+static unsigned mdbx_search_u32_resolve(const uint8_t *base, unsigned n,
+                                        uint64_t key);
+static unsigned mdbx_search_u64_resolve(const uint8_t *base, unsigned n,
+                                        uint64_t key);
+
+/* resolved on first use, the race is harmless
+ * since any thread stores the same values. */
+static mdbx_search_fixed_func *mdbx_search_u32 = mdbx_search_u32_resolve;
+static mdbx_search_fixed_func *mdbx_search_u64 = mdbx_search_u64_resolve;
+
+static void __cold mdbx_search_fixed_setup(void) {
+  mdbx_search_fixed_func *u32 = mdbx_search_u32_scalar;
+  mdbx_search_fixed_func *u64 = mdbx_search_u64_scalar;
+#if MDBX_SEARCH_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("popcnt")) {
+    if (__builtin_cpu_supports("avx2")) {
+      u32 = mdbx_search_u32_avx2;
+      u64 = mdbx_search_u64_avx2;
+    } else if (__builtin_cpu_supports("sse4.2")) {
+      u32 = mdbx_search_u32_sse42;
+      u64 = mdbx_search_u64_sse42;
+    }
+  }
+#endif /* MDBX_SEARCH_X86 */
+  mdbx_search_u32 = u32;
+  mdbx_search_u64 = u64;
+}
+
+static unsigned __cold mdbx_search_u32_resolve(const uint8_t *base, unsigned n,
+                                               uint64_t key) {
+  mdbx_search_fixed_setup();
+  return mdbx_search_u32(base, n, key);
+}
+
+static unsigned __cold mdbx_search_u64_resolve(const uint8_t *base, unsigned n,
+                                               uint64_t key) {
+  mdbx_search_fixed_setup();
+  return mdbx_search_u64(base, n, key);
+}
+
+/* Same as above, but for INTEGERKEY nodes, which are scattered over the page,
+ * so there are nothing to vectorize. Nevertheless, this avoids an indirect
+ * call of comparator per probe. */
+#define MDBX_SEARCH_NODES(NAME, PEEK)                                          \
+  static __hot unsigned NAME(MDBX_page *mp, unsigned low, unsigned n,          \
+                             uint64_t key) {                                   \
+    if (unlikely(n == 0))                                                      \
+      return low;                                                              \
+    while (n > 1) {                                                            \
+      const unsigned half = n >> 1;                                            \
+      low = (PEEK(NODEKEY(NODEPTR(mp, low + half))) < key) ? low + half : low; \
+      n -= half;                                                               \
+    }                                                                          \
+    return low + (PEEK(NODEKEY(NODEPTR(mp, low))) < key);                      \
+  }
 
-  nkeys = NUMKEYS(mp);
+MDBX_SEARCH_NODES(mdbx_search_nodes_u32, mdbx_peek_u32)
+MDBX_SEARCH_NODES(mdbx_search_nodes_u64, mdbx_peek_u64)
 
-  mdbx_debug("searching %u keys in %s %spage %" PRIaPGNO "", nkeys,
-             IS_LEAF(mp) ? "leaf" : "branch", IS_SUBP(mp) ? "sub-" : "",
-             mp->mp_pgno);
+/* Searches for integer key within the page, like mdbx_node_search() does.
+ * Returns the lower-bound index and sets *exact. */
+static __inline unsigned mdbx_node_search_int(const MDBX_cursor *mc,
+                                              MDBX_page *mp,
+                                              const MDBX_val *key, int *exact) {
+  const unsigned nkeys = NUMKEYS(mp);
+  const size_t len = key->iov_len;
+  unsigned i;
+  if (IS_LEAF2(mp)) {
+    mdbx_cassert(mc, mc->mc_db->md_xsize == len);
+    const uint8_t *base = (const uint8_t *)LEAF2KEY(mp, 0, len);
+    i = (len == 4) ? mdbx_search_u32(base, nkeys, mdbx_peek_u32(key->iov_base))
+                   : mdbx_search_u64(base, nkeys, mdbx_peek_u64(key->iov_base));
+    *exact = i < nkeys && memcmp(base + i * len, key->iov_base, len) == 0;
+  } else {
+    const unsigned low = IS_LEAF(mp) ? 0 : 1;
+    const unsigned n = (nkeys > low) ? nkeys - low : 0;
+    i = (len == 4) ? mdbx_search_nodes_u32(mp, low, n,
+                                           mdbx_peek_u32(key->iov_base))
+                   : mdbx_search_nodes_u64(mp, low, n,
+                                           mdbx_peek_u64(key->iov_base));
+    if (i < nkeys) {
+      const MDBX_node *node = NODEPTR(mp, i);
+      mdbx_cassert(mc, NODEKSZ(node) == len);
+      *exact = memcmp(NODEKEY(node), key->iov_base, len) == 0;
+    } else
+      *exact = 0;
+  }
+  (void)mc;
+  return i;
+}
+
+/* Returns the kind of comparator, i.e. MDBX_CMP_CUSTOM for any
+ * except the built-in ones. */
+static uint8_t mdbx_cmp_kind(MDBX_cmp_func *cmp) {
+  if (cmp == mdbx_cmp_memn)
+    return MDBX_CMP_MEMN;
+  if (cmp == mdbx_cmp_memnr)
+    return MDBX_CMP_MEMNR;
+  if (cmp == mdbx_cmp_int_ai || cmp == mdbx_cmp_int_a2 ||
+      cmp == mdbx_cmp_int_ua)
+    return MDBX_CMP_INT;
+  return MDBX_CMP_CUSTOM;
+}
+
+/* Compares two items by the comparator of the given kind. Being inlined with
+ * the constant kind, this becomes a direct (and inlineable) call of the
+ * built-in comparator instead of the indirect one. */
+static __alwaysinline int mdbx_cmp_kind_inline(const unsigned kind,
+                                               MDBX_cmp_func *cmp,
+                                               const MDBX_val *a,
+                                               const MDBX_val *b) {
+  switch (kind) {
+  case MDBX_CMP_MEMN:
+    return mdbx_cmp_memn(a, b);
+  case MDBX_CMP_MEMNR:
+    return mdbx_cmp_memnr(a, b);
+  case MDBX_CMP_INT:
+    if (likely(a->iov_len == b->iov_len)) {
+      if (a->iov_len == 4)
+        return mdbx_cmp2int(mdbx_peek_u32(a->iov_base),
+                            mdbx_peek_u32(b->iov_base));
+      if (a->iov_len == 8)
+        return mdbx_cmp2int(mdbx_peek_u64(a->iov_base),
+                            mdbx_peek_u64(b->iov_base));
+    }
+  /* fallthrough */
+  default:
+    return cmp(a, b);
+  }
+}
+
+/* Compares two keys of the cursor's database. */
+static __inline int mdbx_cursor_cmp(const MDBX_cursor *mc, const MDBX_val *a,
+                                    const MDBX_val *b) {
+  return mdbx_cmp_kind_inline(mc->mc_dbx->md_kind, mc->mc_dbx->md_cmp, a, b);
+}
 
-  low = IS_LEAF(mp) ? 0 : 1;
-  high = nkeys - 1;
-  cmp = mc->mc_dbx->md_cmp;
+/* Nodes are scattered across the page, so each probe of the binary search
+ * within non-LEAF2 page is mostly a cache miss. To hide the latency the nodes
+ * of both possible next probes are prefetched before comparing the current. */
+#ifndef MDBX_SEARCH_PREFETCH
+#define MDBX_SEARCH_PREFETCH 1
+#endif /* MDBX_SEARCH_PREFETCH */
+
+static __alwaysinline void mdbx_node_search_prefetch(MDBX_page *mp, int low,
+                                                     int i, int high) {
+#if MDBX_SEARCH_PREFETCH
+  if (low < i)
+    __prefetch(NODEPTR(mp, (low + i - 1) >> 1));
+  if (i < high)
+    __prefetch(NODEPTR(mp, (i + 1 + high) >> 1));
+#else
+  (void)mp;
+  (void)low;
+  (void)i;
+  (void)high;
+#endif /* MDBX_SEARCH_PREFETCH */
+}
+
+/* The binary search within a page, being instantiated for each kind of
+ * comparator by mdbx_node_search().
+ * Returns index of the smallest entry larger or equal to the key,
+ * and sets *exact whether the found entry was an exact match. */
+static __alwaysinline unsigned mdbx_node_search_kind(MDBX_cursor *mc,
+                                                     MDBX_page *mp,
+                                                     MDBX_val *key, int *exact,
+                                                     const unsigned kind) {
+  const unsigned nkeys = NUMKEYS(mp);
+  int low = IS_LEAF(mp) ? 0 : 1;
+  int high = nkeys - 1;
+  unsigned i = 0;
+  int rc = 0;
+  MDBX_val nodekey;
+  MDBX_cmp_func *cmp = mc->mc_dbx->md_cmp;
+  DKBUF;
 
   /* Branch pages have no data, so if using integer keys,
    * alignment is guaranteed. Use faster mdbx_cmp_int_ai.
@@ -5580,11 +7029,10 @@ static MDBX_node *__hot mdbx_node_search(MDBX_cursor *mc, MDBX_val *key,
 
   if (IS_LEAF2(mp)) {
     nodekey.iov_len = mc->mc_db->md_xsize;
-    node = NODEPTR(mp, 0); /* fake */
     while (low <= high) {
       i = (low + high) >> 1;
       nodekey.iov_base = LEAF2KEY(mp, i, nodekey.iov_len);
-      rc = cmp(key, &nodekey);
+      rc = mdbx_cmp_kind_inline(kind, cmp, key, &nodekey);
       mdbx_debug("found leaf index %u [%s], rc = %i", i, DKEY(&nodekey), rc);
       if (rc == 0)
         break;
@@ -5596,12 +7044,13 @@ static MDBX_node *__hot mdbx_node_search(MDBX_cursor *mc, MDBX_val *key,
   } else {
     while (low <= high) {
       i = (low + high) >> 1;
+      mdbx_node_search_prefetch(mp, low, i, high);
 
-      node = NODEPTR(mp, i);
+      MDBX_node *node = NODEPTR(mp, i);
       nodekey.iov_len = NODEKSZ(node);
       nodekey.iov_base = NODEKEY(node);
 
-      rc = cmp(key, &nodekey);
+      rc = mdbx_cmp_kind_inline(kind, cmp, key, &nodekey);
       if (IS_LEAF(mp))
         mdbx_debug("found leaf index %u [%s], rc = %i", i, DKEY(&nodekey), rc);
       else
@@ -5616,36 +7065,347 @@ static MDBX_node *__hot mdbx_node_search(MDBX_cursor *mc, MDBX_val *key,
     }
   }
 
+  *exact = (rc == 0 && nkeys > 0);
   if (rc > 0) /* Found entry is less than the key. */
     i++;      /* Skip to get the smallest entry larger than key. */
+  return i;
+}
+
+/* Compares two keys like mdbx_cmp_memn(), but skips the first bytes which
+ * are known to be equal, and returns the length of common prefix via *lcp. */
+static __alwaysinline int mdbx_cmp_memn_lcp(const MDBX_val *a,
+                                            const MDBX_val *b, size_t skip,
+                                            size_t *lcp) {
+  const uint8_t *pa = (const uint8_t *)a->iov_base;
+  const uint8_t *pb = (const uint8_t *)b->iov_base;
+  const size_t shortest = (a->iov_len < b->iov_len) ? a->iov_len : b->iov_len;
+  size_t i = skip;
+#if (defined(__GNUC__) || defined(__clang__)) &&                               \
+    __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  while (i + sizeof(uint64_t) <= shortest) {
+    const uint64_t diff = mdbx_peek_u64(pa + i) ^ mdbx_peek_u64(pb + i);
+    if (diff) {
+      i += __builtin_ctzll(diff) >> 3;
+      *lcp = i;
+      return pa[i] - pb[i];
+    }
+    i += sizeof(uint64_t);
+  }
+#endif
+  while (i < shortest && pa[i] == pb[i])
+    ++i;
+  *lcp = i;
+  return (i < shortest) ? pa[i] - pb[i] : mdbx_cmp2int(a->iov_len, b->iov_len);
+}
+
+/* Since keys are sorted, all keys between two probed ones share with the
+ * search key the lesser of its common prefixes with these probes. So for
+ * mdbx_cmp_memn() each comparison skips that prefix and only the suffixes are
+ * compared, without touching any nodes besides the probed ones.
+ * Returns the same as mdbx_node_search_kind(). */
+static __inline unsigned mdbx_node_search_memn_prefixed(MDBX_page *mp,
+                                                        MDBX_val *key,
+                                                        int *exact) {
+  const unsigned nkeys = NUMKEYS(mp);
+  int low = IS_LEAF(mp) ? 0 : 1, high = nkeys - 1;
+  size_t low_lcp = 0, high_lcp = 0;
+  unsigned i = 0;
+  int rc = 0;
+  MDBX_val nodekey;
+  DKBUF;
 
-  if (exactp)
-    *exactp = (rc == 0 && nkeys > 0);
-  /* store the key index */
-  mdbx_cassert(mc, i <= UINT16_MAX);
-  mc->mc_ki[mc->mc_top] = (indx_t)i;
-  if (i >= nkeys)
-    /* There is no entry larger or equal to the key. */
-    return NULL;
-
-  /* nodeptr is fake for LEAF2 */
-  return IS_LEAF2(mp) ? node : NODEPTR(mp, i);
-}
-
-#if 0 /* unused for now */
-static void mdbx_cursor_adjust(MDBX_cursor *mc, func) {
-  MDBX_cursor *m2;
-
-  for (m2 = mc->mc_txn->mt_cursors[mc->mc_dbi]; m2; m2 = m2->mc_next) {
-    if (m2->mc_pg[m2->mc_top] == mc->mc_pg[mc->mc_top]) {
-      func(mc, m2);
-    }
+  while (low <= high) {
+    size_t lcp;
+    i = (low + high) >> 1;
+    mdbx_node_search_prefetch(mp, low, i, high);
+    const MDBX_node *node = NODEPTR(mp, i);
+    nodekey.iov_base = NODEKEY(node);
+    nodekey.iov_len = NODEKSZ(node);
+    rc = mdbx_cmp_memn_lcp(key, &nodekey,
+                           (low_lcp < high_lcp) ? low_lcp : high_lcp, &lcp);
+    mdbx_debug("found %s index %u [%s], rc = %i, lcp %" PRIuPTR,
+               IS_LEAF(mp) ? "leaf" : "branch", i, DKEY(&nodekey), rc, lcp);
+    if (rc == 0)
+      break;
+    if (rc > 0) {
+      low = i + 1;
+      low_lcp = lcp;
+    } else {
+      high = i - 1;
+      high_lcp = lcp;
+    }
+  }
+
+  *exact = (rc == 0 && nkeys > 0);
+  return (rc > 0) ? i + 1 : i;
+}
+
+/* Returns the fingerprint of a key for a P_FPRINT page, i.e. two bytes
+ * which follow the prefix common for the page, as a big-endian number.
+ * The missing bytes are zeroes, so the fingerprints are ordered the same
+ * way as keys by mdbx_cmp_memn(), and only equal ones are inconclusive. */
+static __inline unsigned mdbx_fprint(const MDBX_val *key, size_t prefix) {
+  const uint8_t *const bytes = (const uint8_t *)key->iov_base;
+  unsigned fprint = 0;
+  if (prefix < key->iov_len)
+    fprint = bytes[prefix] << 8;
+  if (prefix + 1 < key->iov_len)
+    fprint |= bytes[prefix + 1];
+  return fprint;
+}
+
+/* Recalculates the common prefix and all fingerprints of a P_FPRINT page.
+ * The key of the first node of a branch-page is implicit, so it is
+ * not taken into account. */
+static void mdbx_fprint_rebuild(MDBX_page *mp) {
+  const unsigned nkeys = NUMKEYS(mp);
+  const unsigned low = IS_LEAF(mp) ? 0 : 1;
+  size_t prefix = 0;
+  if (nkeys > low + 1) {
+    const MDBX_node *first = NODEPTR(mp, low);
+    const uint8_t *const head = (const uint8_t *)NODEKEY(first);
+    prefix = NODEKSZ(first);
+    for (unsigned i = low + 1; i < nkeys && prefix; i++) {
+      const MDBX_node *node = NODEPTR(mp, i);
+      const uint8_t *const bytes = (const uint8_t *)NODEKEY(node);
+      const size_t shortest = (NODEKSZ(node) < prefix) ? NODEKSZ(node) : prefix;
+      size_t lcp = 0;
+      while (lcp < shortest && bytes[lcp] == head[lcp])
+        lcp++;
+      prefix = lcp;
+    }
+  }
+
+  PAGEPREFIX(mp) = (indx_t)prefix;
+  PAGEINDX(mp, 1) = 0;
+  for (unsigned i = 0; i < nkeys; i++) {
+    MDBX_val key = {NULL, 0};
+    if (i >= low)
+      MDBX_GET_KEY2(NODEPTR(mp, i), key);
+    PAGEFPRINT(mp, i) = (indx_t)mdbx_fprint(&key, prefix);
+  }
+}
+
+/* Updates the fingerprint of the node at indx on a P_FPRINT page after its
+ * key was changed, or rebuilds all of them if the key lacks the prefix
+ * common for the page. Insertions between the first and the last keys
+ * never shorten the prefix, so a rebuild is needed only on the edges. */
+static void mdbx_fprint_update(MDBX_page *mp, unsigned indx) {
+  const unsigned nkeys = NUMKEYS(mp);
+  const unsigned low = IS_LEAF(mp) ? 0 : 1;
+  const size_t prefix = PAGEPREFIX(mp);
+  MDBX_val key = {NULL, 0};
+  if (indx >= low) {
+    MDBX_GET_KEY2(NODEPTR(mp, indx), key);
+    if (prefix) {
+      const unsigned other = (indx > low) ? low : indx + 1;
+      if (other >= nkeys || key.iov_len < prefix ||
+          memcmp(key.iov_base, NODEKEY(NODEPTR(mp, other)), prefix) != 0) {
+        mdbx_fprint_rebuild(mp);
+        return;
+      }
+    }
+  }
+  PAGEFPRINT(mp, indx) = (indx_t)mdbx_fprint(&key, prefix);
+}
+
+/* Checks the common prefix and the fingerprints of a P_FPRINT page. */
+static bool mdbx_fprint_check(MDBX_page *mp) {
+  const unsigned nkeys = NUMKEYS(mp);
+  const unsigned low = IS_LEAF(mp) ? 0 : 1;
+  const size_t prefix = PAGEPREFIX(mp);
+  for (unsigned i = low; i < nkeys; i++) {
+    MDBX_val key;
+    MDBX_GET_KEY2(NODEPTR(mp, i), key);
+    if (key.iov_len < prefix ||
+        PAGEFPRINT(mp, i) != mdbx_fprint(&key, prefix) ||
+        memcmp(key.iov_base, NODEKEY(NODEPTR(mp, low)), prefix) != 0)
+      return false;
   }
+  return true;
 }
-#endif
 
-/* Pop a page off the top of the cursor's stack. */
-static void mdbx_cursor_pop(MDBX_cursor *mc) {
+/* For a P_FPRINT page the key is compared with the prefix common for
+ * the page only once, and then the binary search runs on the fingerprints
+ * within mp_ptrs[]. Only nodes with the same fingerprint are compared,
+ * so usually one or two nodes are touched instead of one per step.
+ * Returns the same as mdbx_node_search_kind(). */
+static __inline unsigned mdbx_node_search_fprint(MDBX_page *mp, MDBX_val *key,
+                                                 int *exact) {
+  const unsigned nkeys = NUMKEYS(mp);
+  int low = IS_LEAF(mp) ? 0 : 1, high = nkeys - 1;
+  const size_t prefix = PAGEPREFIX(mp);
+  unsigned i = 0;
+  int rc = 0;
+  MDBX_val nodekey;
+  DKBUF;
+
+  if (prefix && low <= high) {
+    const MDBX_node *node = NODEPTR(mp, low);
+    rc = memcmp(key->iov_base, NODEKEY(node),
+                (key->iov_len < prefix) ? key->iov_len : prefix);
+    if (rc == 0 && key->iov_len < prefix)
+      rc = -1;
+    if (rc != 0) {
+      mdbx_debug("key is %s than the prefix of %" PRIuPTR " bytes of %s page",
+                 (rc > 0) ? "greater" : "less", prefix,
+                 IS_LEAF(mp) ? "leaf" : "branch");
+      *exact = 0;
+      return (rc > 0) ? nkeys : (unsigned)low;
+    }
+  }
+
+  const int fprint = (int)mdbx_fprint(key, prefix);
+  while (low <= high) {
+    i = (low + high) >> 1;
+    rc = fprint - (int)PAGEFPRINT(mp, i);
+    if (rc == 0) {
+      size_t lcp;
+      const MDBX_node *node = NODEPTR(mp, i);
+      nodekey.iov_base = NODEKEY(node);
+      nodekey.iov_len = NODEKSZ(node);
+      rc = mdbx_cmp_memn_lcp(key, &nodekey, prefix, &lcp);
+      mdbx_debug("found %s index %u [%s], rc = %i",
+                 IS_LEAF(mp) ? "leaf" : "branch", i, DKEY(&nodekey), rc);
+      if (rc == 0)
+        break;
+    }
+    if (rc > 0)
+      low = i + 1;
+    else
+      high = i - 1;
+  }
+
+  *exact = (rc == 0 && nkeys > 0);
+  return (rc > 0) ? i + 1 : i;
+}
+
+/* Search for key within a page, using binary search.
+ * Returns the smallest entry larger or equal to the key.
+ * If exactp is non-null, stores whether the found entry was an exact match
+ * in *exactp (1 or 0).
+ * Updates the cursor index with the index of the found entry.
+ * If no entry larger or equal to the key is found, returns NULL. */
+static MDBX_node *__hot mdbx_node_search(MDBX_cursor *mc, MDBX_val *key,
+                                         int *exactp) {
+  MDBX_page *mp = mc->mc_pg[mc->mc_top];
+  const unsigned nkeys = NUMKEYS(mp);
+  unsigned i;
+  int exact;
+
+  mdbx_debug("searching %u keys in %s %spage %" PRIaPGNO "", nkeys,
+             IS_LEAF(mp) ? "leaf" : "branch", IS_SUBP(mp) ? "sub-" : "",
+             mp->mp_pgno);
+
+  /* the kind of comparator was picked by mdbx_dbi_bind() */
+  switch (mc->mc_dbx->md_kind) {
+  case MDBX_CMP_MEMN:
+    i = IS_LEAF2(mp)
+            ? mdbx_node_search_kind(mc, mp, key, &exact, MDBX_CMP_MEMN)
+            : IS_FPRINT(mp) ? mdbx_node_search_fprint(mp, key, &exact)
+                            : mdbx_node_search_memn_prefixed(mp, key, &exact);
+    break;
+  case MDBX_CMP_MEMNR:
+    i = mdbx_node_search_kind(mc, mp, key, &exact, MDBX_CMP_MEMNR);
+    break;
+  case MDBX_CMP_INT:
+    if (likely(key->iov_len == 4 || key->iov_len == 8)) {
+      i = mdbx_node_search_int(mc, mp, key, &exact);
+      mdbx_debug("found %s index %u, exact %i",
+                 IS_LEAF(mp) ? "leaf" : "branch", i, exact);
+      break;
+    }
+  /* fallthrough */
+  default:
+    i = mdbx_node_search_kind(mc, mp, key, &exact, MDBX_CMP_CUSTOM);
+    break;
+  }
+
+  if (exactp)
+    *exactp = exact;
+  /* store the key index */
+  mdbx_cassert(mc, i <= UINT16_MAX);
+  mc->mc_ki[mc->mc_top] = (indx_t)i;
+  if (i >= nkeys)
+    /* There is no entry larger or equal to the key. */
+    return NULL;
+
+  /* nodeptr is fake for LEAF2 */
+  return IS_LEAF2(mp) ? NODEPTR(mp, 0) : NODEPTR(mp, i);
+}
+
+/* Galloping search within the cursor's top page, forward from the current
+ * position. The key must be not less than the key at the current position,
+ * so near keys are found in a few comparisons.
+ * Returns the same as mdbx_node_search(). */
+static MDBX_node *mdbx_node_search_gallop(MDBX_cursor *mc, MDBX_val *key,
+                                          int *exactp) {
+  MDBX_page *mp = mc->mc_pg[mc->mc_top];
+  const unsigned nkeys = NUMKEYS(mp);
+  unsigned low = mc->mc_ki[mc->mc_top], high, step = 1;
+  int exact = 0;
+  MDBX_val nodekey;
+
+  mdbx_cassert(mc, low < nkeys);
+  if (IS_LEAF2(mp))
+    nodekey.iov_len = mc->mc_db->md_xsize;
+  for (;;) {
+    high = low + step;
+    if (high >= nkeys) {
+      high = nkeys;
+      break;
+    }
+    if (IS_LEAF2(mp))
+      nodekey.iov_base = LEAF2KEY(mp, high, nodekey.iov_len);
+    else
+      MDBX_GET_KEY2(NODEPTR(mp, high), nodekey);
+    const int rc = mdbx_cursor_cmp(mc, key, &nodekey);
+    if (rc <= 0) {
+      exact = (rc == 0);
+      break;
+    }
+    low = high;
+    step <<= 1;
+  }
+
+  while (!exact && high - low > 1) {
+    const unsigned middle = (low + high) >> 1;
+    if (IS_LEAF2(mp))
+      nodekey.iov_base = LEAF2KEY(mp, middle, nodekey.iov_len);
+    else
+      MDBX_GET_KEY2(NODEPTR(mp, middle), nodekey);
+    const int rc = mdbx_cursor_cmp(mc, key, &nodekey);
+    if (rc > 0)
+      low = middle;
+    else {
+      high = middle;
+      exact = (rc == 0);
+    }
+  }
+
+  if (exactp)
+    *exactp = exact;
+  mdbx_cassert(mc, high <= UINT16_MAX);
+  mc->mc_ki[mc->mc_top] = (indx_t)high;
+  if (high >= nkeys)
+    return NULL;
+  return IS_LEAF2(mp) ? NODEPTR(mp, 0) : NODEPTR(mp, high);
+}
+
+#if 0 /* unused for now */
+static void mdbx_cursor_adjust(MDBX_cursor *mc, func) {
+  MDBX_cursor *m2;
+
+  for (m2 = mc->mc_txn->mt_cursors[mc->mc_dbi]; m2; m2 = m2->mc_next) {
+    if (m2->mc_pg[m2->mc_top] == mc->mc_pg[mc->mc_top]) {
+      func(mc, m2);
+    }
+  }
+}
+#endif
+
+/* Pop a page off the top of the cursor's stack. */
+static void mdbx_cursor_pop(MDBX_cursor *mc) {
   if (mc->mc_snum) {
     mdbx_debug("popped page %" PRIaPGNO " off db %d cursor %p",
                mc->mc_pg[mc->mc_top]->mp_pgno, DDBI(mc), (void *)mc);
@@ -5713,11 +7473,9 @@ static int mdbx_page_get(MDBX_cursor *mc, pgno_t pgno, MDBX_page **ret,
           goto mapped;
       }
       if (dl[0].mid) {
-        unsigned y = mdbx_mid2l_search(dl, pgno);
-        if (y <= dl[0].mid && dl[y].mid == pgno) {
-          p = dl[y].mptr;
+        p = mdbx_dpl_find(dl, pgno);
+        if (p)
           goto done;
-        }
       }
       level++;
     } while ((tx2 = tx2->mt_parent) != NULL);
@@ -5775,7 +7533,9 @@ static int mdbx_page_search_root(MDBX_cursor *mc, MDBX_val *key, int flags) {
       }
     } else {
       int exact;
-      node = mdbx_node_search(mc, key, &exact);
+      node = (flags & MDBX_PS_GALLOP) ? mdbx_node_search_gallop(mc, key, &exact)
+                                      : mdbx_node_search(mc, key, &exact);
+      flags &= ~MDBX_PS_GALLOP;
       if (node == NULL)
         i = NUMKEYS(mp) - 1;
       else {
@@ -5951,7 +7711,7 @@ static int mdbx_ovpage_free(MDBX_cursor *mc, MDBX_page *mp) {
        (sl && (x = mdbx_pnl_search(sl, pn)) <= sl[0] && sl[x] == pn))) {
     unsigned i, j;
     pgno_t *mop;
-    MDBX_ID2 *dl, ix, iy;
+    MDBX_ID2 *dl;
     rc = mdbx_pnl_need(&env->me_reclaimed_pglist, ovpages);
     if (unlikely(rc))
       return rc;
@@ -5965,22 +7725,15 @@ static int mdbx_ovpage_free(MDBX_cursor *mc, MDBX_page *mp) {
     }
     /* Remove from dirty list */
     dl = txn->mt_rw_dirtylist;
-    x = dl[0].mid--;
-    for (ix = dl[x]; ix.mptr != mp; ix = iy) {
-      if (likely(x > 1)) {
-        x--;
-        iy = dl[x];
-        dl[x] = ix;
-      } else {
-        mdbx_cassert(mc, x > 1);
-        mdbx_error("not found page 0x%p #%" PRIaPGNO " in the dirtylist", mp,
-                   mp->mp_pgno);
-        j = ++(dl[0].mid);
-        dl[j] = ix; /* Unsorted. OK when MDBX_TXN_ERROR. */
-        txn->mt_flags |= MDBX_TXN_ERROR;
-        return MDBX_PROBLEM;
-      }
+    x = mdbx_dpl_search(dl, mp->mp_pgno);
+    if (unlikely(!x || dl[x].mptr != mp)) {
+      mdbx_cassert(mc, x > 0 && dl[x].mptr == mp);
+      mdbx_error("not found page 0x%p #%" PRIaPGNO " in the dirtylist", mp,
+                 mp->mp_pgno);
+      txn->mt_flags |= MDBX_TXN_ERROR;
+      return MDBX_PROBLEM;
     }
+    mdbx_dpl_remove(dl, x);
     txn->mt_dirtyroom++;
     if (!(env->me_flags & MDBX_WRITEMAP))
       mdbx_dpage_free(env, mp);
@@ -6061,6 +7814,631 @@ int mdbx_get(MDBX_txn *txn, MDBX_dbi dbi, MDBX_val *key, MDBX_val *data) {
   return mdbx_cursor_set(&mc, key, data, MDBX_SET, &exact);
 }
 
+/* merge sort for the order of keys in batch operations, since qsort()
+ * has no context for the comparison function. Runs are sorted by insertion,
+ * then merged bottom-up between the items and the temporary array.
+ *
+ * The keys of a large batch are scattered in memory, so the leading bytes
+ * of keys are cached within items as integers which compares the same as
+ * keys for the built-in comparators. For lexicographic order these are the
+ * bytes after the common prefix of all keys. The keys itself are compared
+ * only if the cached prefixes are equal. */
+#define MDBX_BATCH_RUN 8
+
+typedef struct mdbx_batch_item {
+  uint64_t prefix; /* leading bytes of the key, zero for custom comparators */
+  size_t index;
+} mdbx_batch_item;
+
+static __inline int mdbx_batch_cmp(const mdbx_batch_item *a,
+                                   const mdbx_batch_item *b,
+                                   const MDBX_val *keys, MDBX_cmp_func *cmp) {
+  if (a->prefix != b->prefix)
+    return (a->prefix < b->prefix) ? -1 : 1;
+  return cmp(&keys[a->index], &keys[b->index]);
+}
+
+static uint64_t mdbx_batch_prefix(const unsigned kind, const MDBX_val *key,
+                                  const size_t skip) {
+  const uint8_t *bytes = (const uint8_t *)key->iov_base;
+  uint64_t prefix = 0;
+  switch (kind) {
+  case MDBX_CMP_INT:
+    /* the size of integer keys is checked by mdbx_cursor_set() later */
+    if (key->iov_len == sizeof(uint64_t))
+      prefix = mdbx_peek_u64(bytes);
+    else if (key->iov_len == sizeof(uint32_t))
+      prefix = mdbx_peek_u32(bytes);
+    break;
+  case MDBX_CMP_MEMN:
+    /* shorter key is padded by zeros, so it could be equal to a longer
+     * one only if the last is the same but with zeros, then keys are compared
+     * by the comparator */
+    for (size_t i = 0; i < sizeof(prefix) && skip + i < key->iov_len; ++i)
+      prefix |= (uint64_t)bytes[skip + i] << (56 - i * 8);
+    break;
+  }
+  return prefix;
+}
+
+static mdbx_batch_item *mdbx_batch_sort(mdbx_batch_item *items,
+                                        mdbx_batch_item *tmp, size_t n,
+                                        const MDBX_val *keys,
+                                        MDBX_cmp_func *cmp) {
+  for (size_t run = 0; run < n; run += MDBX_BATCH_RUN) {
+    const size_t end = (run + MDBX_BATCH_RUN < n) ? run + MDBX_BATCH_RUN : n;
+    for (size_t i = run + 1; i < end; ++i) {
+      const mdbx_batch_item item = items[i];
+      size_t j = i;
+      while (j > run && mdbx_batch_cmp(&items[j - 1], &item, keys, cmp) > 0) {
+        items[j] = items[j - 1];
+        --j;
+      }
+      items[j] = item;
+    }
+  }
+
+  for (size_t width = MDBX_BATCH_RUN; width < n; width <<= 1) {
+    for (size_t left = 0; left < n; left += width << 1) {
+      const size_t middle = (left + width < n) ? left + width : n;
+      const size_t right = (middle + width < n) ? middle + width : n;
+      size_t i = left, j = middle, k = left;
+      while (i < middle && j < right)
+        tmp[k++] = (mdbx_batch_cmp(&items[j], &items[i], keys, cmp) < 0)
+                       ? items[j++]
+                       : items[i++];
+      while (i < middle)
+        tmp[k++] = items[i++];
+      while (j < right)
+        tmp[k++] = items[j++];
+    }
+    mdbx_batch_item *const swap = items;
+    items = tmp;
+    tmp = swap;
+  }
+  return items;
+}
+
+/* Provides the order of keys sorted by the database's comparison function,
+ * or NULL if the keys are already sorted. */
+static int mdbx_batch_order(MDBX_cursor *mc, const MDBX_val *keys, size_t n,
+                            size_t **order) {
+  /* the keys are compared here before mdbx_cursor_set() or
+   * mdbx_cursor_put() checks them, so check the sizes the same way. */
+  size_t i;
+  *order = NULL;
+  if (mc->mc_db->md_flags & MDBX_INTEGERKEY) {
+    for (i = 0; i < n; ++i)
+      if (unlikely(keys[i].iov_len != sizeof(uint32_t) &&
+                   keys[i].iov_len != sizeof(uint64_t)))
+        return MDBX_BAD_VALSIZE;
+  }
+
+  MDBX_cmp_func *cmp = mc->mc_dbx->md_cmp;
+  i = 1;
+  while (i < n && cmp(&keys[i - 1], &keys[i]) <= 0)
+    ++i;
+  if (i >= n)
+    return MDBX_SUCCESS;
+
+  mdbx_batch_item *const buffer = malloc(n * 2 * sizeof(mdbx_batch_item));
+  if (unlikely(!buffer))
+    return MDBX_ENOMEM;
+  const unsigned kind = mc->mc_dbx->md_kind;
+  size_t skip = 0;
+  if (kind == MDBX_CMP_MEMN) {
+    skip = keys[0].iov_len;
+    for (i = 1; i < n && skip > 0; ++i) {
+      const uint8_t *a = (const uint8_t *)keys[0].iov_base;
+      const uint8_t *b = (const uint8_t *)keys[i].iov_base;
+      size_t lcp = 0, len = (keys[i].iov_len < skip) ? keys[i].iov_len : skip;
+      while (lcp < len && a[lcp] == b[lcp])
+        ++lcp;
+      skip = lcp;
+    }
+  }
+  for (i = 0; i < n; ++i) {
+    buffer[i].prefix = mdbx_batch_prefix(kind, &keys[i], skip);
+    buffer[i].index = i;
+  }
+  const mdbx_batch_item *sorted =
+      mdbx_batch_sort(buffer, buffer + n, n, keys, cmp);
+
+  /* the order is placed at the start of buffer, it could overlap the
+   * sorted items, but only these which already have been read. */
+  *order = (size_t *)buffer;
+  for (i = 0; i < n; ++i)
+    (*order)[i] = sorted[i].index;
+  return MDBX_SUCCESS;
+}
+
+int mdbx_get_batch(MDBX_txn *txn, MDBX_dbi dbi, const MDBX_val *keys,
+                   size_t count, MDBX_val *values, unsigned flags) {
+  MDBX_cursor mc;
+  MDBX_xcursor mx;
+  size_t *order = NULL;
+
+  if (unlikely(!txn || (count && (!keys || !values)) ||
+               (flags & ~MDBX_SORTED)))
+    return MDBX_EINVAL;
+
+  if (unlikely(txn->mt_signature != MDBX_MT_SIGNATURE))
+    return MDBX_EBADSIGN;
+
+  if (unlikely(txn->mt_owner != mdbx_thread_self()))
+    return MDBX_THREAD_MISMATCH;
+
+  if (unlikely(!TXN_DBI_EXIST(txn, dbi, DB_USRVALID)))
+    return MDBX_EINVAL;
+
+  if (unlikely(txn->mt_flags & MDBX_TXN_BLOCKED))
+    return MDBX_BAD_TXN;
+
+  mdbx_cursor_init(&mc, txn, dbi, &mx);
+  int rc = MDBX_SUCCESS;
+  if (!(flags & MDBX_SORTED)) {
+    rc = mdbx_batch_order(&mc, keys, count, &order);
+    if (unlikely(rc != MDBX_SUCCESS))
+      return rc;
+  }
+
+  for (size_t i = 0; i < count; ++i) {
+    const size_t n = order ? order[i] : i;
+    MDBX_val key = keys[n];
+    int exact = 0;
+    int err = mdbx_cursor_set(&mc, &key, &values[n], MDBX_SET, &exact);
+    if (unlikely(err != MDBX_SUCCESS)) {
+      values[n].iov_base = NULL;
+      values[n].iov_len = 0;
+      if (unlikely(err != MDBX_NOTFOUND)) {
+        rc = err;
+        break;
+      }
+      rc = MDBX_NOTFOUND;
+      continue;
+    }
+
+    /* the next sorted key is likely the next node,
+     * so prefetch it while the caller is busy with this one */
+    MDBX_page *mp = mc.mc_pg[mc.mc_top];
+    const unsigned next = mc.mc_ki[mc.mc_top] + 1;
+    if (!IS_LEAF2(mp) && next < NUMKEYS(mp))
+      __prefetch(NODEPTR(mp, next));
+  }
+
+  free(order);
+  return rc;
+}
+
+/*----------------------------------------------------------------------------*/
+/* Counts of items within subtrees, see MDBX_COUNTED.
+ *
+ * Each branch node keeps the number of items within the subtree of its
+ * child, so the counts of a branch page always sum up to the count of its
+ * parent node, or to the md_entries at the root. The counts along the path
+ * of a cursor are changed together with the md_entries of the tree, while
+ * mdbx_page_split(), mdbx_node_move() and mdbx_page_merge() just move the
+ * counts between the sibling pages. The nested trees of duplicates are
+ * counted the same way. */
+
+/* Number of items of a leaf node, i.e. of the duplicates for a node with
+ * a sub-page or a sub-DB. These are empty just transiently, while a single
+ * item is converted into duplicates, so an empty one is taken as the item. */
+static __inline uint64_t mdbx_leaf_entries(unsigned flags, void *data) {
+  uint64_t entries = 1;
+  if (flags & F_DUPDATA) {
+    if (flags & F_SUBDATA)
+      memcpy(&entries, (char *)data + offsetof(MDBX_db, md_entries),
+             sizeof(entries));
+    else
+      entries = NUMKEYS((MDBX_page *)data);
+    if (unlikely(entries == 0))
+      entries = 1;
+  }
+  return entries;
+}
+
+/* Number of items of a node of a branch or leaf page. */
+static __inline uint64_t mdbx_node_entries(MDBX_page *mp, MDBX_node *node) {
+  return IS_BRANCH(mp) ? NODECOUNT(node)
+                       : mdbx_leaf_entries(node->mn_flags, NODEDATA(node));
+}
+
+/* Adds the delta to the counts along the cursor's path above the level.
+ * the pages are checked to be branches, otherwise GCC 12 at -O1/-O2
+ * merges the indices of the path into a NULL-based one, then takes this
+ * function for a pure one and drops the calls. */
+static void mdbx_count_adjust(const MDBX_cursor *mc, unsigned top,
+                              int64_t delta) {
+  if (mc->mc_db->md_flags & MDBX_COUNTED) {
+    for (unsigned i = 0; i < top; i++) {
+      MDBX_page *mp = mc->mc_pg[i];
+      if (likely(IS_BRANCH(mp))) {
+        MDBX_node *node = NODEPTR(mp, mc->mc_ki[i]);
+        SETCOUNT(node, NODECOUNT(node) + delta);
+      }
+    }
+  }
+}
+
+/* Number of items before the position of the cursor, not counting the
+ * duplicates of the current key. The count of a page is known from its
+ * parent node, so the nodes are summed from the nearer end of the page. */
+static uint64_t mdbx_cursor_rank(MDBX_cursor *mc) {
+  uint64_t rank = 0, total = mc->mc_db->md_entries;
+  for (unsigned i = 0; i < mc->mc_snum; i++) {
+    MDBX_page *mp = mc->mc_pg[i];
+    const unsigned nkeys = NUMKEYS(mp), ki = mc->mc_ki[i];
+    if (IS_LEAF2(mp) ||
+        (IS_LEAF(mp) && !(mc->mc_db->md_flags & MDBX_DUPSORT)))
+      return rank + ki;
+
+    uint64_t left = 0;
+    if (ki <= nkeys / 2) {
+      for (unsigned j = 0; j < ki; j++)
+        left += mdbx_node_entries(mp, NODEPTR(mp, j));
+    } else {
+      left = total;
+      for (unsigned j = ki; j < nkeys; j++)
+        left -= mdbx_node_entries(mp, NODEPTR(mp, j));
+    }
+    rank += left;
+    if (IS_BRANCH(mp))
+      total = NODECOUNT(NODEPTR(mp, ki));
+  }
+  return rank;
+}
+
+/* Descends from the root, which is on the cursor's stack, to the leaf node
+ * with the item of the rank. Returns the rank within the node's duplicates.
+ */
+static int mdbx_cursor_rank_seek(MDBX_cursor *mc, uint64_t *rank) {
+  uint64_t total = mc->mc_db->md_entries, rest = *rank;
+  int rc;
+
+  for (;;) {
+    MDBX_page *mp = mc->mc_pg[mc->mc_top];
+    const unsigned nkeys = NUMKEYS(mp);
+    uint64_t entries = 1;
+    unsigned i;
+
+    if (IS_LEAF2(mp) ||
+        (IS_LEAF(mp) && !(mc->mc_db->md_flags & MDBX_DUPSORT))) {
+      i = (rest < nkeys) ? (unsigned)rest : nkeys;
+      rest = 0;
+    } else if (rest < total / 2) {
+      for (i = 0; i < nkeys; i++) {
+        entries = mdbx_node_entries(mp, NODEPTR(mp, i));
+        if (rest < entries)
+          break;
+        rest -= entries;
+      }
+    } else {
+      /* the items from the rank up to the end of the page */
+      uint64_t tail = total - rest;
+      for (i = nkeys; i > 0;) {
+        entries = mdbx_node_entries(mp, NODEPTR(mp, --i));
+        if (tail <= entries)
+          break;
+        tail -= entries;
+      }
+      if (unlikely(tail > entries))
+        i = nkeys;
+      rest = entries - tail;
+    }
+
+    if (unlikely(i >= nkeys)) {
+      mdbx_error("the counts of page %" PRIaPGNO " are inconsistent",
+                 mp->mp_pgno);
+      mc->mc_txn->mt_flags |= MDBX_TXN_ERROR;
+      return MDBX_CORRUPTED;
+    }
+    mc->mc_ki[mc->mc_top] = (indx_t)i;
+    if (IS_LEAF(mp)) {
+      *rank = rest;
+      return MDBX_SUCCESS;
+    }
+
+    total = entries;
+    if (unlikely((rc = mdbx_page_get(mc, NODEPGNO(NODEPTR(mp, i)), &mp,
+                                     NULL)) != MDBX_SUCCESS ||
+                 (rc = mdbx_cursor_push(mc, mp)) != MDBX_SUCCESS))
+      return rc;
+  }
+}
+
+/* Positions the cursor at the lower bound of the key for estimation, so the
+ * nested trees of duplicates aren't touched. The index within the leaf could
+ * be equal to the number of its nodes, i.e. past the last node. */
+static int mdbx_estimate_seek(MDBX_cursor *mc, const MDBX_val *key,
+                              int flags) {
+  MDBX_val copy;
+  int rc;
+
+  if (!key) {
+    rc = mdbx_page_search(mc, NULL, flags);
+    if (likely(rc == MDBX_SUCCESS) && (flags & MDBX_PS_LAST))
+      mc->mc_ki[mc->mc_top] = (indx_t)NUMKEYS(mc->mc_pg[mc->mc_top]);
+    return rc;
+  }
+
+  if ((mc->mc_db->md_flags & MDBX_INTEGERKEY) &&
+      unlikely(key->iov_len != sizeof(uint32_t) &&
+               key->iov_len != sizeof(uint64_t)))
+    return MDBX_BAD_VALSIZE;
+
+  copy = *key;
+  rc = mdbx_page_search(mc, &copy, 0);
+  if (likely(rc == MDBX_SUCCESS))
+    mdbx_node_search(mc, &copy, NULL);
+  return rc;
+}
+
+/* Position of the cursor within the tree as a fraction of all items,
+ * assuming the items are spread evenly over the pages of each level. */
+static double mdbx_estimate_fraction(const MDBX_cursor *mc) {
+  double fraction = 0, scale = 1;
+  for (unsigned i = 0; i < mc->mc_snum; i++) {
+    scale /= NUMKEYS(mc->mc_pg[i]);
+    fraction += scale * mc->mc_ki[i];
+  }
+  return fraction;
+}
+
+/* Counts the items and the bytes of the leaf nodes in [from, to). */
+static void mdbx_estimate_leaf(const MDBX_env *env, MDBX_page *mp,
+                               unsigned from, unsigned to, uint64_t *entries,
+                               uint64_t *bytes) {
+  for (unsigned i = from; i < to; i++) {
+    MDBX_node *node = NODEPTR(mp, i);
+    *bytes += PAGESLOTSZ(mp) + NODESIZE + NODEKSZ(node);
+    if (node->mn_flags & F_BIGDATA)
+      *bytes += sizeof(pgno_t) + pgno2bytes(env, OVPAGES(env, NODEDSZ(node)));
+    else
+      *bytes += NODEDSZ(node);
+    if (F_ISSET(node->mn_flags, F_DUPDATA | F_SUBDATA)) {
+      MDBX_db db;
+      memcpy(&db, NODEDATA(node), sizeof(db));
+      *entries += db.md_entries;
+      *bytes += pgno2bytes(env, db.md_branch_pages + db.md_leaf_pages +
+                                    db.md_overflow_pages);
+    } else if (node->mn_flags & F_DUPDATA) {
+      *entries += NUMKEYS((MDBX_page *)NODEDATA(node));
+    } else {
+      *entries += 1;
+    }
+  }
+}
+
+int mdbx_estimate_range(MDBX_txn *txn, MDBX_dbi dbi, const MDBX_val *begin,
+                        const MDBX_val *end, uint64_t *entries,
+                        uint64_t *bytes, unsigned flags) {
+  MDBX_cursor lo, hi;
+  MDBX_xcursor lx, hx;
+
+  if (unlikely(!txn || (flags & ~MDBX_ESTIMATE_EXACT)))
+    return MDBX_EINVAL;
+
+  if (unlikely(txn->mt_signature != MDBX_MT_SIGNATURE))
+    return MDBX_EBADSIGN;
+
+  if (unlikely(txn->mt_owner != mdbx_thread_self()))
+    return MDBX_THREAD_MISMATCH;
+
+  if (unlikely(!TXN_DBI_EXIST(txn, dbi, DB_USRVALID)))
+    return MDBX_EINVAL;
+
+  if (unlikely(txn->mt_flags & MDBX_TXN_BLOCKED))
+    return MDBX_BAD_TXN;
+
+  if ((flags & MDBX_ESTIMATE_EXACT) &&
+      unlikely(!(txn->mt_dbs[dbi].md_flags & MDBX_COUNTED)))
+    return MDBX_INCOMPATIBLE;
+
+  uint64_t n = 0, size = 0;
+  mdbx_cursor_init(&lo, txn, dbi, &lx);
+  mdbx_cursor_init(&hi, txn, dbi, &hx);
+  if (begin && end && mdbx_cursor_cmp(&lo, begin, end) >= 0)
+    goto done;
+
+  int rc = mdbx_estimate_seek(&lo, begin, MDBX_PS_FIRST);
+  if (likely(rc == MDBX_SUCCESS))
+    rc = mdbx_estimate_seek(&hi, end, MDBX_PS_LAST);
+  if (unlikely(rc != MDBX_SUCCESS)) {
+    if (rc != MDBX_NOTFOUND)
+      return rc;
+    goto done; /* the tree is empty */
+  }
+
+  const MDBX_env *env = txn->mt_env;
+  MDBX_page *lp = lo.mc_pg[lo.mc_top], *hp = hi.mc_pg[hi.mc_top];
+  if (lp == hp) {
+    if (lo.mc_ki[lo.mc_top] < hi.mc_ki[hi.mc_top])
+      mdbx_estimate_leaf(env, lp, lo.mc_ki[lo.mc_top], hi.mc_ki[hi.mc_top],
+                         &n, &size);
+    goto done;
+  }
+
+  /* The edge leaves are counted exactly, the rest is estimated by the
+   * distance between the end of the left leaf and the start of the right
+   * one. The leaves in between are taken at the average fill of the edge
+   * ones, but the nested trees of duplicates there are not accounted.
+   * The exact number of items is given by the ranks of the bounds. */
+  uint64_t exact = 0;
+  if (flags & MDBX_ESTIMATE_EXACT)
+    exact = mdbx_cursor_rank(&hi) - mdbx_cursor_rank(&lo);
+  mdbx_estimate_leaf(env, lp, lo.mc_ki[lo.mc_top], NUMKEYS(lp), &n, &size);
+  mdbx_estimate_leaf(env, hp, 0, hi.mc_ki[hi.mc_top], &n, &size);
+
+  lo.mc_ki[lo.mc_top] = (indx_t)NUMKEYS(lp);
+  hi.mc_ki[hi.mc_top] = 0;
+  const double middle =
+      mdbx_estimate_fraction(&hi) - mdbx_estimate_fraction(&lo);
+  if (middle > 0) {
+    const MDBX_db *db = lo.mc_db;
+    const double fill =
+        (2 * (env->me_psize - PAGEHDRSZ) - SIZELEFT(lp) - SIZELEFT(hp)) / 2.0;
+    n += (uint64_t)(middle * db->md_entries + 0.5);
+    size += (uint64_t)(middle * (db->md_leaf_pages * fill +
+                                 pgno2bytes(env, db->md_overflow_pages)) +
+                       0.5);
+  }
+  if (flags & MDBX_ESTIMATE_EXACT)
+    n = exact;
+
+done:
+  if (entries)
+    *entries = n;
+  if (bytes)
+    *bytes = size;
+  return MDBX_SUCCESS;
+}
+
+/* The number of subtrees per requested range, which is enough to balance
+ * the ranges without descending the tree further. */
+#define MDBX_PARTITION_SUBTREES 16
+
+/* A page of a level of the tree, with the lower bound of its keys. */
+typedef struct MDBX_partition_page {
+  MDBX_page *mp;
+  MDBX_val lower; /* empty for the leftmost page of a level */
+} MDBX_partition_page;
+
+int mdbx_dbi_partition(MDBX_txn *txn, MDBX_dbi dbi, size_t *count,
+                       MDBX_val *bounds) {
+  MDBX_cursor mc;
+  MDBX_xcursor mx;
+
+  if (unlikely(!txn || !count || *count < 1 || (*count > 1 && !bounds)))
+    return MDBX_EINVAL;
+
+  if (unlikely(txn->mt_signature != MDBX_MT_SIGNATURE))
+    return MDBX_EBADSIGN;
+
+  if (unlikely(txn->mt_owner != mdbx_thread_self()))
+    return MDBX_THREAD_MISMATCH;
+
+  if (unlikely(!TXN_DBI_EXIST(txn, dbi, DB_USRVALID)))
+    return MDBX_EINVAL;
+
+  if (unlikely(txn->mt_flags & MDBX_TXN_BLOCKED))
+    return MDBX_BAD_TXN;
+
+  const size_t wanna = *count;
+  *count = 1;
+  if (wanna < 2)
+    return MDBX_SUCCESS;
+
+  mdbx_cursor_init(&mc, txn, dbi, &mx);
+  int rc = mdbx_page_search(&mc, NULL, MDBX_PS_ROOTONLY);
+  if (unlikely(rc != MDBX_SUCCESS))
+    return (rc == MDBX_NOTFOUND) ? MDBX_SUCCESS /* the tree is empty */ : rc;
+
+  /* Descend by branch levels, until there are enough subtrees at a level
+   * or the next one is the leaves. */
+  const unsigned depth = mc.mc_db->md_depth;
+  MDBX_partition_page *level = malloc(sizeof(MDBX_partition_page));
+  if (unlikely(!level))
+    return MDBX_ENOMEM;
+  level[0].mp = mc.mc_pg[0];
+  level[0].lower.iov_base = NULL;
+  level[0].lower.iov_len = 0;
+  size_t npages = 1, nodes = 0;
+  unsigned height = 1;
+  for (; height < depth; ++height) {
+    nodes = 0;
+    for (size_t i = 0; i < npages; ++i)
+      nodes += NUMKEYS(level[i].mp);
+    if (height + 1 == depth || nodes >= wanna * MDBX_PARTITION_SUBTREES)
+      break;
+
+    MDBX_partition_page *next = malloc(nodes * sizeof(MDBX_partition_page));
+    if (unlikely(!next)) {
+      rc = MDBX_ENOMEM;
+      goto bailout;
+    }
+    size_t n = 0;
+    for (size_t i = 0; i < npages; ++i) {
+      MDBX_page *mp = level[i].mp;
+      for (unsigned ki = 0; ki < NUMKEYS(mp); ++ki, ++n) {
+        MDBX_node *node = NODEPTR(mp, ki);
+        rc = mdbx_page_get(&mc, NODEPGNO(node), &next[n].mp, NULL);
+        if (unlikely(rc != MDBX_SUCCESS)) {
+          free(next);
+          goto bailout;
+        }
+        if (ki) {
+          next[n].lower.iov_base = NODEKEY(node);
+          next[n].lower.iov_len = NODEKSZ(node);
+        } else
+          next[n].lower = level[i].lower;
+      }
+    }
+    free(level);
+    level = next;
+    npages = nodes;
+  }
+
+  if (depth > 1) {
+    /* Weight the nodes by the number of children of their subtrees, unless
+     * these are the leaves. So the ranges are balanced by the next level
+     * too, since the pages of a level could differ in fill about twice. */
+    const int weighted = height + 1 < depth;
+    unsigned *weight = NULL;
+    uint64_t total = nodes;
+    if (weighted) {
+      weight = malloc(nodes * sizeof(unsigned));
+      if (unlikely(!weight)) {
+        rc = MDBX_ENOMEM;
+        goto bailout;
+      }
+      total = 0;
+      size_t n = 0;
+      for (size_t i = 0; i < npages; ++i) {
+        for (unsigned ki = 0; ki < NUMKEYS(level[i].mp); ++ki, ++n) {
+          MDBX_page *child;
+          rc = mdbx_page_get(&mc, NODEPGNO(NODEPTR(level[i].mp, ki)), &child,
+                             NULL);
+          if (unlikely(rc != MDBX_SUCCESS)) {
+            free(weight);
+            goto bailout;
+          }
+          weight[n] = NUMKEYS(child);
+          total += weight[n];
+        }
+      }
+    }
+
+    /* Take the separators from the nodes, where the accumulated weight
+     * reaches the next share of the total. */
+    const size_t parts = (nodes < wanna) ? nodes : wanna;
+    size_t chosen = 0, n = 0;
+    uint64_t acc = 0;
+    for (size_t i = 0; i < npages && chosen + 1 < parts; ++i) {
+      MDBX_page *mp = level[i].mp;
+      for (unsigned ki = 0; ki < NUMKEYS(mp) && chosen + 1 < parts;
+           ++ki, ++n) {
+        if (n && acc * parts >= (chosen + 1) * total) {
+          if (ki) {
+            MDBX_node *node = NODEPTR(mp, ki);
+            bounds[chosen].iov_base = NODEKEY(node);
+            bounds[chosen].iov_len = NODEKSZ(node);
+          } else
+            bounds[chosen] = level[i].lower;
+          chosen += 1;
+        }
+        acc += weighted ? weight[n] : 1;
+      }
+    }
+    *count = chosen + 1;
+    free(weight);
+  }
+
+bailout:
+  free(level);
+  return rc;
+}
+
 /* Find a sibling for a page.
  * Replaces the page at the top of the cursor's stack with the specified
  * sibling, if one exists.
@@ -6298,6 +8676,32 @@ static int mdbx_cursor_prev(MDBX_cursor *mc, MDBX_val *key, MDBX_val *data,
 }
 
 /* Set the cursor on a specific data item. */
+/* Finger search: climbs the cursor's stack up to the lowest page, which
+ * subtree covers the key being beyond the current leaf. The forward is true
+ * when the key is greater than the last key of the leaf, so only the upper
+ * bounds should be checked, otherwise only the lower ones.
+ * Returns the level of such page, i.e. zero for the root. */
+static unsigned mdbx_cursor_climb(MDBX_cursor *mc, MDBX_val *key,
+                                  bool forward) {
+  for (unsigned top = mc->mc_top; top > 0; --top) {
+    MDBX_page *parent = mc->mc_pg[top - 1];
+    const unsigned i = mc->mc_ki[top - 1] + (forward ? 1 : 0);
+    /* The first key of a branch-page is implicit and the last child of
+     * a page has no upper bound here, so these are inherited from above. */
+    if (forward ? i >= NUMKEYS(parent) : i == 0)
+      continue;
+
+    MDBX_node *node = NODEPTR(parent, i);
+    MDBX_val sepkey;
+    sepkey.iov_len = NODEKSZ(node);
+    sepkey.iov_base = NODEKEY(node);
+    const int rc = mdbx_cursor_cmp(mc, key, &sepkey);
+    if (forward ? rc < 0 : rc >= 0)
+      return top;
+  }
+  return 0;
+}
+
 static int mdbx_cursor_set(MDBX_cursor *mc, MDBX_val *key, MDBX_val *data,
                            MDBX_cursor_op op, int *exactp) {
   int rc;
@@ -6332,7 +8736,7 @@ static int mdbx_cursor_set(MDBX_cursor *mc, MDBX_val *key, MDBX_val *data,
       leaf = NODEPTR(mp, 0);
       MDBX_GET_KEY2(leaf, nodekey);
     }
-    rc = mc->mc_dbx->md_cmp(key, &nodekey);
+    rc = mdbx_cursor_cmp(mc, key, &nodekey);
     if (rc == 0) {
       /* Probably happens rarely, but first node on the page
        * was the one we wanted.
@@ -6352,7 +8756,7 @@ static int mdbx_cursor_set(MDBX_cursor *mc, MDBX_val *key, MDBX_val *data,
           leaf = NODEPTR(mp, nkeys - 1);
           MDBX_GET_KEY2(leaf, nodekey);
         }
-        rc = mc->mc_dbx->md_cmp(key, &nodekey);
+        rc = mdbx_cursor_cmp(mc, key, &nodekey);
         if (rc == 0) {
           /* last node was the one we wanted */
           mdbx_cassert(mc, nkeys >= 1 && nkeys <= UINT16_MAX + 1);
@@ -6371,13 +8775,20 @@ static int mdbx_cursor_set(MDBX_cursor *mc, MDBX_val *key, MDBX_val *data,
               leaf = NODEPTR(mp, mc->mc_ki[mc->mc_top]);
               MDBX_GET_KEY2(leaf, nodekey);
             }
-            rc = mc->mc_dbx->md_cmp(key, &nodekey);
+            rc = mdbx_cursor_cmp(mc, key, &nodekey);
             if (rc == 0) {
               /* current node was the one we wanted */
               if (exactp)
                 *exactp = 1;
               goto set1;
             }
+            if (rc > 0) {
+              /* Finger search: the key is near after the current node */
+              rc = 0;
+              mc->mc_flags &= ~C_EOF;
+              leaf = mdbx_node_search_gallop(mc, key, exactp);
+              goto set3;
+            }
           }
           rc = 0;
           mc->mc_flags &= ~C_EOF;
@@ -6405,11 +8816,24 @@ static int mdbx_cursor_set(MDBX_cursor *mc, MDBX_val *key, MDBX_val *data,
       } else
         return MDBX_NOTFOUND;
     }
+
+    /* Descend from the lowest page covering the key, instead of the root */
+    const unsigned top = mdbx_cursor_climb(mc, key, rc > 0);
+    if (top == mc->mc_top) {
+      rc = 0;
+      mc->mc_flags &= ~C_EOF;
+      goto set2;
+    }
+    if (top > 0) {
+      mc->mc_top = top;
+      mc->mc_snum = top + 1;
+      rc = mdbx_page_search_root(mc, key, (rc > 0) ? MDBX_PS_GALLOP : 0);
+    } else
+      rc = mdbx_page_search(mc, key, 0);
   } else {
     mc->mc_pg[0] = 0;
+    rc = mdbx_page_search(mc, key, 0);
   }
-
-  rc = mdbx_page_search(mc, key, 0);
   if (unlikely(rc != MDBX_SUCCESS))
     return rc;
 
@@ -6418,6 +8842,7 @@ static int mdbx_cursor_set(MDBX_cursor *mc, MDBX_val *key, MDBX_val *data,
 
 set2:
   leaf = mdbx_node_search(mc, key, exactp);
+set3:
   if (exactp != NULL && !*exactp) {
     /* MDBX_SET specified and not an exact match. */
     return MDBX_NOTFOUND;
@@ -6731,23 +9156,229 @@ int mdbx_cursor_get(MDBX_cursor *mc, MDBX_val *key, MDBX_val *data,
         break;
       }
     }
-    if (unlikely(!(mc->mc_xcursor->mx_cursor.mc_flags & C_INITIALIZED)))
-      return MDBX_EINVAL;
-    rc = mfunc(&mc->mc_xcursor->mx_cursor, data, NULL);
-    break;
-  case MDBX_LAST:
-    rc = mdbx_cursor_last(mc, key, data);
-    break;
-  case MDBX_LAST_DUP:
-    mfunc = mdbx_cursor_last;
-    goto mmove;
-  default:
-    mdbx_debug("unhandled/unimplemented cursor operation %u", op);
-    return MDBX_EINVAL;
-  }
+    if (unlikely(!(mc->mc_xcursor->mx_cursor.mc_flags & C_INITIALIZED)))
+      return MDBX_EINVAL;
+    rc = mfunc(&mc->mc_xcursor->mx_cursor, data, NULL);
+    break;
+  case MDBX_LAST:
+    rc = mdbx_cursor_last(mc, key, data);
+    break;
+  case MDBX_LAST_DUP:
+    mfunc = mdbx_cursor_last;
+    goto mmove;
+  default:
+    mdbx_debug("unhandled/unimplemented cursor operation %u", op);
+    return MDBX_EINVAL;
+  }
+
+  mc->mc_flags &= ~C_DEL;
+  return rc;
+}
+
+int mdbx_cursor_get_batch(MDBX_cursor *mc, size_t *count, MDBX_val *pairs,
+                          size_t limit, MDBX_cursor_op op) {
+  if (unlikely(mc == NULL || count == NULL || pairs == NULL || limit < 1))
+    return MDBX_EINVAL;
+
+  if (unlikely(mc->mc_signature != MDBX_MC_SIGNATURE))
+    return MDBX_EBADSIGN;
+
+  if (unlikely(mc->mc_txn->mt_flags & MDBX_TXN_BLOCKED))
+    return MDBX_BAD_TXN;
+
+  *count = 0;
+  if (unlikely(mc->mc_db->md_flags & MDBX_DUPSORT))
+    return MDBX_INCOMPATIBLE;
+
+  /* The first item is taken in the usual way, which moves the cursor
+   * to the next leaf if needed, the rest are just read from the leaf. */
+  int rc;
+  switch (op) {
+  case MDBX_FIRST:
+    rc = mdbx_cursor_first(mc, &pairs[0], &pairs[1]);
+    break;
+  case MDBX_NEXT:
+    rc = mdbx_cursor_next(mc, &pairs[0], &pairs[1], MDBX_NEXT);
+    break;
+  case MDBX_GET_CURRENT:
+    rc = mdbx_cursor_get(mc, &pairs[0], &pairs[1], MDBX_GET_CURRENT);
+    break;
+  default:
+    mdbx_debug("unhandled/unimplemented cursor operation %u", op);
+    return MDBX_EINVAL;
+  }
+  mc->mc_flags &= ~C_DEL;
+  if (unlikely(rc != MDBX_SUCCESS))
+    return rc;
+
+  MDBX_page *mp = mc->mc_pg[mc->mc_top];
+  const unsigned nkeys = NUMKEYS(mp);
+  unsigned ki = mc->mc_ki[mc->mc_top];
+  size_t n = 1;
+  for (; n < limit && ki + 1 < nkeys; ++n) {
+    MDBX_node *leaf = NODEPTR(mp, ++ki);
+    MDBX_GET_KEY(leaf, &pairs[n * 2]);
+    rc = mdbx_node_read(mc, leaf, &pairs[n * 2 + 1]);
+    if (unlikely(rc != MDBX_SUCCESS))
+      break;
+  }
+
+  mc->mc_ki[mc->mc_top] = (indx_t)(rc == MDBX_SUCCESS ? ki : ki - 1);
+  *count = n;
+  return rc;
+}
+
+/* Visits all duplicates of the key by leaves of the nested tree.
+ * Returns MDBX_SUCCESS if all of them were visited, otherwise the sorted-dups
+ * cursor is left at the duplicate on which the scan was stopped. */
+static int mdbx_cursor_scan_dups(MDBX_cursor *mc, MDBX_node *node,
+                                 const MDBX_val *key, MDBX_scan_func *func,
+                                 void *ctx, int reverse) {
+  MDBX_cursor *mx = &mc->mc_xcursor->mx_cursor;
+  MDBX_val data;
+  int rc, ki;
+
+  mdbx_xcursor_init1(mc, node);
+  rc = reverse ? mdbx_cursor_last(mx, &data, NULL)
+               : mdbx_cursor_first(mx, &data, NULL);
+  while (likely(rc == MDBX_SUCCESS)) {
+    MDBX_page *mp = mx->mc_pg[mx->mc_top];
+    const int nkeys = NUMKEYS(mp), step = reverse ? -1 : 1;
+    ki = mx->mc_ki[mx->mc_top];
+    if (IS_LEAF2(mp)) {
+      data.iov_len = mx->mc_db->md_xsize;
+      for (; ki >= 0 && ki < nkeys; ki += step) {
+        data.iov_base = LEAF2KEY(mp, ki, data.iov_len);
+        if (unlikely((rc = func(ctx, key, &data)) != MDBX_SUCCESS))
+          goto bailout;
+      }
+    } else {
+      for (; ki >= 0 && ki < nkeys; ki += step) {
+        MDBX_GET_KEY(NODEPTR(mp, ki), &data);
+        if (unlikely((rc = func(ctx, key, &data)) != MDBX_SUCCESS))
+          goto bailout;
+      }
+    }
+    mx->mc_ki[mx->mc_top] = (indx_t)(ki - step);
+    rc = mdbx_cursor_sibling(mx, !reverse);
+  }
+  return (rc == MDBX_NOTFOUND) ? MDBX_SUCCESS : rc;
+
+bailout:
+  mx->mc_ki[mx->mc_top] = (indx_t)ki;
+  return rc;
+}
+
+int mdbx_cursor_scan(MDBX_cursor *mc, const MDBX_val *from, const MDBX_val *to,
+                     MDBX_scan_func *func, void *ctx, unsigned flags) {
+  if (unlikely(mc == NULL || func == NULL || (flags & ~MDBX_SCAN_REVERSE)))
+    return MDBX_EINVAL;
+
+  if (unlikely(mc->mc_signature != MDBX_MC_SIGNATURE))
+    return MDBX_EBADSIGN;
+
+  if (unlikely(mc->mc_txn->mt_flags & MDBX_TXN_BLOCKED))
+    return MDBX_BAD_TXN;
+
+  const int reverse = (flags & MDBX_SCAN_REVERSE) != 0;
+  const int step = reverse ? -1 : 1;
+  const MDBX_val *const bound = reverse ? from : to;
+  MDBX_cmp_func *const cmp = mc->mc_dbx->md_cmp;
+  MDBX_val key, data;
+  int rc;
+
+  /* Position the cursor at the first item of the scan, the data is not read
+   * here since the leaves are walked from the positioned item below. */
+  if (!reverse) {
+    if (from) {
+      key = *from;
+      rc = mdbx_cursor_set(mc, &key, NULL, MDBX_SET_RANGE, NULL);
+    } else
+      rc = mdbx_cursor_first(mc, &key, NULL);
+  } else {
+    rc = MDBX_NOTFOUND;
+    if (to) {
+      key = *to;
+      rc = mdbx_cursor_set(mc, &key, NULL, MDBX_SET_RANGE, NULL);
+      if (rc == MDBX_SUCCESS) {
+        /* step back to the last key before the end of the range */
+        if (mc->mc_ki[mc->mc_top] > 0)
+          mc->mc_ki[mc->mc_top]--;
+        else
+          rc = mdbx_cursor_sibling(mc, 0);
+        if (rc == MDBX_NOTFOUND)
+          return MDBX_SUCCESS;
+      }
+    }
+    if (rc == MDBX_NOTFOUND)
+      rc = mdbx_cursor_last(mc, &key, NULL);
+  }
+  if (unlikely(rc != MDBX_SUCCESS))
+    return (rc == MDBX_NOTFOUND) ? MDBX_SUCCESS : rc;
+  mc->mc_flags &= ~(C_DEL | C_EOF);
+
+  for (;;) {
+    MDBX_page *mp = mc->mc_pg[mc->mc_top];
+    const int nkeys = NUMKEYS(mp);
+    int ki = mc->mc_ki[mc->mc_top];
+    mdbx_cassert(mc, IS_LEAF(mp) && !IS_LEAF2(mp));
+
+    /* The bound is checked by items only within the leaf it falls into. */
+    int check = 0;
+    if (bound) {
+      MDBX_val edge;
+      MDBX_GET_KEY(NODEPTR(mp, reverse ? 0 : nkeys - 1), &edge);
+      check = reverse ? cmp(&edge, bound) < 0 : cmp(&edge, bound) >= 0;
+    }
+
+    for (; ki >= 0 && ki < nkeys; ki += step) {
+      MDBX_node *leaf = NODEPTR(mp, ki);
+      MDBX_GET_KEY(leaf, &key);
+      if (check) {
+        const int diff = cmp(&key, bound);
+        if (reverse ? diff < 0 : diff >= 0) {
+          /* leave the cursor at the first item beyond the range */
+          mc->mc_ki[mc->mc_top] = (indx_t)ki;
+          if (F_ISSET(leaf->mn_flags, F_DUPDATA)) {
+            MDBX_cursor *mx = &mc->mc_xcursor->mx_cursor;
+            mdbx_xcursor_init1(mc, leaf);
+            rc = reverse ? mdbx_cursor_last(mx, &data, NULL)
+                         : mdbx_cursor_first(mx, &data, NULL);
+          } else if (mc->mc_xcursor)
+            mc->mc_xcursor->mx_cursor.mc_flags &= ~(C_INITIALIZED | C_EOF);
+          return rc;
+        }
+      }
+
+      if (F_ISSET(leaf->mn_flags, F_DUPDATA))
+        rc = mdbx_cursor_scan_dups(mc, leaf, &key, func, ctx, reverse);
+      else {
+        rc = mdbx_node_read(mc, leaf, &data);
+        if (likely(rc == MDBX_SUCCESS))
+          rc = func(ctx, &key, &data);
+        if (unlikely(rc != MDBX_SUCCESS) && mc->mc_xcursor)
+          mc->mc_xcursor->mx_cursor.mc_flags &= ~(C_INITIALIZED | C_EOF);
+      }
+      if (unlikely(rc != MDBX_SUCCESS)) {
+        mc->mc_ki[mc->mc_top] = (indx_t)ki;
+        return rc;
+      }
+    }
 
-  mc->mc_flags &= ~C_DEL;
-  return rc;
+    mc->mc_ki[mc->mc_top] = (indx_t)(ki - step);
+    rc = mdbx_cursor_sibling(mc, !reverse);
+    if (unlikely(rc != MDBX_SUCCESS)) {
+      if (rc != MDBX_NOTFOUND)
+        return rc;
+      /* the end of data, the cursor stays at the last visited item */
+      if (!reverse)
+        mc->mc_flags |= C_EOF;
+      if (mc->mc_xcursor &&
+          !F_ISSET(NODEPTR(mp, ki - step)->mn_flags, F_DUPDATA))
+        mc->mc_xcursor->mx_cursor.mc_flags &= ~(C_INITIALIZED | C_EOF);
+      return MDBX_SUCCESS;
+    }
+  }
 }
 
 /* Touch all the pages in the cursor stack. Set mc_top.
@@ -6863,7 +9494,7 @@ int mdbx_cursor_put(MDBX_cursor *mc, MDBX_val *key, MDBX_val *data,
     rc = mdbx_cursor_get(mc, &current_key, &current_data, MDBX_GET_CURRENT);
     if (unlikely(rc != MDBX_SUCCESS))
       return rc;
-    if (mc->mc_dbx->md_cmp(key, &current_key) != 0)
+    if (mdbx_cursor_cmp(mc, key, &current_key) != 0)
       return MDBX_EKEYMISMATCH;
 
     if (F_ISSET(mc->mc_db->md_flags, MDBX_DUPSORT)) {
@@ -6899,7 +9530,7 @@ int mdbx_cursor_put(MDBX_cursor *mc, MDBX_val *key, MDBX_val *data,
       MDBX_val k2;
       rc = mdbx_cursor_last(mc, &k2, &d2);
       if (rc == 0) {
-        rc = mc->mc_dbx->md_cmp(key, &k2);
+        rc = mdbx_cursor_cmp(mc, key, &k2);
         if (rc > 0) {
           rc = MDBX_NOTFOUND;
           mc->mc_ki[mc->mc_top]++;
@@ -7089,8 +9720,7 @@ int mdbx_cursor_put(MDBX_cursor *mc, MDBX_val *key, MDBX_val *data,
         /* Too big for a sub-page, convert to sub-DB */
         fp_flags &= ~P_SUBP;
       prep_subDB:
-        dummy.md_xsize = 0;
-        dummy.md_flags = 0;
+        memset(&dummy, 0, sizeof(dummy));
         if (mc->mc_db->md_flags & MDBX_DUPFIXED) {
           fp_flags |= P_LEAF2;
           dummy.md_xsize = fp->mp_leaf2_ksize;
@@ -7098,6 +9728,8 @@ int mdbx_cursor_put(MDBX_cursor *mc, MDBX_val *key, MDBX_val *data,
           if (mc->mc_db->md_flags & MDBX_INTEGERDUP)
             dummy.md_flags |= MDBX_INTEGERKEY;
         }
+        /* the trees of duplicates are counted as well as the main one */
+        dummy.md_flags |= mc->mc_db->md_flags & MDBX_COUNTED;
         dummy.md_depth = 1;
         dummy.md_branch_pages = 0;
         dummy.md_leaf_pages = 1;
@@ -7171,14 +9803,15 @@ int mdbx_cursor_put(MDBX_cursor *mc, MDBX_val *key, MDBX_val *data,
           if (unlikely(level > 1)) {
             /* It is writable only in a parent txn */
             MDBX_page *np = mdbx_page_malloc(mc->mc_txn, ovpages);
-            MDBX_ID2 id2;
             if (unlikely(!np))
               return MDBX_ENOMEM;
-            id2.mid = pg;
-            id2.mptr = np;
             /* Note - this page is already counted in parent's dirtyroom */
-            rc2 = mdbx_mid2l_insert(mc->mc_txn->mt_rw_dirtylist, &id2);
-            mdbx_cassert(mc, rc2 == 0);
+            rc2 = mdbx_dpl_append(mc->mc_txn, pg, np);
+            if (unlikely(rc2 != MDBX_SUCCESS)) {
+              mdbx_dpage_free(env, np);
+              mc->mc_txn->mt_flags |= MDBX_TXN_ERROR;
+              return rc2;
+            }
 
             /* Currently we make the page look as with put() in the
              * parent txn, in case the user peeks at MDBX_RESERVEd
@@ -7237,8 +9870,9 @@ int mdbx_cursor_put(MDBX_cursor *mc, MDBX_val *key, MDBX_val *data,
 
 new_sub:
   nflags = flags & NODE_ADD_FLAGS;
-  nsize = IS_LEAF2(mc->mc_pg[mc->mc_top]) ? key->iov_len
-                                          : mdbx_leaf_size(env, key, rdata);
+  nsize = IS_LEAF2(mc->mc_pg[mc->mc_top])
+              ? key->iov_len
+              : mdbx_leaf_size(env, mc->mc_pg[mc->mc_top], key, rdata);
   if (SIZELEFT(mc->mc_pg[mc->mc_top]) < nsize) {
     if ((flags & (F_DUPDATA | F_SUBDATA)) == F_DUPDATA)
       nflags &= ~MDBX_APPEND; /* sub-page may need room to grow */
@@ -7271,6 +9905,14 @@ new_sub:
     }
   }
 
+  if (unlikely(mc->mc_db->md_split == MDBX_SPLIT_ADAPTIVE) && insert_key &&
+      !(mc->mc_flags & C_SUB) && likely(rc == MDBX_SUCCESS)) {
+    /* remember the insertion point, see mdbx_split_preferred() */
+    MDBX_page *mp = mc->mc_pg[mc->mc_top];
+    if (!IS_LEAF2(mp))
+      mp->mp_last_insert = (uint16_t)(mc->mc_ki[mc->mc_top] + 1);
+  }
+
   if (likely(rc == MDBX_SUCCESS)) {
     /* Now store the actual data in the child DB. Note that we're
      * storing the user data in the keys field, so there are strict
@@ -7336,8 +9978,10 @@ new_sub:
       insert_data = (ecount != (size_t)mc->mc_xcursor->mx_db.md_entries);
     }
     /* Increment count unless we just replaced an existing item. */
-    if (insert_data)
+    if (insert_data) {
       mc->mc_db->md_entries++;
+      mdbx_count_adjust(mc, mc->mc_top, 1);
+    }
     if (insert_key) {
       /* Invalidate txn if we created an empty sub-DB */
       if (unlikely(rc))
@@ -7369,6 +10013,50 @@ new_sub:
   return rc;
 }
 
+int mdbx_cursor_put_batch(MDBX_cursor *mc, const MDBX_val *keys,
+                          size_t count, MDBX_val *data, unsigned flags) {
+  size_t *order = NULL;
+  int rc = MDBX_SUCCESS;
+
+  if (unlikely(!mc || (count && (!keys || !data))))
+    return MDBX_EINVAL;
+
+  if (unlikely(mc->mc_signature != MDBX_MC_SIGNATURE))
+    return MDBX_EBADSIGN;
+
+  if (unlikely(flags & ~(MDBX_NOOVERWRITE | MDBX_NODUPDATA | MDBX_APPEND |
+                         MDBX_APPENDDUP | MDBX_SORTED)))
+    return MDBX_EINVAL;
+
+  if (!(flags & MDBX_SORTED)) {
+    rc = mdbx_batch_order(mc, keys, count, &order);
+    if (unlikely(rc != MDBX_SUCCESS))
+      return rc;
+  }
+  flags &= ~MDBX_SORTED;
+
+  /* each mdbx_cursor_put() positions the cursor by mdbx_cursor_set(),
+   * which is a finger search from the previous pair, i.e. mostly within
+   * the same leaf and without descending from the root. */
+  for (size_t i = 0; i < count; ++i) {
+    const size_t n = order ? order[i] : i;
+    MDBX_val key = keys[n];
+    const int err = mdbx_cursor_put(mc, &key, &data[n], flags);
+    if (unlikely(err != MDBX_SUCCESS)) {
+      if (err == MDBX_KEYEXIST &&
+          (flags & (MDBX_NOOVERWRITE | MDBX_NODUPDATA))) {
+        rc = MDBX_KEYEXIST;
+        continue;
+      }
+      rc = err;
+      break;
+    }
+  }
+
+  free(order);
+  return rc;
+}
+
 int mdbx_cursor_del(MDBX_cursor *mc, unsigned flags) {
   MDBX_node *leaf;
   MDBX_page *mp;
@@ -7407,6 +10095,8 @@ int mdbx_cursor_del(MDBX_cursor *mc, unsigned flags) {
     if (flags & MDBX_NODUPDATA) {
       /* mdbx_cursor_del0() will subtract the final entry */
       mc->mc_db->md_entries -= mc->mc_xcursor->mx_db.md_entries - 1;
+      mdbx_count_adjust(mc, mc->mc_top,
+                        1 - (int64_t)mc->mc_xcursor->mx_db.md_entries);
       mc->mc_xcursor->mx_cursor.mc_flags &= ~C_INITIALIZED;
     } else {
       if (!F_ISSET(leaf->mn_flags, F_SUBDATA)) {
@@ -7447,6 +10137,7 @@ int mdbx_cursor_del(MDBX_cursor *mc, unsigned flags) {
           }
         }
         mc->mc_db->md_entries--;
+        mdbx_count_adjust(mc, mc->mc_top, -1);
         return rc;
       } else {
         mc->mc_xcursor->mx_cursor.mc_flags &= ~C_INITIALIZED;
@@ -7505,8 +10196,14 @@ static int mdbx_page_new(MDBX_cursor *mc, unsigned flags, unsigned num,
     return rc;
   mdbx_debug("allocated new page #%" PRIaPGNO ", size %u", np->mp_pgno,
              mc->mc_txn->mt_env->me_psize);
+  /* nested trees of duplicates and LEAF2 pages have no fingerprints */
+  if ((flags & (P_BRANCH | P_LEAF)) && !(flags & P_LEAF2) &&
+      (mc->mc_db->md_flags & MDBX_FPRINT) && !(mc->mc_flags & C_SUB))
+    flags |= P_FPRINT;
   np->mp_flags = (uint16_t)(flags | P_DIRTY);
-  np->mp_lower = 0;
+  np->mp_lower = (indx_t)PAGELOWER0(np);
+  if (IS_FPRINT(np))
+    PAGEPREFIX(np) = PAGEINDX(np, 1) = 0;
   np->mp_upper = (indx_t)(mc->mc_txn->mt_env->me_psize - PAGEHDRSZ);
 
   if (IS_BRANCH(np))
@@ -7531,12 +10228,13 @@ static int mdbx_page_new(MDBX_cursor *mc, unsigned flags, unsigned num,
  * of the MDBX_node headers.
  *
  * [in] env   The environment handle.
+ * [in] mp    The page to store the node.
  * [in] key   The key for the node.
  * [in] data  The data for the node.
  *
  * Returns The number of bytes needed to store the node. */
-static __inline size_t mdbx_leaf_size(MDBX_env *env, MDBX_val *key,
-                                      MDBX_val *data) {
+static __inline size_t mdbx_leaf_size(MDBX_env *env, const MDBX_page *mp,
+                                      MDBX_val *key, MDBX_val *data) {
   size_t sz;
 
   sz = LEAFSIZE(key, data);
@@ -7545,7 +10243,7 @@ static __inline size_t mdbx_leaf_size(MDBX_env *env, MDBX_val *key,
     sz -= data->iov_len - sizeof(pgno_t);
   }
 
-  return EVEN(sz + sizeof(indx_t));
+  return EVEN(sz + PAGESLOTSZ(mp));
 }
 
 /* Calculate the size of a branch node.
@@ -7553,17 +10251,21 @@ static __inline size_t mdbx_leaf_size(MDBX_env *env, MDBX_val *key,
  * The size should depend on the environment's page size but since
  * we currently don't support spilling large keys onto overflow
  * pages, it's simply the size of the MDBX_node header plus the
- * size of the key. Sizes are always rounded up to an even number
- * of bytes, to guarantee 2-byte alignment of the MDBX_node headers.
+ * size of the key, and of the count for MDBX_COUNTED databases.
+ * Sizes are always rounded up to an even number of bytes, to
+ * guarantee 2-byte alignment of the MDBX_node headers.
  *
- * [in] env The environment handle.
+ * [in] mc  The cursor for the database.
+ * [in] mp  The page to store the node.
  * [in] key The key for the node.
  *
  * Returns The number of bytes needed to store the node. */
-static __inline size_t mdbx_branch_size(MDBX_env *env, MDBX_val *key) {
+static __inline size_t mdbx_branch_size(MDBX_cursor *mc, const MDBX_page *mp,
+                                        MDBX_val *key) {
+  MDBX_env *env = mc->mc_txn->mt_env;
   size_t sz;
 
-  sz = INDXSIZE(key);
+  sz = INDXSIZE(key) + NODECOUNTSZ(mc->mc_db);
   if (unlikely(sz > env->me_nodemax)) {
     /* put on overflow page */
     /* not implemented */
@@ -7572,7 +10274,7 @@ static __inline size_t mdbx_branch_size(MDBX_env *env, MDBX_val *key) {
     sz -= key->iov_len - sizeof(pgno_t);
   }
 
-  return sz + sizeof(indx_t);
+  return sz + PAGESLOTSZ(mp);
 }
 
 /* Add a node to the page pointed to by the cursor.
@@ -7581,7 +10283,8 @@ static __inline size_t mdbx_branch_size(MDBX_env *env, MDBX_val *key) {
  * [in] mc    The cursor for this operation.
  * [in] indx  The index on the page where the new node should be added.
  * [in] key   The key for the new node.
- * [in] data  The data for the new node, if any.
+ * [in] data  The data for the new node, if any. For a branch node of
+ *            MDBX_COUNTED database it points to the count of the subtree.
  * [in] pgno  The page number, if adding a branch node.
  * [in] flags Flags for the node.
  *
@@ -7629,7 +10332,7 @@ static int mdbx_node_add(MDBX_cursor *mc, unsigned indx, MDBX_val *key,
     return MDBX_SUCCESS;
   }
 
-  room = (intptr_t)SIZELEFT(mp) - (intptr_t)sizeof(indx_t);
+  room = (intptr_t)SIZELEFT(mp) - (intptr_t)PAGESLOTSZ(mp);
   if (key != NULL)
     node_size += key->iov_len;
   if (IS_LEAF(mp)) {
@@ -7656,6 +10359,8 @@ static int mdbx_node_add(MDBX_cursor *mc, unsigned indx, MDBX_val *key,
     } else {
       node_size += data->iov_len;
     }
+  } else {
+    node_size += NODECOUNTSZ(mc->mc_db);
   }
   node_size = EVEN(node_size);
   if (unlikely((intptr_t)node_size > room))
@@ -7663,16 +10368,23 @@ static int mdbx_node_add(MDBX_cursor *mc, unsigned indx, MDBX_val *key,
 
 update:
   /* Move higher pointers up one slot. */
-  for (i = NUMKEYS(mp); i > indx; i--)
-    mp->mp_ptrs[i] = mp->mp_ptrs[i - 1];
+  if (IS_FPRINT(mp)) {
+    for (i = NUMKEYS(mp); i > indx; i--) {
+      PAGEPTR(mp, i) = PAGEPTR(mp, i - 1);
+      PAGEFPRINT(mp, i) = PAGEFPRINT(mp, i - 1);
+    }
+  } else {
+    for (i = NUMKEYS(mp); i > indx; i--)
+      mp->mp_ptrs[i] = mp->mp_ptrs[i - 1];
+  }
 
   /* Adjust free space offsets. */
   size_t ofs = mp->mp_upper - node_size;
-  mdbx_cassert(mc, ofs >= mp->mp_lower + sizeof(indx_t));
+  mdbx_cassert(mc, ofs >= mp->mp_lower + PAGESLOTSZ(mp));
   mdbx_cassert(mc, ofs <= UINT16_MAX);
-  mp->mp_ptrs[indx] = (uint16_t)ofs;
+  PAGEPTR(mp, indx) = (uint16_t)ofs;
   mp->mp_upper = (uint16_t)ofs;
-  mp->mp_lower += sizeof(indx_t);
+  mp->mp_lower += (indx_t)PAGESLOTSZ(mp);
 
   /* Write the node data. */
   node = NODEPTR(mp, indx);
@@ -7685,8 +10397,21 @@ update:
 
   if (key)
     memcpy(NODEKEY(node), key->iov_base, key->iov_len);
+  if (IS_FPRINT(mp)) {
+    /* the former first node of a branch-page gets an explicit key */
+    mdbx_fprint_update(mp, indx);
+    if (indx == 0 && IS_BRANCH(mp) && NUMKEYS(mp) > 1)
+      mdbx_fprint_update(mp, 1);
+  }
 
-  if (IS_LEAF(mp)) {
+  if (IS_BRANCH(mp)) {
+    if (mc->mc_db->md_flags & MDBX_COUNTED) {
+      uint64_t count = 0;
+      if (data)
+        memcpy(&count, data->iov_base, sizeof(count));
+      SETCOUNT(node, count);
+    }
+  } else {
     ndata = NODEDATA(node);
     if (unlikely(ofp == NULL)) {
       if (unlikely(F_ISSET(flags, F_BIGDATA)))
@@ -7754,16 +10479,20 @@ static void mdbx_node_del(MDBX_cursor *mc, size_t ksize) {
       sz += sizeof(pgno_t);
     else
       sz += NODEDSZ(node);
+  } else {
+    sz += NODECOUNTSZ(mc->mc_db);
   }
   sz = EVEN(sz);
 
-  ptr = mp->mp_ptrs[indx];
+  ptr = PAGEPTR(mp, indx);
   for (i = j = 0; i < numkeys; i++) {
     if (i != indx) {
-      mp->mp_ptrs[j] = mp->mp_ptrs[i];
-      if (mp->mp_ptrs[i] < ptr) {
-        mdbx_cassert(mc, (size_t)UINT16_MAX - mp->mp_ptrs[j] >= sz);
-        mp->mp_ptrs[j] += (indx_t)sz;
+      PAGEPTR(mp, j) = PAGEPTR(mp, i);
+      if (IS_FPRINT(mp))
+        PAGEFPRINT(mp, j) = PAGEFPRINT(mp, i);
+      if (PAGEPTR(mp, j) < ptr) {
+        mdbx_cassert(mc, (size_t)UINT16_MAX - PAGEPTR(mp, j) >= sz);
+        PAGEPTR(mp, j) += (indx_t)sz;
       }
       j++;
     }
@@ -7772,8 +10501,8 @@ static void mdbx_node_del(MDBX_cursor *mc, size_t ksize) {
   base = (char *)mp + mp->mp_upper + PAGEHDRSZ;
   memmove(base + sz, base, ptr - mp->mp_upper);
 
-  mdbx_cassert(mc, mp->mp_lower >= sizeof(indx_t));
-  mp->mp_lower -= sizeof(indx_t);
+  mdbx_cassert(mc, mp->mp_lower >= PAGELOWER0(mp) + PAGESLOTSZ(mp));
+  mp->mp_lower -= (indx_t)PAGESLOTSZ(mp);
   mdbx_cassert(mc, (size_t)UINT16_MAX - mp->mp_upper >= sz);
   mp->mp_upper += (indx_t)sz;
 }
@@ -7814,11 +10543,11 @@ static void mdbx_node_shrink(MDBX_page *mp, unsigned indx) {
   base = (char *)mp + mp->mp_upper + PAGEHDRSZ;
   memmove(base + delta, base, (char *)sp + len - base);
 
-  ptr = mp->mp_ptrs[indx];
+  ptr = PAGEPTR(mp, indx);
   for (i = NUMKEYS(mp); --i >= 0;) {
-    if (mp->mp_ptrs[i] <= ptr) {
-      assert((size_t)UINT16_MAX - mp->mp_ptrs[i] >= delta);
-      mp->mp_ptrs[i] += (indx_t)delta;
+    if (PAGEPTR(mp, i) <= ptr) {
+      assert((size_t)UINT16_MAX - PAGEPTR(mp, i) >= delta);
+      PAGEPTR(mp, i) += (indx_t)delta;
     }
   }
   assert((size_t)UINT16_MAX - mp->mp_upper >= delta);
@@ -7850,7 +10579,9 @@ static void mdbx_xcursor_init0(MDBX_cursor *mc) {
   mx->mx_dbx.md_name.iov_len = 0;
   mx->mx_dbx.md_name.iov_base = NULL;
   mx->mx_dbx.md_cmp = mc->mc_dbx->md_dcmp;
+  mx->mx_dbx.md_kind = mc->mc_dbx->md_dkind;
   mx->mx_dbx.md_dcmp = NULL;
+  mx->mx_dbx.md_dkind = MDBX_CMP_CUSTOM;
 }
 
 /* Final setup of a sorted-dups cursor.
@@ -7919,6 +10650,7 @@ static void mdbx_xcursor_init2(MDBX_cursor *mc, MDBX_xcursor *src_mx,
     mx->mx_cursor.mc_ki[0] = 0;
     mx->mx_dbflag = DB_VALID | DB_USRVALID | DB_DUPDATA;
     mx->mx_dbx.md_cmp = src_mx->mx_dbx.md_cmp;
+    mx->mx_dbx.md_kind = src_mx->mx_dbx.md_kind;
   } else if (!(mx->mx_cursor.mc_flags & C_INITIALIZED)) {
     return;
   }
@@ -8076,6 +10808,109 @@ int mdbx_cursor_count(MDBX_cursor *mc, size_t *countp) {
   return MDBX_SUCCESS;
 }
 
+int mdbx_cursor_seek_rank(MDBX_cursor *mc, uint64_t rank, MDBX_val *key,
+                          MDBX_val *data) {
+  if (unlikely(mc == NULL))
+    return MDBX_EINVAL;
+
+  if (unlikely(mc->mc_signature != MDBX_MC_SIGNATURE))
+    return MDBX_EBADSIGN;
+
+  if (unlikely(mc->mc_txn->mt_owner != mdbx_thread_self()))
+    return MDBX_THREAD_MISMATCH;
+
+  if (unlikely(mc->mc_txn->mt_flags & MDBX_TXN_BLOCKED))
+    return MDBX_BAD_TXN;
+
+  if (unlikely(!(mc->mc_db->md_flags & MDBX_COUNTED)))
+    return MDBX_INCOMPATIBLE;
+
+  mc->mc_flags &= ~(C_INITIALIZED | C_EOF);
+  if (mc->mc_xcursor)
+    mc->mc_xcursor->mx_cursor.mc_flags &= ~(C_INITIALIZED | C_EOF);
+
+  int rc = mdbx_page_search(mc, NULL, MDBX_PS_ROOTONLY);
+  if (unlikely(rc != MDBX_SUCCESS))
+    return rc;
+  if (rank >= mc->mc_db->md_entries)
+    return MDBX_NOTFOUND;
+  rc = mdbx_cursor_rank_seek(mc, &rank);
+  if (unlikely(rc != MDBX_SUCCESS))
+    return rc;
+  mc->mc_flags |= C_INITIALIZED;
+
+  MDBX_page *mp = mc->mc_pg[mc->mc_top];
+  if (IS_LEAF2(mp)) {
+    if (key) {
+      key->iov_len = mc->mc_db->md_xsize;
+      key->iov_base = LEAF2KEY(mp, mc->mc_ki[mc->mc_top], key->iov_len);
+    }
+    return MDBX_SUCCESS;
+  }
+
+  MDBX_node *leaf = NODEPTR(mp, mc->mc_ki[mc->mc_top]);
+  if (F_ISSET(leaf->mn_flags, F_DUPDATA)) {
+    MDBX_cursor *mx = &mc->mc_xcursor->mx_cursor;
+    mdbx_xcursor_init1(mc, leaf);
+    if (leaf->mn_flags & F_SUBDATA)
+      rc = mdbx_page_search(mx, NULL, MDBX_PS_ROOTONLY);
+    if (likely(rc == MDBX_SUCCESS))
+      rc = mdbx_cursor_rank_seek(mx, &rank);
+    if (unlikely(rc != MDBX_SUCCESS))
+      return rc;
+    mx->mc_flags |= C_INITIALIZED;
+    mx->mc_flags &= ~C_EOF;
+    if (data) {
+      MDBX_page *xp = mx->mc_pg[mx->mc_top];
+      if (IS_LEAF2(xp)) {
+        data->iov_len = mx->mc_db->md_xsize;
+        data->iov_base = LEAF2KEY(xp, mx->mc_ki[mx->mc_top], data->iov_len);
+      } else {
+        MDBX_GET_KEY(NODEPTR(xp, mx->mc_ki[mx->mc_top]), data);
+      }
+    }
+  } else if (data) {
+    rc = mdbx_node_read(mc, leaf, data);
+    if (unlikely(rc != MDBX_SUCCESS))
+      return rc;
+  }
+  MDBX_GET_KEY(leaf, key);
+  return MDBX_SUCCESS;
+}
+
+int mdbx_cursor_get_rank(MDBX_cursor *mc, uint64_t *rank) {
+  if (unlikely(mc == NULL || rank == NULL))
+    return MDBX_EINVAL;
+
+  if (unlikely(mc->mc_signature != MDBX_MC_SIGNATURE))
+    return MDBX_EBADSIGN;
+
+  if (unlikely(mc->mc_txn->mt_owner != mdbx_thread_self()))
+    return MDBX_THREAD_MISMATCH;
+
+  if (unlikely(mc->mc_txn->mt_flags & MDBX_TXN_BLOCKED))
+    return MDBX_BAD_TXN;
+
+  if (unlikely(!(mc->mc_db->md_flags & MDBX_COUNTED)))
+    return MDBX_INCOMPATIBLE;
+
+  if (unlikely(!(mc->mc_flags & C_INITIALIZED)))
+    return MDBX_EINVAL;
+
+  if (!mc->mc_snum)
+    return MDBX_NOTFOUND;
+  MDBX_page *mp = mc->mc_pg[mc->mc_top];
+  if (mc->mc_ki[mc->mc_top] >= NUMKEYS(mp))
+    return MDBX_NOTFOUND;
+
+  *rank = mdbx_cursor_rank(mc);
+  if (!IS_LEAF2(mp) &&
+      F_ISSET(NODEPTR(mp, mc->mc_ki[mc->mc_top])->mn_flags, F_DUPDATA) &&
+      (mc->mc_xcursor->mx_cursor.mc_flags & C_INITIALIZED))
+    *rank += mdbx_cursor_rank(&mc->mc_xcursor->mx_cursor);
+  return MDBX_SUCCESS;
+}
+
 void mdbx_cursor_close(MDBX_cursor *mc) {
   if (mc) {
     mdbx_ensure(NULL, mc->mc_signature == MDBX_MC_SIGNATURE ||
@@ -8130,7 +10965,7 @@ static int mdbx_update_key(MDBX_cursor *mc, MDBX_val *key) {
   indx = mc->mc_ki[mc->mc_top];
   mp = mc->mc_pg[mc->mc_top];
   node = NODEPTR(mp, indx);
-  ptr = mp->mp_ptrs[indx];
+  ptr = PAGEPTR(mp, indx);
   if (MDBX_DEBUG) {
     MDBX_val k2;
     char kbuf2[DKBUF_MAXKEYSIZE * 2 + 1];
@@ -8146,22 +10981,32 @@ static int mdbx_update_key(MDBX_cursor *mc, MDBX_val *key) {
   oksize = EVEN(node->mn_ksize);
   delta = ksize - oksize;
 
+  /* The count of a branch node follows the key, so it is moved too */
+  uint64_t count = 0;
+  const bool counted =
+      IS_BRANCH(mp) && (mc->mc_db->md_flags & MDBX_COUNTED) != 0;
+  if (counted)
+    count = NODECOUNT(node);
+
   /* Shift node contents if EVEN(key length) changed. */
   if (delta) {
     if (delta > 0 && SIZELEFT(mp) < delta) {
       pgno_t pgno;
+      MDBX_val data;
       /* not enough space left, do a delete and split */
       mdbx_debug("Not enough room, delta = %d, splitting...", delta);
       pgno = NODEPGNO(node);
+      data.iov_base = &count;
+      data.iov_len = sizeof(count);
       mdbx_node_del(mc, 0);
-      return mdbx_page_split(mc, key, NULL, pgno, MDBX_SPLIT_REPLACE);
+      return mdbx_page_split(mc, key, &data, pgno, MDBX_SPLIT_REPLACE);
     }
 
     numkeys = NUMKEYS(mp);
     for (i = 0; i < numkeys; i++) {
-      if (mp->mp_ptrs[i] <= ptr) {
-        mdbx_cassert(mc, mp->mp_ptrs[i] >= delta);
-        mp->mp_ptrs[i] -= (indx_t)delta;
+      if (PAGEPTR(mp, i) <= ptr) {
+        mdbx_cassert(mc, PAGEPTR(mp, i) >= delta);
+        PAGEPTR(mp, i) -= (indx_t)delta;
       }
     }
 
@@ -8180,6 +11025,10 @@ static int mdbx_update_key(MDBX_cursor *mc, MDBX_val *key) {
 
   if (key->iov_len)
     memcpy(NODEKEY(node), key->iov_base, key->iov_len);
+  if (counted)
+    SETCOUNT(node, count);
+  if (IS_FPRINT(mp))
+    mdbx_fprint_update(mp, indx);
 
   return MDBX_SUCCESS;
 }
@@ -8214,6 +11063,7 @@ static int mdbx_node_move(MDBX_cursor *csrc, MDBX_cursor *cdst, int fromleft) {
   MDBX_cursor mn;
   int rc;
   unsigned flags;
+  uint64_t entries;
 
   DKBUF;
 
@@ -8229,11 +11079,13 @@ static int mdbx_node_move(MDBX_cursor *csrc, MDBX_cursor *cdst, int fromleft) {
     data.iov_base = NULL;
     srcpg = 0;
     flags = 0;
+    entries = 1;
   } else {
     srcnode = NODEPTR(csrc->mc_pg[csrc->mc_top], csrc->mc_ki[csrc->mc_top]);
     mdbx_cassert(csrc, !((size_t)srcnode & 1));
     srcpg = NODEPGNO(srcnode);
     flags = srcnode->mn_flags;
+    entries = mdbx_node_entries(csrc->mc_pg[csrc->mc_top], srcnode);
     if (csrc->mc_ki[csrc->mc_top] == 0 &&
         IS_BRANCH(csrc->mc_pg[csrc->mc_top])) {
       unsigned snum = csrc->mc_snum;
@@ -8303,6 +11155,16 @@ static int mdbx_node_move(MDBX_cursor *csrc, MDBX_cursor *cdst, int fromleft) {
   /* Delete the node from the source page. */
   mdbx_node_del(csrc, key.iov_len);
 
+  /* Move the items of the node between the counts of the sibling pages. */
+  if (csrc->mc_db->md_flags & MDBX_COUNTED) {
+    MDBX_page *parent = csrc->mc_pg[csrc->mc_top - 1];
+    MDBX_node *src = NODEPTR(parent, csrc->mc_ki[csrc->mc_top - 1]);
+    MDBX_node *dst = NODEPTR(parent, cdst->mc_ki[cdst->mc_top - 1]);
+    mdbx_cassert(csrc, parent == cdst->mc_pg[cdst->mc_top - 1]);
+    SETCOUNT(src, NODECOUNT(src) - entries);
+    SETCOUNT(dst, NODECOUNT(dst) + entries);
+  }
+
   {
     /* Adjust other cursors pointing to mp */
     MDBX_cursor *m2, *m3;
@@ -8509,6 +11371,13 @@ static int mdbx_page_merge(MDBX_cursor *csrc, MDBX_cursor *cdst) {
 
   /* Unlink the src page from parent and add to free list. */
   csrc->mc_top--;
+  if (csrc->mc_db->md_flags & MDBX_COUNTED) {
+    MDBX_page *parent = csrc->mc_pg[csrc->mc_top];
+    MDBX_node *src = NODEPTR(parent, csrc->mc_ki[csrc->mc_top]);
+    MDBX_node *dst = NODEPTR(parent, cdst->mc_ki[csrc->mc_top]);
+    mdbx_cassert(csrc, parent == cdst->mc_pg[csrc->mc_top]);
+    SETCOUNT(dst, NODECOUNT(dst) + NODECOUNT(src));
+  }
   mdbx_node_del(csrc, 0);
   if (csrc->mc_ki[csrc->mc_top] == 0) {
     key.iov_len = 0;
@@ -8610,7 +11479,10 @@ static int mdbx_rebalance(MDBX_cursor *mc) {
     thresh = 1;
   } else {
     minkeys = 1;
-    thresh = FILL_THRESHOLD;
+    /* the merge threshold is in percents, but PAGEFILL() in permilles */
+    thresh = (mc->mc_db->md_merge && !(mc->mc_flags & C_SUB))
+                 ? mc->mc_db->md_merge * 10u
+                 : FILL_THRESHOLD;
   }
   mdbx_debug("rebalancing %s page %" PRIaPGNO " (has %u keys, %.1f%% full)",
              IS_LEAF(mc->mc_pg[mc->mc_top]) ? "leaf" : "branch",
@@ -8791,6 +11663,7 @@ static int mdbx_cursor_del0(MDBX_cursor *mc) {
   mp = mc->mc_pg[mc->mc_top];
   mdbx_node_del(mc, mc->mc_db->md_xsize);
   mc->mc_db->md_entries--;
+  mdbx_count_adjust(mc, mc->mc_top, -1);
   {
     /* Adjust other cursors pointing to mp */
     for (m2 = mc->mc_txn->mt_cursors[dbi]; m2; m2 = m2->mc_next) {
@@ -8933,6 +11806,391 @@ static int mdbx_del0(MDBX_txn *txn, MDBX_dbi dbi, MDBX_val *key, MDBX_val *data,
   return rc;
 }
 
+/* Releases the overflow pages or the nested sub-DB of a leaf node, which is
+ * removed by mdbx_del_range(), and accounts the items of the node. */
+static int mdbx_del_range_node(MDBX_cursor *mc, MDBX_node *node) {
+  uint64_t count = 1;
+  int rc = MDBX_SUCCESS;
+
+  if (F_ISSET(node->mn_flags, F_DUPDATA)) {
+    mdbx_xcursor_init1(mc, node);
+    count = mc->mc_xcursor->mx_db.md_entries;
+    if (node->mn_flags & F_SUBDATA)
+      rc = mdbx_drop0(&mc->mc_xcursor->mx_cursor, 0);
+    mc->mc_xcursor->mx_cursor.mc_flags &= ~(C_INITIALIZED | C_EOF);
+  } else if (unlikely(node->mn_flags & F_SUBDATA)) {
+    /* A record of a named DB, it could be removed only by mdbx_drop() */
+    return MDBX_INCOMPATIBLE;
+  } else if (F_ISSET(node->mn_flags, F_BIGDATA)) {
+    MDBX_page *omp;
+    pgno_t pg;
+
+    memcpy(&pg, NODEDATA(node), sizeof(pg));
+    rc = mdbx_page_get(mc, pg, &omp, NULL);
+    if (likely(rc == MDBX_SUCCESS))
+      rc = mdbx_ovpage_free(mc, omp);
+  }
+  mc->mc_db->md_entries -= count;
+  return rc;
+}
+
+/* Frees a subtree detached by mdbx_del_range(). The pages aren't touched,
+ * but just handed to the txn's free list, or made loose if these are dirty
+ * within the txn. The branch pages are read to reach the children, while
+ * a leaf is read only when it is needed:
+ *  - for the number of items, unless it is known from the count of the
+ *    parent node of an MDBX_COUNTED tree;
+ *  - when the leaf could refer to overflow pages, nested sub-DBs or named
+ *    DBs, then it is scanned node by node;
+ *  - when the leaf could be dirty, since it is made loose by the header.
+ *
+ * [in] mc      The cursor of the DB.
+ * [in] pgno    The root page of the subtree.
+ * [in] height  Number of levels of the subtree, 1 for a leaf.
+ * [in] count   Number of items within the subtree for an MDBX_COUNTED tree,
+ *              otherwise UINT64_MAX.
+ * [in] clean   The parent page wasn't dirty within the txn.
+ *
+ * Returns 0 on success, non-zero on failure. */
+static int mdbx_del_range_subtree(MDBX_cursor *mc, pgno_t pgno,
+                                  unsigned height, uint64_t count,
+                                  bool clean) {
+  MDBX_txn *txn = mc->mc_txn;
+  MDBX_page *mp;
+  int rc;
+
+  const bool scan = (mc->mc_db->md_flags & MDBX_DUPSORT) ||
+                    mc->mc_db->md_overflow_pages || mc->mc_dbi == MAIN_DBI;
+  if (height == 1 && count != UINT64_MAX && !scan) {
+    if (txn->mt_flags & MDBX_TXN_WRITEMAP) {
+      /* There are no lookups of dirty pages with MDBX_WRITEMAP, but the
+       * parents of a dirty page are dirty too, unless these were spilled. */
+      clean &= !txn->mt_spill_pages || !txn->mt_spill_pages[0];
+    } else {
+      /* Just looks for the page within the dirty and spill lists */
+      int level;
+      rc = mdbx_page_get(mc, pgno, &mp, &level);
+      if (unlikely(rc != MDBX_SUCCESS))
+        return rc;
+      clean = (level == 0);
+    }
+    if (clean) {
+      mc->mc_db->md_entries -= count;
+      mc->mc_db->md_leaf_pages--;
+      return mdbx_pnl_append(&txn->mt_befree_pages, pgno);
+    }
+  }
+
+  rc = mdbx_page_get(mc, pgno, &mp, NULL);
+  if (unlikely(rc != MDBX_SUCCESS))
+    return rc;
+
+  const unsigned nkeys = NUMKEYS(mp);
+  if (IS_BRANCH(mp)) {
+    const bool counted = (mc->mc_db->md_flags & MDBX_COUNTED) != 0;
+    for (unsigned i = 0; i < nkeys; i++) {
+      MDBX_node *node = NODEPTR(mp, i);
+      rc = mdbx_del_range_subtree(mc, NODEPGNO(node), height - 1,
+                                  counted ? NODECOUNT(node) : UINT64_MAX,
+                                  !(mp->mp_flags & P_DIRTY));
+      if (unlikely(rc != MDBX_SUCCESS))
+        return rc;
+    }
+    mc->mc_db->md_branch_pages--;
+  } else {
+    if (scan) {
+      for (unsigned i = 0; i < nkeys; i++) {
+        rc = mdbx_del_range_node(mc, NODEPTR(mp, i));
+        if (unlikely(rc != MDBX_SUCCESS))
+          return rc;
+      }
+    } else {
+      mc->mc_db->md_entries -= nkeys;
+    }
+    mc->mc_db->md_leaf_pages--;
+  }
+  return mdbx_page_loose(mc, mp);
+}
+
+/* Body of mdbx_del_range(). Each pass seeks to the first key of the range
+ * and looks for the highest level of the cursor's path, where there are
+ * subtrees fully covered by the range. These subtrees are detached from the
+ * parent and freed as a whole. When there are no such subtrees, the nodes
+ * are deleted from the leaf page under the cursor. Then just this single
+ * page is rebalanced, so the tree stays valid for the next pass. */
+static int mdbx_del_range0(MDBX_cursor *mc, const MDBX_val *begin,
+                           const MDBX_val *end) {
+  for (;;) {
+    MDBX_val key;
+    int rc;
+
+    /* always search from the root, since the path has been changed */
+    mc->mc_flags &= ~(C_INITIALIZED | C_EOF);
+    if (begin) {
+      key = *begin;
+      rc = mdbx_cursor_set(mc, &key, NULL, MDBX_SET_RANGE, NULL);
+    } else {
+      rc = mdbx_cursor_first(mc, &key, NULL);
+    }
+    if (mc->mc_xcursor)
+      mc->mc_xcursor->mx_cursor.mc_flags &= ~(C_INITIALIZED | C_EOF);
+    if (rc != MDBX_SUCCESS)
+      return (rc == MDBX_NOTFOUND) ? MDBX_SUCCESS : rc;
+    if (end && mdbx_cursor_cmp(mc, &key, end) >= 0)
+      return MDBX_SUCCESS;
+
+    /* The subtree of the path at a level is covered too, when the cursor
+     * is on its first key, i.e. on all levels below the edge. */
+    unsigned edge = mc->mc_top;
+    while (edge > 0 && mc->mc_ki[edge] == 0)
+      edge--;
+
+    /* The upper bound of the path's subtree, NULL means the infinity. */
+    MDBX_val upper_key;
+    const MDBX_val *upper = NULL;
+    unsigned level, from = 0, till = 0;
+    for (level = 0; level < mc->mc_top; level++) {
+      MDBX_page *mp = mc->mc_pg[level];
+      const unsigned nkeys = NUMKEYS(mp);
+      const unsigned ki = mc->mc_ki[level];
+      from = (level >= edge) ? ki : ki + 1;
+      for (till = from; end && till < nkeys; till++) {
+        MDBX_val sep;
+        const MDBX_val *bound = upper;
+        if (till + 1 < nkeys) {
+          MDBX_node *node = NODEPTR(mp, till + 1);
+          sep.iov_len = NODEKSZ(node);
+          sep.iov_base = NODEKEY(node);
+          bound = &sep;
+        }
+        if (!bound || mdbx_cursor_cmp(mc, bound, end) > 0)
+          break;
+      }
+      if (!end)
+        till = nkeys;
+      if (till > from)
+        break;
+      if (ki + 1 < nkeys) {
+        MDBX_node *node = NODEPTR(mp, ki + 1);
+        upper_key.iov_len = NODEKSZ(node);
+        upper_key.iov_base = NODEKEY(node);
+        upper = &upper_key;
+      }
+    }
+
+    if (level < mc->mc_top) {
+      /* Detach the covered subtrees, touching the path only up to here. */
+      const unsigned height = mc->mc_snum - level - 1;
+      const bool clean = !(mc->mc_pg[level]->mp_flags & P_DIRTY);
+      mc->mc_snum = (uint16_t)(level + 1);
+      mc->mc_top = (uint16_t)level;
+      if (unlikely((rc = mdbx_page_spill(mc, NULL, NULL)) != MDBX_SUCCESS ||
+                   (rc = mdbx_cursor_touch(mc)) != MDBX_SUCCESS))
+        return rc;
+
+      MDBX_page *mp = mc->mc_pg[level];
+      const uint64_t entries = mc->mc_db->md_entries;
+      const bool counted = (mc->mc_db->md_flags & MDBX_COUNTED) != 0;
+      for (unsigned i = from; i < till; i++) {
+        MDBX_node *node = NODEPTR(mp, i);
+        rc = mdbx_del_range_subtree(mc, NODEPGNO(node), height,
+                                    counted ? NODECOUNT(node) : UINT64_MAX,
+                                    clean);
+        if (unlikely(rc != MDBX_SUCCESS))
+          return rc;
+      }
+      mdbx_count_adjust(mc, level,
+                        -(int64_t)(entries - mc->mc_db->md_entries));
+      mc->mc_ki[level] = (indx_t)from;
+      for (unsigned i = from; i < till; i++)
+        mdbx_node_del(mc, 0);
+
+      if (NUMKEYS(mp) == 0) {
+        /* The range covers the whole tree. */
+        mdbx_cassert(mc, level == 0 && mc->mc_db->md_entries == 0);
+        mc->mc_db->md_branch_pages--;
+        mc->mc_db->md_root = P_INVALID;
+        mc->mc_db->md_depth = 0;
+        mc->mc_snum = 0;
+        mc->mc_top = 0;
+        mc->mc_flags &= ~C_INITIALIZED;
+        return mdbx_page_loose(mc, mp);
+      }
+      if (from == 0) {
+        /* The first node of a branch page must have an empty key */
+        key.iov_len = 0;
+        rc = mdbx_update_key(mc, &key);
+        if (unlikely(rc != MDBX_SUCCESS))
+          return rc;
+      }
+      mc->mc_ki[level] = (indx_t)(from ? from - 1 : 0);
+      rc = mdbx_rebalance(mc);
+      if (unlikely(rc != MDBX_SUCCESS))
+        return rc;
+      continue;
+    }
+
+    /* Delete the nodes of the leaf page at the edge of the range. */
+    if (unlikely((rc = mdbx_page_spill(mc, NULL, NULL)) != MDBX_SUCCESS ||
+                 (rc = mdbx_cursor_touch(mc)) != MDBX_SUCCESS))
+      return rc;
+
+    MDBX_page *mp = mc->mc_pg[mc->mc_top];
+    const uint64_t entries = mc->mc_db->md_entries;
+    bool done = false;
+    while (mc->mc_ki[mc->mc_top] < NUMKEYS(mp)) {
+      MDBX_node *node = NODEPTR(mp, mc->mc_ki[mc->mc_top]);
+      if (end) {
+        key.iov_len = NODEKSZ(node);
+        key.iov_base = NODEKEY(node);
+        if (mdbx_cursor_cmp(mc, &key, end) >= 0) {
+          done = true;
+          break;
+        }
+      }
+      rc = mdbx_del_range_node(mc, node);
+      if (unlikely(rc != MDBX_SUCCESS))
+        return rc;
+      mdbx_node_del(mc, mc->mc_db->md_xsize);
+    }
+    mdbx_count_adjust(mc, mc->mc_top,
+                      -(int64_t)(entries - mc->mc_db->md_entries));
+    rc = mdbx_rebalance(mc);
+    if (unlikely(rc != MDBX_SUCCESS) || done)
+      return rc;
+  }
+}
+
+int mdbx_del_range(MDBX_txn *txn, MDBX_dbi dbi, const MDBX_val *begin,
+                   const MDBX_val *end) {
+  if (unlikely(!txn))
+    return MDBX_EINVAL;
+
+  if (unlikely(txn->mt_signature != MDBX_MT_SIGNATURE))
+    return MDBX_EBADSIGN;
+
+  if (unlikely(txn->mt_owner != mdbx_thread_self()))
+    return MDBX_THREAD_MISMATCH;
+
+  if (unlikely(!TXN_DBI_EXIST(txn, dbi, DB_USRVALID)))
+    return MDBX_EINVAL;
+
+  if (unlikely(TXN_DBI_CHANGED(txn, dbi)))
+    return MDBX_BAD_DBI;
+
+  if (unlikely(txn->mt_flags & (MDBX_TXN_RDONLY | MDBX_TXN_BLOCKED)))
+    return (txn->mt_flags & MDBX_TXN_RDONLY) ? MDBX_EACCESS : MDBX_BAD_TXN;
+
+  MDBX_cursor mc;
+  MDBX_xcursor mx;
+  mdbx_cursor_init(&mc, txn, dbi, &mx);
+  if (begin && end && mdbx_cursor_cmp(&mc, begin, end) >= 0)
+    return MDBX_SUCCESS;
+
+  /* Invalidate the DB's cursors, like mdbx_drop() does */
+  for (MDBX_cursor *m2 = txn->mt_cursors[dbi]; m2; m2 = m2->mc_next) {
+    m2->mc_flags &= ~(C_INITIALIZED | C_EOF);
+    if (m2->mc_xcursor)
+      m2->mc_xcursor->mx_cursor.mc_flags &= ~(C_INITIALIZED | C_EOF);
+  }
+
+  /* let mdbx_page_split() and mdbx_rebalance() know about this cursor */
+  mc.mc_next = txn->mt_cursors[dbi];
+  txn->mt_cursors[dbi] = &mc;
+  int rc = mdbx_del_range0(&mc, begin, end);
+  txn->mt_cursors[dbi] = mc.mc_next;
+  if (unlikely(rc != MDBX_SUCCESS))
+    txn->mt_flags |= MDBX_TXN_ERROR;
+  return rc;
+}
+
+/* Suffix truncation of separators, like B-link trees do.
+ *
+ * Any key which is greater than the last key of the left page and not greater
+ * than the first key of the right page is a valid separator between these
+ * pages. For mdbx_cmp_memn() the shortest one is the prefix of the right key,
+ * which is one byte longer than the common prefix of both keys. The shorter
+ * separators make the branch pages wider and the tree shallower.
+ *
+ * This is only done for leaf pages, since separators of branch pages are
+ * already truncated, and not for LEAF2/INTEGERKEY, since these keys must have
+ * the fixed size. */
+static __inline bool mdbx_separator_truncatable(const MDBX_cursor *mc,
+                                                const MDBX_page *mp) {
+  return mc->mc_dbx->md_kind == MDBX_CMP_MEMN && IS_LEAF(mp) && !IS_LEAF2(mp);
+}
+
+/* Returns the length of the shortest prefix of the right key,
+ * which is still greater than the left key. */
+static size_t mdbx_separator_len(const MDBX_val *left, const MDBX_val *right) {
+  const uint8_t *l = (const uint8_t *)left->iov_base;
+  const uint8_t *r = (const uint8_t *)right->iov_base;
+  const size_t shortest =
+      (left->iov_len < right->iov_len) ? left->iov_len : right->iov_len;
+  size_t common = 0;
+  while (common < shortest && l[common] == r[common])
+    common++;
+  mdbx_assert(NULL, mdbx_cmp_memn(left, right) < 0);
+  return (common < right->iov_len) ? common + 1 : right->iov_len;
+}
+
+/* Returns the split point preferred by the DB's split policy for a leaf-page,
+ * i.e. the index of the first item moved to the right sibling, counting the
+ * new item at newindx. Zero means the default behavior. */
+static unsigned mdbx_split_preferred(const MDBX_cursor *mc,
+                                     const MDBX_page *mp, unsigned newindx,
+                                     unsigned nkeys) {
+  /* the records of nested trees aren't zeroed by former versions */
+  if (!IS_LEAF(mp) || IS_LEAF2(mp) || (mc->mc_flags & C_SUB))
+    return 0;
+
+  switch (mc->mc_db->md_split) {
+  default:
+    return 0;
+  case MDBX_SPLIT_MIDDLE:
+    return (nkeys + 1) / 2;
+  case MDBX_SPLIT_APPEND:
+    /* the new item alone goes to a sibling */
+    if (newindx >= nkeys)
+      return nkeys;
+    return (newindx == 0) ? 1 : 0;
+  case MDBX_SPLIT_ADAPTIVE:
+    if (mp->mp_last_insert == 0)
+      return 0;
+    if (newindx == mp->mp_last_insert)
+      /* ascending run, the new item starts the right page */
+      return newindx;
+    if (newindx + 1u == mp->mp_last_insert && newindx < nkeys)
+      /* descending run, the new item ends the left page */
+      return newindx + 1;
+    return 0;
+  }
+}
+
+/* Checks whether both halves fit into pages, if the page with the new item
+ * of nsize at newindx is split at split_indx. */
+static bool mdbx_split_fits(const MDBX_page *mp, const MDBX_page *copy,
+                            unsigned nkeys, unsigned newindx, size_t nsize,
+                            unsigned split_indx, size_t pmax) {
+  size_t lsize = 0, rsize = 0;
+  for (unsigned i = 0; i <= nkeys; i++) {
+    size_t size = nsize;
+    if (i != newindx) {
+      const MDBX_node *node =
+          (const MDBX_node *)((const char *)mp + copy->mp_ptrs[i] + PAGEHDRSZ);
+      size = NODESIZE + NODEKSZ(node);
+      size += F_ISSET(node->mn_flags, F_BIGDATA) ? sizeof(pgno_t)
+                                                 : NODEDSZ(node);
+      size = EVEN(size) + PAGESLOTSZ(mp);
+    }
+    if (i < split_indx)
+      lsize += size;
+    else
+      rsize += size;
+  }
+  return lsize <= pmax && rsize <= pmax;
+}
+
 /* Split a page and insert a new node.
  * Set MDBX_TXN_ERROR on failure.
  * [in,out] mc Cursor pointing to the page and desired insertion index.
@@ -8955,6 +12213,8 @@ static int mdbx_page_split(MDBX_cursor *mc, MDBX_val *newkey, MDBX_val *newdata,
   MDBX_page *copy = NULL;
   MDBX_page *rp, *pp;
   MDBX_cursor mn;
+  /* items moved to the right sibling, see MDBX_COUNTED */
+  uint64_t moved = 0;
   DKBUF;
 
   MDBX_page *mp = mc->mc_pg[mc->mc_top];
@@ -8990,8 +12250,12 @@ static int mdbx_page_split(MDBX_cursor *mc, MDBX_val *newkey, MDBX_val *newdata,
     mdbx_debug("root split! new root = %" PRIaPGNO "", pp->mp_pgno);
     new_root = mc->mc_db->md_depth++;
 
-    /* Add left (implicit) pointer. */
-    if (unlikely((rc = mdbx_node_add(mc, 0, NULL, NULL, mp->mp_pgno, 0)) !=
+    /* Add left (implicit) pointer, which holds all items of the tree. */
+    uint64_t entries = mc->mc_db->md_entries;
+    MDBX_val count;
+    count.iov_base = &entries;
+    count.iov_len = sizeof(entries);
+    if (unlikely((rc = mdbx_node_add(mc, 0, NULL, &count, mp->mp_pgno, 0)) !=
                  MDBX_SUCCESS)) {
       /* undo the pre-push */
       mc->mc_pg[0] = mc->mc_pg[1];
@@ -9019,6 +12283,11 @@ static int mdbx_page_split(MDBX_cursor *mc, MDBX_val *newkey, MDBX_val *newdata,
     sepkey = *newkey;
     split_indx = newindx;
     nkeys = 0;
+    if (mdbx_separator_truncatable(mc, mp) && NUMKEYS(mp) > 0) {
+      MDBX_val lkey;
+      MDBX_GET_KEY2(NODEPTR(mp, NUMKEYS(mp) - 1), lkey);
+      sepkey.iov_len = mdbx_separator_len(&lkey, &sepkey);
+    }
   } else {
     split_indx = (nkeys + 1) / 2;
 
@@ -9040,6 +12309,7 @@ static int mdbx_page_split(MDBX_cursor *mc, MDBX_val *newkey, MDBX_val *newdata,
       mp->mp_upper += (indx_t)(rsize - lsize);
       mdbx_cassert(mc, rp->mp_upper >= rsize - lsize);
       rp->mp_upper -= (indx_t)(rsize - lsize);
+      moved = nkeys - split_indx;
       sepkey.iov_len = ksize;
       if (newindx == split_indx) {
         sepkey.iov_base = newkey->iov_base;
@@ -9073,11 +12343,11 @@ static int mdbx_page_split(MDBX_cursor *mc, MDBX_val *newkey, MDBX_val *newdata,
     } else {
       size_t psize, nsize, k;
       /* Maximum free space in an empty page */
-      unsigned pmax = env->me_psize - PAGEHDRSZ;
+      unsigned pmax = env->me_psize - PAGEHDRSZ - PAGELOWER0(mp);
       if (IS_LEAF(mp))
-        nsize = mdbx_leaf_size(env, newkey, newdata);
+        nsize = mdbx_leaf_size(env, mp, newkey, newdata);
       else
-        nsize = mdbx_branch_size(env, newkey);
+        nsize = mdbx_branch_size(mc, mp, newkey);
       nsize = EVEN(nsize);
 
       /* grab a page to hold a temporary copy */
@@ -9086,8 +12356,11 @@ static int mdbx_page_split(MDBX_cursor *mc, MDBX_val *newkey, MDBX_val *newdata,
         rc = MDBX_ENOMEM;
         goto done;
       }
+      /* the copy keeps plain mp_ptrs[] even for a P_FPRINT page, since
+       * at first it is an array of offsets within the page being split,
+       * which is overwritten by the left half in place. */
       copy->mp_pgno = mp->mp_pgno;
-      copy->mp_flags = mp->mp_flags;
+      copy->mp_flags = mp->mp_flags & ~P_FPRINT;
       copy->mp_lower = 0;
       mdbx_cassert(mc, env->me_psize - PAGEHDRSZ <= UINT16_MAX);
       copy->mp_upper = (indx_t)(env->me_psize - PAGEHDRSZ);
@@ -9096,7 +12369,7 @@ static int mdbx_page_split(MDBX_cursor *mc, MDBX_val *newkey, MDBX_val *newdata,
       for (unsigned j = i = 0; i < nkeys; i++) {
         if (i == newindx)
           copy->mp_ptrs[j++] = 0;
-        copy->mp_ptrs[j++] = mp->mp_ptrs[i];
+        copy->mp_ptrs[j++] = PAGEPTR(mp, i);
       }
 
       /* When items are relatively large the split point needs
@@ -9115,7 +12388,12 @@ static int mdbx_page_split(MDBX_cursor *mc, MDBX_val *newkey, MDBX_val *newdata,
        * This yields better packing during sequential inserts.
        */
       int dir;
-      if (nkeys < 20 || nsize > pmax / 16 || newindx >= nkeys) {
+      const unsigned preferred = mdbx_split_preferred(mc, mp, newindx, nkeys);
+      if (preferred && mdbx_split_fits(mp, copy, nkeys, newindx, nsize,
+                                       preferred, pmax)) {
+        mdbx_debug("split by policy %u at %u", mc->mc_db->md_split, preferred);
+        split_indx = preferred;
+      } else if (nkeys < 20 || nsize > pmax / 16 || newindx >= nkeys) {
         /* Find split point */
         psize = 0;
         if (newindx <= split_indx || newindx >= nkeys) {
@@ -9133,13 +12411,14 @@ static int mdbx_page_split(MDBX_cursor *mc, MDBX_val *newkey, MDBX_val *newdata,
             node = NULL;
           } else {
             node = (MDBX_node *)((char *)mp + copy->mp_ptrs[i] + PAGEHDRSZ);
-            psize += NODESIZE + NODEKSZ(node) + sizeof(indx_t);
+            psize += NODESIZE + NODEKSZ(node) + PAGESLOTSZ(mp);
             if (IS_LEAF(mp)) {
               if (F_ISSET(node->mn_flags, F_BIGDATA))
                 psize += sizeof(pgno_t);
               else
                 psize += NODEDSZ(node);
-            }
+            } else
+              psize += NODECOUNTSZ(mc->mc_db);
             psize = EVEN(psize);
           }
           if (psize > pmax || i == k - dir) {
@@ -9157,13 +12436,42 @@ static int mdbx_page_split(MDBX_cursor *mc, MDBX_val *newkey, MDBX_val *newdata,
         sepkey.iov_len = node->mn_ksize;
         sepkey.iov_base = NODEKEY(node);
       }
+      if (mdbx_separator_truncatable(mc, mp) && split_indx > 0) {
+        MDBX_val lkey;
+        if (split_indx - 1 == newindx) {
+          lkey = *newkey;
+        } else {
+          node = (MDBX_node *)((char *)mp + copy->mp_ptrs[split_indx - 1] +
+                               PAGEHDRSZ);
+          MDBX_GET_KEY2(node, lkey);
+        }
+        sepkey.iov_len = mdbx_separator_len(&lkey, &sepkey);
+      }
+
+      if (mc->mc_db->md_flags & MDBX_COUNTED) {
+        /* the replacing item is already counted, but not a new one */
+        for (i = split_indx; i <= nkeys; i++) {
+          if (i != newindx) {
+            node = (MDBX_node *)((char *)mp + copy->mp_ptrs[i] + PAGEHDRSZ);
+            moved += mdbx_node_entries(mp, node);
+          } else if (nflags & MDBX_SPLIT_REPLACE) {
+            uint64_t entries;
+            if (IS_LEAF(mp))
+              entries = mdbx_leaf_entries(nflags, newdata->iov_base);
+            else
+              memcpy(&entries, newdata->iov_base, sizeof(entries));
+            moved += entries;
+          }
+        }
+      }
     }
   }
 
   mdbx_debug("separator is %d [%s]", split_indx, DKEY(&sepkey));
 
   /* Copy separator key to the parent. */
-  if (SIZELEFT(mn.mc_pg[ptop]) < mdbx_branch_size(env, &sepkey)) {
+  if (SIZELEFT(mn.mc_pg[ptop]) <
+      mdbx_branch_size(mc, mn.mc_pg[ptop], &sepkey)) {
     int snum = mc->mc_snum;
     mn.mc_snum--;
     mn.mc_top--;
@@ -9207,6 +12515,11 @@ static int mdbx_page_split(MDBX_cursor *mc, MDBX_val *newkey, MDBX_val *newdata,
     }
     goto done;
   }
+  if (moved) {
+    /* Move the counts from the path of the left page to the right one. */
+    mdbx_count_adjust(mc, ptop + 1, -(int64_t)moved);
+    mdbx_count_adjust(&mn, ptop + 1, (int64_t)moved);
+  }
   if (nflags & MDBX_APPEND) {
     mc->mc_pg[mc->mc_top] = rp;
     mc->mc_ki[mc->mc_top] = 0;
@@ -9224,9 +12537,8 @@ static int mdbx_page_split(MDBX_cursor *mc, MDBX_val *newkey, MDBX_val *newdata,
       if (i == newindx) {
         rkey.iov_base = newkey->iov_base;
         rkey.iov_len = newkey->iov_len;
-        if (IS_LEAF(mp)) {
-          rdata = newdata;
-        } else
+        rdata = newdata;
+        if (!IS_LEAF(mp))
           pgno = newpgno;
         flags = nflags;
         /* Update index for the new key. */
@@ -9235,12 +12547,15 @@ static int mdbx_page_split(MDBX_cursor *mc, MDBX_val *newkey, MDBX_val *newdata,
         node = (MDBX_node *)((char *)mp + copy->mp_ptrs[i] + PAGEHDRSZ);
         rkey.iov_base = NODEKEY(node);
         rkey.iov_len = node->mn_ksize;
-        if (IS_LEAF(mp)) {
-          xdata.iov_base = NODEDATA(node);
+        xdata.iov_base = NODEDATA(node);
+        if (IS_LEAF(mp))
           xdata.iov_len = NODEDSZ(node);
-          rdata = &xdata;
-        } else
+        else {
+          /* the count of a branch node, see MDBX_COUNTED */
+          xdata.iov_len = NODECOUNTSZ(mc->mc_db);
           pgno = NODEPGNO(node);
+        }
+        rdata = &xdata;
         flags = node->mn_flags;
       }
 
@@ -9263,12 +12578,23 @@ static int mdbx_page_split(MDBX_cursor *mc, MDBX_val *newkey, MDBX_val *newdata,
     } while (i != split_indx);
 
     nkeys = NUMKEYS(copy);
+    if (unlikely(PAGELOWER0(mp) + nkeys * PAGESLOTSZ(mp) > copy->mp_upper)) {
+      /* the left half doesn't fit with the fingerprints */
+      mc->mc_txn->mt_flags |= MDBX_TXN_ERROR;
+      rc = MDBX_PAGE_FULL;
+      goto done;
+    }
     for (i = 0; i < nkeys; i++)
-      mp->mp_ptrs[i] = copy->mp_ptrs[i];
-    mp->mp_lower = copy->mp_lower;
+      PAGEPTR(mp, i) = copy->mp_ptrs[i];
+    mp->mp_lower = (indx_t)(PAGELOWER0(mp) + nkeys * PAGESLOTSZ(mp));
     mp->mp_upper = copy->mp_upper;
     memcpy(NODEPTR(mp, nkeys - 1), NODEPTR(copy, nkeys - 1),
            env->me_psize - copy->mp_upper - PAGEHDRSZ);
+    if (IS_FPRINT(mp)) {
+      /* both halves get the longest common prefixes */
+      mdbx_fprint_rebuild(mp);
+      mdbx_fprint_rebuild(rp);
+    }
 
     /* reset back to original page */
     if (newindx < split_indx) {
@@ -9422,6 +12748,319 @@ int mdbx_put(MDBX_txn *txn, MDBX_dbi dbi, MDBX_val *key, MDBX_val *data,
   return rc;
 }
 
+int mdbx_put_batch(MDBX_txn *txn, MDBX_dbi dbi, const MDBX_val *keys,
+                   size_t count, MDBX_val *data, unsigned flags) {
+  MDBX_cursor mc;
+  MDBX_xcursor mx;
+
+  if (unlikely(!txn || (count && (!keys || !data))))
+    return MDBX_EINVAL;
+
+  if (unlikely(txn->mt_signature != MDBX_MT_SIGNATURE))
+    return MDBX_EBADSIGN;
+
+  if (unlikely(txn->mt_owner != mdbx_thread_self()))
+    return MDBX_THREAD_MISMATCH;
+
+  if (unlikely(!TXN_DBI_EXIST(txn, dbi, DB_USRVALID)))
+    return MDBX_EINVAL;
+
+  if (unlikely(flags & ~(MDBX_NOOVERWRITE | MDBX_NODUPDATA | MDBX_APPEND |
+                         MDBX_APPENDDUP | MDBX_SORTED)))
+    return MDBX_EINVAL;
+
+  if (unlikely(txn->mt_flags & (MDBX_TXN_RDONLY | MDBX_TXN_BLOCKED)))
+    return (txn->mt_flags & MDBX_TXN_RDONLY) ? MDBX_EACCESS : MDBX_BAD_TXN;
+
+  mdbx_cursor_init(&mc, txn, dbi, &mx);
+  mc.mc_next = txn->mt_cursors[dbi];
+  txn->mt_cursors[dbi] = &mc;
+  int rc = mdbx_cursor_put_batch(&mc, keys, count, data, flags);
+  txn->mt_cursors[dbi] = mc.mc_next;
+
+  return rc;
+}
+
+/*----------------------------------------------------------------------------*/
+/* Bulk loading: the tree is built bottom-up from sorted pairs, the cursor
+ * holds the right edge of it, i.e. the last page of each level. */
+
+/* Links the new page as the right sibling of the page at the given level of
+ * the right edge. Grows the tree if that page is the root, and starts a new
+ * parent page if the current one is full.
+ * The sepkey is the separator for the new page, i.e. its first key. */
+static int mdbx_bulk_link(MDBX_cursor *mc, unsigned level, MDBX_val *sepkey,
+                          MDBX_page *np, size_t limit) {
+  MDBX_env *env = mc->mc_txn->mt_env;
+  int rc;
+
+  if (level == 0) {
+    /* the page is the root, so grow the tree */
+    MDBX_page *rp;
+    if (unlikely(mc->mc_snum >= CURSOR_STACK)) {
+      mc->mc_txn->mt_flags |= MDBX_TXN_ERROR;
+      return MDBX_CURSOR_FULL;
+    }
+    rc = mdbx_page_new(mc, P_BRANCH, 1, &rp);
+    if (unlikely(rc != MDBX_SUCCESS))
+      return rc;
+    mdbx_debug("bulk: new root page %" PRIaPGNO, rp->mp_pgno);
+    memmove(mc->mc_pg + 1, mc->mc_pg, mc->mc_snum * sizeof(mc->mc_pg[0]));
+    memmove(mc->mc_ki + 1, mc->mc_ki, mc->mc_snum * sizeof(mc->mc_ki[0]));
+    mc->mc_pg[0] = rp;
+    mc->mc_ki[0] = 0;
+    mc->mc_snum++;
+    mc->mc_top = 0;
+    mc->mc_db->md_root = rp->mp_pgno;
+    mc->mc_db->md_depth++;
+    /* the count of a moving node is off the path, see below */
+    uint64_t entries = 0;
+    MDBX_val count;
+    count.iov_base = &entries;
+    count.iov_len = sizeof(entries);
+    if (mc->mc_db->md_flags & MDBX_COUNTED) {
+      for (unsigned i = 0; i < NUMKEYS(mc->mc_pg[1]); i++)
+        entries += mdbx_node_entries(mc->mc_pg[1], NODEPTR(mc->mc_pg[1], i));
+    }
+    rc = mdbx_node_add(mc, 0, NULL, &count, mc->mc_pg[1]->mp_pgno, 0);
+    mc->mc_top = mc->mc_snum - 1;
+    if (unlikely(rc != MDBX_SUCCESS))
+      return rc;
+    level = 1;
+  }
+
+  MDBX_page *parent = mc->mc_pg[level - 1];
+  const size_t size = mdbx_branch_size(mc, parent, sepkey);
+  const size_t used = env->me_psize - PAGEHDRSZ - SIZELEFT(parent);
+  /* a page closed by the fill factor keeps at least 3 children,
+   * so it could give one to the right sibling by mdbx_rebalance() */
+  if (size > SIZELEFT(parent) || (NUMKEYS(parent) > 2 && used + size > limit)) {
+    /* the parent is full, so start its right sibling */
+    MDBX_page *pp;
+    rc = mdbx_page_new(mc, P_BRANCH, 1, &pp);
+    if (unlikely(rc != MDBX_SUCCESS))
+      return rc;
+
+    /* the last child of the full parent is moved into the new page,
+     * so a branch-page of the right edge never has the single child,
+     * unless the parent has only two children. */
+    const unsigned nkeys = NUMKEYS(parent);
+    MDBX_node *node = NODEPTR(parent, nkeys - 1);
+    MDBX_val lastkey;
+    lastkey.iov_base = NODEKEY(node);
+    lastkey.iov_len = NODEKSZ(node);
+
+    /* the items of the moving node are taken off the path of the right
+     * edge, and then are added to the new one */
+    uint64_t entries = 0;
+    MDBX_val count;
+    count.iov_base = &entries;
+    count.iov_len = sizeof(entries);
+    if (nkeys > 2 && (mc->mc_db->md_flags & MDBX_COUNTED)) {
+      entries = NODECOUNT(node);
+      SETCOUNT(node, 0);
+      mdbx_count_adjust(mc, level - 1, -(int64_t)entries);
+    }
+
+    const unsigned snum = mc->mc_snum;
+    rc = mdbx_bulk_link(mc, level - 1, (nkeys > 2) ? &lastkey : sepkey, pp,
+                        limit);
+    if (unlikely(rc != MDBX_SUCCESS))
+      return rc;
+    level += mc->mc_snum - snum;
+
+    if (nkeys > 2) {
+      mc->mc_top = level - 1;
+      /* the key of the first node of a branch-page is implicit */
+      rc = mdbx_node_add(mc, 0, NULL, &count, NODEPGNO(node), 0);
+      if (unlikely(rc != MDBX_SUCCESS))
+        return rc;
+      mc->mc_pg[level - 1] = parent;
+      mc->mc_ki[level - 1] = (indx_t)(nkeys - 1);
+      mdbx_node_del(mc, 0);
+      mc->mc_pg[level - 1] = pp;
+      mdbx_count_adjust(mc, level - 1, (int64_t)entries);
+      mc->mc_top = mc->mc_snum - 1;
+    } else
+      sepkey = NULL;
+    parent = pp;
+  }
+
+  mdbx_cassert(mc, mc->mc_pg[level - 1] == parent);
+  mc->mc_top = level - 1;
+  rc = mdbx_node_add(mc, NUMKEYS(parent), sepkey, NULL, np->mp_pgno, 0);
+  mc->mc_top = mc->mc_snum - 1;
+  if (unlikely(rc != MDBX_SUCCESS))
+    return rc;
+  mc->mc_ki[level - 1] = (indx_t)(NUMKEYS(parent) - 1);
+  mc->mc_pg[level] = np;
+  mc->mc_ki[level] = 0;
+  return MDBX_SUCCESS;
+}
+
+/* Appends the pair to the last leaf, or to the new one
+ * if the pair doesn't fit or the fill limit is reached. */
+static int mdbx_bulk_append(MDBX_cursor *mc, MDBX_val *key, MDBX_val *data,
+                            size_t limit) {
+  MDBX_env *env = mc->mc_txn->mt_env;
+  MDBX_page *mp = mc->mc_pg[mc->mc_top];
+  const size_t size = mdbx_leaf_size(env, mp, key, data);
+  const size_t used = env->me_psize - PAGEHDRSZ - SIZELEFT(mp);
+  int rc;
+
+  if (NUMKEYS(mp) && (size > SIZELEFT(mp) || used + size > limit)) {
+    MDBX_page *np;
+    rc = mdbx_page_new(mc, P_LEAF, 1, &np);
+    if (unlikely(rc != MDBX_SUCCESS))
+      return rc;
+    MDBX_val sepkey = *key;
+    if (mdbx_separator_truncatable(mc, mp)) {
+      MDBX_val last;
+      MDBX_GET_KEY2(NODEPTR(mp, NUMKEYS(mp) - 1), last);
+      sepkey.iov_len = mdbx_separator_len(&last, key);
+    }
+    rc = mdbx_bulk_link(mc, mc->mc_top, &sepkey, np, limit);
+    if (unlikely(rc != MDBX_SUCCESS))
+      return rc;
+    mp = np;
+  }
+
+  rc = mdbx_node_add(mc, NUMKEYS(mp), key, data, 0, 0);
+  if (unlikely(rc != MDBX_SUCCESS))
+    return rc;
+  mc->mc_ki[mc->mc_top] = (indx_t)(NUMKEYS(mp) - 1);
+  mc->mc_db->md_entries++;
+  mdbx_count_adjust(mc, mc->mc_top, 1);
+  return MDBX_SUCCESS;
+}
+
+/* The pages of the right edge are never empty, but the last branch-page of
+ * a level still could get the single child (see mdbx_bulk_link), then it is
+ * rebalanced the same way as after a deletion. */
+static int mdbx_bulk_finish(MDBX_cursor *mc) {
+  for (;;) {
+    unsigned level = 1;
+    while (level < mc->mc_top && NUMKEYS(mc->mc_pg[level]) > 1)
+      ++level;
+    if (level >= mc->mc_top)
+      return MDBX_SUCCESS;
+
+    mdbx_debug("bulk: rebalance page %" PRIaPGNO " of level %u",
+               mc->mc_pg[level]->mp_pgno, level);
+    mc->mc_top = level;
+    mc->mc_snum = level + 1;
+    int rc = mdbx_rebalance(mc);
+    if (unlikely(rc != MDBX_SUCCESS))
+      return rc;
+
+    mc->mc_flags &= ~C_INITIALIZED;
+    rc = mdbx_page_search(mc, NULL, MDBX_PS_LAST);
+    if (unlikely(rc != MDBX_SUCCESS))
+      return rc;
+  }
+}
+
+int mdbx_bulk_load(MDBX_txn *txn, MDBX_dbi dbi, MDBX_bulk_func *next,
+                   void *context, unsigned fill_percent) {
+  MDBX_cursor mc;
+  MDBX_val key, data;
+  int rc;
+
+  if (unlikely(!txn || !next || fill_percent > 100))
+    return MDBX_EINVAL;
+
+  if (unlikely(txn->mt_signature != MDBX_MT_SIGNATURE))
+    return MDBX_EBADSIGN;
+
+  if (unlikely(txn->mt_owner != mdbx_thread_self()))
+    return MDBX_THREAD_MISMATCH;
+
+  if (unlikely(!TXN_DBI_EXIST(txn, dbi, DB_USRVALID)))
+    return MDBX_EINVAL;
+
+  if (unlikely(txn->mt_flags & (MDBX_TXN_RDONLY | MDBX_TXN_BLOCKED)))
+    return (txn->mt_flags & MDBX_TXN_RDONLY) ? MDBX_EACCESS : MDBX_BAD_TXN;
+
+  if (unlikely(txn->mt_dbs[dbi].md_flags & MDBX_DUPSORT))
+    return MDBX_INCOMPATIBLE;
+
+  mdbx_cursor_init(&mc, txn, dbi, NULL);
+  /* also refreshes the stale record of a named DB */
+  rc = mdbx_page_search(&mc, NULL, MDBX_PS_ROOTONLY);
+  if (rc != MDBX_NOTFOUND)
+    return (rc == MDBX_SUCCESS) ? MDBX_EINVAL /* not empty */ : rc;
+  mc.mc_next = txn->mt_cursors[dbi];
+  txn->mt_cursors[dbi] = &mc;
+
+  MDBX_env *env = txn->mt_env;
+  const size_t limit =
+      (env->me_psize - PAGEHDRSZ) * (fill_percent ? fill_percent : 100) / 100;
+  mdbx_debug("bulk: load db %d, fill limit %" PRIuPTR, DDBI(&mc), limit);
+
+  for (;;) {
+    rc = next(context, &key, &data);
+    if (rc != MDBX_SUCCESS) {
+      if (rc == MDBX_NOTFOUND)
+        rc = MDBX_SUCCESS;
+      break;
+    }
+
+    if (unlikely(key.iov_len > env->me_maxkey_limit ||
+                 data.iov_len > MDBX_MAXDATASIZE)) {
+      rc = MDBX_BAD_VALSIZE;
+      break;
+    }
+    if ((mc.mc_db->md_flags & MDBX_INTEGERKEY) &&
+        unlikely(key.iov_len != sizeof(uint32_t) &&
+                 key.iov_len != sizeof(uint64_t))) {
+      rc = MDBX_BAD_VALSIZE;
+      break;
+    }
+
+    if (likely(mc.mc_flags & C_INITIALIZED)) {
+      MDBX_page *mp = mc.mc_pg[mc.mc_top];
+      MDBX_val last;
+      MDBX_GET_KEY2(NODEPTR(mp, NUMKEYS(mp) - 1), last);
+      if (mdbx_cursor_cmp(&mc, &key, &last) <= 0) {
+        /* the stream is not sorted, the pair is left to the caller */
+        rc = MDBX_EKEYMISMATCH;
+        break;
+      }
+    }
+
+    rc = mdbx_page_spill(&mc, &key, &data);
+    if (unlikely(rc != MDBX_SUCCESS))
+      break;
+
+    if (unlikely(!(mc.mc_flags & C_INITIALIZED))) {
+      MDBX_page *np;
+      rc = mdbx_page_new(&mc, P_LEAF, 1, &np);
+      if (unlikely(rc != MDBX_SUCCESS))
+        break;
+      mc.mc_snum = 0;
+      rc = mdbx_cursor_push(&mc, np);
+      if (unlikely(rc != MDBX_SUCCESS))
+        break;
+      mc.mc_db->md_root = np->mp_pgno;
+      mc.mc_db->md_depth = 1;
+      *mc.mc_dbflag |= DB_DIRTY;
+      mc.mc_flags |= C_INITIALIZED;
+    }
+
+    rc = mdbx_bulk_append(&mc, &key, &data, limit);
+    if (unlikely(rc != MDBX_SUCCESS))
+      break;
+  }
+
+  if ((mc.mc_flags & C_INITIALIZED) && !(txn->mt_flags & MDBX_TXN_ERROR)) {
+    int err = mdbx_bulk_finish(&mc);
+    if (unlikely(err != MDBX_SUCCESS))
+      rc = err;
+  }
+  txn->mt_cursors[dbi] = mc.mc_next;
+  return rc;
+}
+
 #ifndef MDBX_WBUF
 #define MDBX_WBUF (1024 * 1024)
 #endif
@@ -9744,6 +13383,11 @@ static int __cold mdbx_env_compact(MDBX_env *env, mdbx_filehandle_t fd) {
     meta->mp_meta.mm_dbs[MAIN_DBI].md_flags = txn->mt_dbs[MAIN_DBI].md_flags;
   }
 
+  /* the features of the format, which are never dropped */
+  meta->mp_meta.mm_extra_flags = mdbx_meta_head(env)->mm_extra_flags;
+  if (meta->mp_meta.mm_extra_flags)
+    meta->mp_meta.mm_magic_and_version = MDBX_DATA_MAGIC_EXTRA;
+
   /* copy canary sequenses if present */
   if (txn->mt_canary.v) {
     meta->mp_meta.mm_canary = txn->mt_canary;
@@ -10069,6 +13713,7 @@ static int mdbx_dbi_bind(MDBX_txn *txn, const MDBX_dbi dbi, unsigned user_flags,
       keycmp = mdbx_default_keycmp(user_flags);
     assert(!txn->mt_dbxs[dbi].md_cmp || txn->mt_dbxs[dbi].md_cmp == keycmp);
     txn->mt_dbxs[dbi].md_cmp = keycmp;
+    txn->mt_dbxs[dbi].md_kind = mdbx_cmp_kind(keycmp);
   }
 
   if (!txn->mt_dbxs[dbi].md_dcmp || MDBX_DEBUG) {
@@ -10076,6 +13721,7 @@ static int mdbx_dbi_bind(MDBX_txn *txn, const MDBX_dbi dbi, unsigned user_flags,
       datacmp = mdbx_default_datacmp(user_flags);
     assert(!txn->mt_dbxs[dbi].md_dcmp || txn->mt_dbxs[dbi].md_dcmp == datacmp);
     txn->mt_dbxs[dbi].md_dcmp = datacmp;
+    txn->mt_dbxs[dbi].md_dkind = mdbx_cmp_kind(datacmp);
   }
 
   return MDBX_SUCCESS;
@@ -10086,6 +13732,9 @@ int mdbx_dbi_open_ex(MDBX_txn *txn, const char *table_name, unsigned user_flags,
                      MDBX_cmp_func *datacmp) {
   if (unlikely(!txn || !dbi || (user_flags & ~VALID_FLAGS) != 0))
     return MDBX_EINVAL;
+  if (unlikely((user_flags & MDBX_FPRINT) &&
+               (user_flags & (MDBX_REVERSEKEY | MDBX_INTEGERKEY))))
+    return MDBX_EINVAL;
 
   if (unlikely(txn->mt_signature != MDBX_MT_SIGNATURE))
     return MDBX_EBADSIGN;
@@ -10105,8 +13754,12 @@ int mdbx_dbi_open_ex(MDBX_txn *txn, const char *table_name, unsigned user_flags,
   if (txn->mt_dbxs[MAIN_DBI].md_cmp == NULL) {
     txn->mt_dbxs[MAIN_DBI].md_cmp =
         mdbx_default_keycmp(txn->mt_dbs[MAIN_DBI].md_flags);
+    txn->mt_dbxs[MAIN_DBI].md_kind =
+        mdbx_cmp_kind(txn->mt_dbxs[MAIN_DBI].md_cmp);
     txn->mt_dbxs[MAIN_DBI].md_dcmp =
         mdbx_default_datacmp(txn->mt_dbs[MAIN_DBI].md_flags);
+    txn->mt_dbxs[MAIN_DBI].md_dkind =
+        mdbx_cmp_kind(txn->mt_dbxs[MAIN_DBI].md_dcmp);
   }
 
   /* Is the DB already open? */
@@ -10192,6 +13845,7 @@ int mdbx_dbi_open_ex(MDBX_txn *txn, const char *table_name, unsigned user_flags,
   txn->mt_dbxs[slot].md_name.iov_len = len;
   txn->mt_dbxs[slot].md_cmp = nullptr;
   txn->mt_dbxs[slot].md_dcmp = nullptr;
+  txn->mt_dbxs[slot].md_kind = txn->mt_dbxs[slot].md_dkind = MDBX_CMP_CUSTOM;
   txn->mt_dbflags[slot] = (uint8_t)dbflag;
   txn->mt_dbiseqs[slot] = (env->me_dbiseqs[slot] += 1);
 
@@ -10303,6 +13957,82 @@ int mdbx_dbi_flags(MDBX_txn *txn, MDBX_dbi dbi, unsigned *flags) {
   return mdbx_dbi_flags_ex(txn, dbi, flags, &state);
 }
 
+int mdbx_dbi_set_policy(MDBX_txn *txn, MDBX_dbi dbi, unsigned policy,
+                        unsigned merge) {
+  if (unlikely(!txn || policy > MDBX_SPLIT_ADAPTIVE || merge > 50))
+    return MDBX_EINVAL;
+
+  if (unlikely(txn->mt_signature != MDBX_MT_SIGNATURE))
+    return MDBX_EBADSIGN;
+
+  if (unlikely(txn->mt_owner != mdbx_thread_self()))
+    return MDBX_THREAD_MISMATCH;
+
+  if (unlikely(!TXN_DBI_EXIST(txn, dbi, DB_USRVALID)))
+    return MDBX_EINVAL;
+
+  if (unlikely(TXN_DBI_CHANGED(txn, dbi)))
+    return MDBX_BAD_DBI;
+
+  if (unlikely(txn->mt_flags & MDBX_TXN_BLOCKED))
+    return MDBX_BAD_TXN;
+
+  if (unlikely(F_ISSET(txn->mt_flags, MDBX_TXN_RDONLY)))
+    return MDBX_EACCESS;
+
+  if (unlikely(txn->mt_dbflags[dbi] & DB_STALE)) {
+    MDBX_cursor mc;
+    MDBX_xcursor mx;
+    /* Stale, must read the DB's root. cursor_init does it for us. */
+    mdbx_cursor_init(&mc, txn, dbi, &mx);
+    if (unlikely(txn->mt_dbflags[dbi] & DB_STALE))
+      return MDBX_BAD_DBI;
+  }
+
+  MDBX_db *db = &txn->mt_dbs[dbi];
+  if (db->md_split != policy || db->md_merge != merge) {
+    db->md_split = (uint8_t)policy;
+    db->md_merge = (uint8_t)merge;
+    txn->mt_flags |= MDBX_TXN_DIRTY;
+    txn->mt_dbflags[dbi] |= DB_DIRTY;
+  }
+  return MDBX_SUCCESS;
+}
+
+int mdbx_dbi_get_policy(MDBX_txn *txn, MDBX_dbi dbi, unsigned *policy,
+                        unsigned *merge) {
+  if (unlikely(!txn || !policy || !merge))
+    return MDBX_EINVAL;
+
+  if (unlikely(txn->mt_signature != MDBX_MT_SIGNATURE))
+    return MDBX_EBADSIGN;
+
+  if (unlikely(txn->mt_owner != mdbx_thread_self()))
+    return MDBX_THREAD_MISMATCH;
+
+  if (unlikely(!TXN_DBI_EXIST(txn, dbi, DB_USRVALID)))
+    return MDBX_EINVAL;
+
+  if (unlikely(TXN_DBI_CHANGED(txn, dbi)))
+    return MDBX_BAD_DBI;
+
+  if (unlikely(txn->mt_flags & MDBX_TXN_BLOCKED))
+    return MDBX_BAD_TXN;
+
+  if (unlikely(txn->mt_dbflags[dbi] & DB_STALE)) {
+    MDBX_cursor mc;
+    MDBX_xcursor mx;
+    /* Stale, must read the DB's root. cursor_init does it for us. */
+    mdbx_cursor_init(&mc, txn, dbi, &mx);
+    if (unlikely(txn->mt_dbflags[dbi] & DB_STALE))
+      return MDBX_BAD_DBI;
+  }
+
+  *policy = txn->mt_dbs[dbi].md_split;
+  *merge = txn->mt_dbs[dbi].md_merge;
+  return MDBX_SUCCESS;
+}
+
 /* Add all the DB's pages to the free list.
  * [in] mc Cursor on the DB to free.
  * [in] subs non-Zero to check for sub-DBs in this DB.
@@ -10488,6 +14218,7 @@ int mdbx_set_compare(MDBX_txn *txn, MDBX_dbi dbi, MDBX_cmp_func *cmp) {
     return MDBX_EINVAL;
 
   txn->mt_dbxs[dbi].md_cmp = cmp;
+  txn->mt_dbxs[dbi].md_kind = mdbx_cmp_kind(cmp);
   return MDBX_SUCCESS;
 }
 
@@ -10505,6 +14236,7 @@ int mdbx_set_dupsort(MDBX_txn *txn, MDBX_dbi dbi, MDBX_cmp_func *cmp) {
     return MDBX_EINVAL;
 
   txn->mt_dbxs[dbi].md_dcmp = cmp;
+  txn->mt_dbxs[dbi].md_dkind = mdbx_cmp_kind(cmp);
   return MDBX_SUCCESS;
 }
 
@@ -10861,9 +14593,12 @@ typedef struct mdbx_walk_ctx {
   MDBX_pgvisitor_func *mw_visitor;
 } mdbx_walk_ctx_t;
 
-/* Depth-first tree traversal. */
+/* Depth-first tree traversal.
+ * The flags are of the tree's DB, the items of the tree are added to the
+ * entries and are checked against the counts of a MDBX_COUNTED tree. */
 static int __cold mdbx_env_walk(mdbx_walk_ctx_t *ctx, const char *dbi,
-                                pgno_t pg, int deep) {
+                                pgno_t pg, unsigned flags, int deep,
+                                uint64_t *entries) {
   MDBX_page *mp;
   int rc, i, nkeys;
   size_t header_size, unused_size, payload_size, align_bytes;
@@ -10893,11 +14628,13 @@ static int __cold mdbx_env_walk(mdbx_walk_ctx_t *ctx, const char *dbi,
    * Pages should not me marked dirty/loose or otherwise. */
   switch (mp->mp_flags) {
   case P_BRANCH:
+  case P_BRANCH | P_FPRINT:
     type = "branch";
     if (nkeys < 1)
       return MDBX_CORRUPTED;
     break;
   case P_LEAF:
+  case P_LEAF | P_FPRINT:
     type = "leaf";
     break;
   case P_LEAF | P_SUBP:
@@ -10915,6 +14652,8 @@ static int __cold mdbx_env_walk(mdbx_walk_ctx_t *ctx, const char *dbi,
   default:
     return MDBX_CORRUPTED;
   }
+  if (IS_FPRINT(mp) && !mdbx_fprint_check(mp))
+    return MDBX_CORRUPTED;
 
   for (align_bytes = i = 0; i < nkeys;
        align_bytes += ((payload_size + align_bytes) & 1), i++) {
@@ -10923,6 +14662,7 @@ static int __cold mdbx_env_walk(mdbx_walk_ctx_t *ctx, const char *dbi,
     if (IS_LEAF2(mp)) {
       /* LEAF2 pages have no mp_ptrs[] or node headers */
       payload_size += mp->mp_leaf2_ksize;
+      *entries += 1;
       continue;
     }
 
@@ -10930,13 +14670,21 @@ static int __cold mdbx_env_walk(mdbx_walk_ctx_t *ctx, const char *dbi,
     payload_size += NODESIZE + node->mn_ksize;
 
     if (IS_BRANCH(mp)) {
-      rc = mdbx_env_walk(ctx, dbi, NODEPGNO(node), deep);
+      uint64_t count = 0;
+      rc = mdbx_env_walk(ctx, dbi, NODEPGNO(node), flags, deep, &count);
       if (rc)
         return rc;
+      if (flags & MDBX_COUNTED) {
+        payload_size += sizeof(uint64_t);
+        if (NODECOUNT(node) != count)
+          return MDBX_CORRUPTED;
+      }
+      *entries += count;
       continue;
     }
 
     assert(IS_LEAF(mp));
+    *entries += 1;
     if (node->mn_flags & F_BIGDATA) {
       MDBX_page *omp;
       pgno_t *opg;
@@ -10972,6 +14720,7 @@ static int __cold mdbx_env_walk(mdbx_walk_ctx_t *ctx, const char *dbi,
     if (node->mn_flags & F_SUBDATA) {
       MDBX_db *db = NODEDATA(node);
       char *name = NULL;
+      uint64_t count = 0;
 
       if (!(node->mn_flags & F_DUPDATA)) {
         name = NODEKEY(node);
@@ -10980,9 +14729,15 @@ static int __cold mdbx_env_walk(mdbx_walk_ctx_t *ctx, const char *dbi,
         name[namelen] = 0;
       }
       rc = mdbx_env_walk(ctx, (name && name[0]) ? name : dbi, db->md_root,
-                         deep + 1);
+                         db->md_flags, deep + 1, &count);
       if (rc)
         return rc;
+      if ((db->md_flags & MDBX_COUNTED) && db->md_entries != count)
+        return MDBX_CORRUPTED;
+      if (node->mn_flags & F_DUPDATA)
+        *entries += count - 1;
+    } else if (node->mn_flags & F_DUPDATA) {
+      *entries += NUMKEYS((MDBX_page *)NODEDATA(node)) - 1;
     }
   }
 
@@ -11010,10 +14765,17 @@ int __cold mdbx_env_pgwalk(MDBX_txn *txn, MDBX_pgvisitor_func *visitor,
                    sizeof(MDBX_meta) * NUM_METAS, PAGEHDRSZ * NUM_METAS,
                    (txn->mt_env->me_psize - sizeof(MDBX_meta) - PAGEHDRSZ) *
                        NUM_METAS);
+  uint64_t entries = 0;
   if (!rc)
-    rc = mdbx_env_walk(&ctx, "free", txn->mt_dbs[FREE_DBI].md_root, 0);
+    rc = mdbx_env_walk(&ctx, "free", txn->mt_dbs[FREE_DBI].md_root,
+                       txn->mt_dbs[FREE_DBI].md_flags, 0, &entries);
+  entries = 0;
   if (!rc)
-    rc = mdbx_env_walk(&ctx, "main", txn->mt_dbs[MAIN_DBI].md_root, 0);
+    rc = mdbx_env_walk(&ctx, "main", txn->mt_dbs[MAIN_DBI].md_root,
+                       txn->mt_dbs[MAIN_DBI].md_flags, 0, &entries);
+  if (!rc && (txn->mt_dbs[MAIN_DBI].md_flags & MDBX_COUNTED) &&
+      txn->mt_dbs[MAIN_DBI].md_entries != entries)
+    rc = MDBX_CORRUPTED;
   if (!rc)
     rc = visitor(P_INVALID, 0, user, NULL, NULL, 0, 0, 0, 0);
   return rc;
@@ -341,6 +341,32 @@ int mdbx_condmutex_wait(mdbx_condmutex_t *condmutex) {
 #endif
 }
 
+int mdbx_condmutex_timedwait(mdbx_condmutex_t *condmutex, unsigned timeout_ms) {
+#if defined(_WIN32) || defined(_WIN64)
+  DWORD code = SignalObjectAndWait(condmutex->mutex, condmutex->event,
+                                   timeout_ms, FALSE);
+  if (code == WAIT_OBJECT_0 || code == WAIT_TIMEOUT) {
+    const DWORD relock = WaitForSingleObject(condmutex->mutex, INFINITE);
+    if (relock != WAIT_OBJECT_0)
+      code = relock;
+  }
+  return (code == WAIT_TIMEOUT) ? MDBX_RESULT_TRUE : waitstatus2errcode(code);
+#else
+  struct timespec abstime;
+  if (unlikely(clock_gettime(CLOCK_REALTIME, &abstime) != 0))
+    return errno;
+  abstime.tv_sec += timeout_ms / 1000;
+  abstime.tv_nsec += (long)(timeout_ms % 1000) * 1000000l;
+  if (abstime.tv_nsec >= 1000000000l) {
+    abstime.tv_sec += 1;
+    abstime.tv_nsec -= 1000000000l;
+  }
+  int rc =
+      pthread_cond_timedwait(&condmutex->cond, &condmutex->mutex, &abstime);
+  return (rc == ETIMEDOUT) ? MDBX_RESULT_TRUE : rc;
+#endif
+}
+
 /*----------------------------------------------------------------------------*/
 
 int mdbx_fastmutex_init(mdbx_fastmutex_t *fastmutex) {
@@ -550,6 +576,220 @@ int mdbx_pwritev(mdbx_filehandle_t fd, struct iovec *iov, int iovcnt,
 #endif
 }
 
+#if MDBX_USE_IOURING
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+
+struct mdbx_ioring {
+  int fd;
+  unsigned entries;  /* number of SQEs */
+  unsigned queued;   /* SQEs are queued but not submitted yet */
+  unsigned inflight; /* SQEs are submitted but not completed yet */
+  int rc;            /* the first error of completed operations */
+  unsigned *sq_head, *sq_tail, *sq_mask, *sq_array;
+  unsigned *cq_head, *cq_tail, *cq_mask;
+  struct io_uring_sqe *sqes;
+  struct io_uring_cqe *cqes;
+  void *sq_ring, *cq_ring;
+  size_t sq_ring_size, cq_ring_size;
+};
+
+void mdbx_ioring_destroy(mdbx_ioring_t *ring) {
+  if (ring->sqes && ring->sqes != MAP_FAILED)
+    munmap(ring->sqes, ring->entries * sizeof(struct io_uring_sqe));
+  if (ring->cq_ring && ring->cq_ring != MAP_FAILED &&
+      ring->cq_ring != ring->sq_ring)
+    munmap(ring->cq_ring, ring->cq_ring_size);
+  if (ring->sq_ring && ring->sq_ring != MAP_FAILED)
+    munmap(ring->sq_ring, ring->sq_ring_size);
+  if (ring->fd >= 0)
+    close(ring->fd);
+  free(ring);
+}
+
+int mdbx_ioring_create(mdbx_ioring_t **pring, unsigned entries) {
+  *pring = NULL;
+  mdbx_ioring_t *ring = calloc(1, sizeof(mdbx_ioring_t));
+  if (unlikely(!ring))
+    return MDBX_ENOMEM;
+
+  struct io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  ring->fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+  if (ring->fd < 0) {
+    int rc = errno;
+    free(ring);
+    return rc;
+  }
+
+  ring->entries = params.sq_entries;
+  ring->sq_ring_size =
+      params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  ring->cq_ring_size =
+      params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+  if (params.features & IORING_FEAT_SINGLE_MMAP) {
+    if (ring->sq_ring_size < ring->cq_ring_size)
+      ring->sq_ring_size = ring->cq_ring_size;
+    ring->cq_ring_size = ring->sq_ring_size;
+  }
+
+  ring->sq_ring = mmap(NULL, ring->sq_ring_size, PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+  if (ring->sq_ring == MAP_FAILED)
+    goto bailout;
+  ring->cq_ring = (params.features & IORING_FEAT_SINGLE_MMAP)
+                      ? ring->sq_ring
+                      : mmap(NULL, ring->cq_ring_size, PROT_READ | PROT_WRITE,
+                             MAP_SHARED | MAP_POPULATE, ring->fd,
+                             IORING_OFF_CQ_RING);
+  if (ring->cq_ring == MAP_FAILED)
+    goto bailout;
+  ring->sqes = mmap(NULL, params.sq_entries * sizeof(struct io_uring_sqe),
+                    PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                    ring->fd, IORING_OFF_SQES);
+  if (ring->sqes == MAP_FAILED)
+    goto bailout;
+
+  ring->sq_head = (unsigned *)((char *)ring->sq_ring + params.sq_off.head);
+  ring->sq_tail = (unsigned *)((char *)ring->sq_ring + params.sq_off.tail);
+  ring->sq_mask = (unsigned *)((char *)ring->sq_ring + params.sq_off.ring_mask);
+  ring->sq_array = (unsigned *)((char *)ring->sq_ring + params.sq_off.array);
+  ring->cq_head = (unsigned *)((char *)ring->cq_ring + params.cq_off.head);
+  ring->cq_tail = (unsigned *)((char *)ring->cq_ring + params.cq_off.tail);
+  ring->cq_mask = (unsigned *)((char *)ring->cq_ring + params.cq_off.ring_mask);
+  ring->cqes =
+      (struct io_uring_cqe *)((char *)ring->cq_ring + params.cq_off.cqes);
+  *pring = ring;
+  return MDBX_SUCCESS;
+
+bailout:;
+  int rc = errno;
+  mdbx_ioring_destroy(ring);
+  return rc;
+}
+
+/* Consumes all available completions, returns a number of ones. */
+static unsigned mdbx_ioring_reap(mdbx_ioring_t *ring) {
+  unsigned head = *ring->cq_head, count = 0;
+  const unsigned tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+  while (head != tail) {
+    const struct io_uring_cqe *cqe = &ring->cqes[head & *ring->cq_mask];
+    if (unlikely(ring->rc == MDBX_SUCCESS &&
+                 (uint64_t)(int64_t)cqe->res != cqe->user_data))
+      ring->rc = (cqe->res < 0) ? -cqe->res
+                                : MDBX_EIO /* Use which error code? */;
+    ++head;
+    ++count;
+  }
+  __atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+  ring->inflight -= count;
+  return count;
+}
+
+/* Submits all queued operations and waits for at least wait_nr
+ * completions, including already available ones. */
+static int mdbx_ioring_enter(mdbx_ioring_t *ring, unsigned wait_nr) {
+  for (;;) {
+    const unsigned reaped = mdbx_ioring_reap(ring);
+    wait_nr = (wait_nr > reaped) ? wait_nr - reaped : 0;
+    if (ring->queued == 0 && wait_nr == 0)
+      return MDBX_SUCCESS;
+    if (wait_nr > ring->queued + ring->inflight)
+      wait_nr = ring->queued + ring->inflight;
+
+    const int submitted =
+        (int)syscall(__NR_io_uring_enter, ring->fd, ring->queued, wait_nr,
+                     wait_nr ? IORING_ENTER_GETEVENTS : 0, NULL, 0);
+    if (unlikely(submitted < 0)) {
+      const int rc = errno;
+      if (rc == EINTR || rc == EAGAIN || rc == EBUSY)
+        continue;
+      /* drop the not submitted operations, since a caller is
+       * going to release its buffers. */
+      __atomic_store_n(ring->sq_tail,
+                       __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE),
+                       __ATOMIC_RELEASE);
+      ring->queued = 0;
+      return rc;
+    }
+    ring->queued -= submitted;
+    ring->inflight += submitted;
+  }
+}
+
+static struct io_uring_sqe *mdbx_ioring_get_sqe(mdbx_ioring_t *ring,
+                                                int *err) {
+  /* keep the number of operations not greater than SQEs, this also
+   * guarantees that completions can't overflow the CQ ring. */
+  if (ring->queued + ring->inflight >= ring->entries) {
+    *err = mdbx_ioring_enter(ring, 1);
+    if (unlikely(*err != MDBX_SUCCESS))
+      return NULL;
+  }
+
+  const unsigned tail = *ring->sq_tail;
+  const unsigned index = tail & *ring->sq_mask;
+  struct io_uring_sqe *sqe = &ring->sqes[index];
+  memset(sqe, 0, sizeof(struct io_uring_sqe));
+  ring->sq_array[index] = index;
+  return sqe;
+}
+
+static void mdbx_ioring_push(mdbx_ioring_t *ring) {
+  __atomic_store_n(ring->sq_tail, *ring->sq_tail + 1, __ATOMIC_RELEASE);
+  ring->queued += 1;
+}
+
+int mdbx_ioring_pwritev(mdbx_ioring_t *ring, mdbx_filehandle_t fd,
+                        struct iovec *iov, int iovcnt, uint64_t offset,
+                        size_t expected_written) {
+  int rc = MDBX_SUCCESS;
+  struct io_uring_sqe *sqe = mdbx_ioring_get_sqe(ring, &rc);
+  if (unlikely(!sqe))
+    return rc;
+
+  sqe->opcode = IORING_OP_WRITEV;
+  sqe->fd = fd;
+  sqe->off = offset;
+  sqe->addr = (uintptr_t)iov;
+  sqe->len = iovcnt;
+  sqe->user_data = expected_written;
+  mdbx_ioring_push(ring);
+  return MDBX_SUCCESS;
+}
+
+int mdbx_ioring_filesync(mdbx_ioring_t *ring, mdbx_filehandle_t fd,
+                         bool fullsync) {
+  int rc = MDBX_SUCCESS;
+  struct io_uring_sqe *sqe = mdbx_ioring_get_sqe(ring, &rc);
+  if (unlikely(!sqe))
+    return rc;
+
+  /* the same as mdbx_filesync(), i.e. fdatasync() unless the file
+   * size was changed. The drain-flag orders it after all writes. */
+  sqe->opcode = IORING_OP_FSYNC;
+  sqe->flags = IOSQE_IO_DRAIN;
+  sqe->fd = fd;
+  sqe->fsync_flags = fullsync ? 0 : IORING_FSYNC_DATASYNC;
+  sqe->user_data = 0;
+  mdbx_ioring_push(ring);
+  return MDBX_SUCCESS;
+}
+
+int mdbx_ioring_wait(mdbx_ioring_t *ring) {
+  int rc = mdbx_ioring_enter(ring, ring->queued + ring->inflight);
+  while (unlikely(ring->inflight)) {
+    /* a kernel still owns the buffers, so wait regardless of errors. */
+    if (mdbx_ioring_enter(ring, ring->inflight) != MDBX_SUCCESS)
+      mdbx_osal_jitter(false);
+  }
+  if (rc == MDBX_SUCCESS)
+    rc = ring->rc;
+  ring->rc = MDBX_SUCCESS;
+  return rc;
+}
+#endif /* MDBX_USE_IOURING */
+
 int mdbx_write(mdbx_filehandle_t fd, const void *buf, size_t bytes) {
 #ifdef SIGPIPE
   sigset_t set, old;
@@ -750,6 +990,22 @@ int mdbx_msync(mdbx_mmap_t *map, size_t offset, size_t length, int async) {
 #endif
 }
 
+int mdbx_mwriteback(mdbx_mmap_t *map, size_t offset, size_t length) {
+#if defined(SYNC_FILE_RANGE_WRITE)
+  /* msync(MS_ASYNC) is a no-op on Linux, and it doesn't touch
+   * the pages which was written by pwrite() anyway. */
+  for (;;) {
+    if (sync_file_range(map->fd, offset, length, SYNC_FILE_RANGE_WRITE) == 0)
+      return MDBX_SUCCESS;
+    int rc = errno;
+    if (rc != EINTR)
+      return rc;
+  }
+#else
+  return mdbx_msync(map, offset, length, true);
+#endif
+}
+
 int mdbx_mmap(int flags, mdbx_mmap_t *map, size_t must, size_t limit) {
   assert(must <= limit);
 #if defined(_WIN32) || defined(_WIN64)
@@ -977,6 +1233,22 @@ int mdbx_mresize(int flags, mdbx_mmap_t *map, size_t atleast, size_t limit) {
 
 /*----------------------------------------------------------------------------*/
 
+uint64_t mdbx_osal_monotime(void) {
+#if defined(_WIN32) || defined(_WIN64)
+  LARGE_INTEGER frequency, counter;
+  QueryPerformanceFrequency(&frequency);
+  QueryPerformanceCounter(&counter);
+  return (uint64_t)(counter.QuadPart / frequency.QuadPart) * 1000000000u +
+         (uint64_t)(counter.QuadPart % frequency.QuadPart) * 1000000000u /
+             (uint64_t)frequency.QuadPart;
+#else
+  struct timespec ts;
+  if (unlikely(clock_gettime(CLOCK_MONOTONIC, &ts) != 0))
+    return 0;
+  return ts.tv_sec * UINT64_C(1000000000) + ts.tv_nsec;
+#endif
+}
+
 __cold void mdbx_osal_jitter(bool tiny) {
   for (;;) {
 #if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) ||                \
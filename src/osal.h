@@ -152,6 +152,9 @@ typedef pthread_mutex_t mdbx_fastmutex_t;
 #include <cpuid.h>
 #include <x86intrin.h>
 #endif
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
 #elif defined(__INTEL_COMPILER)
 #include <intrin.h>
 #elif defined(__SUNPRO_C) || defined(__sun) || defined(sun)
@@ -297,6 +300,16 @@ static __inline void mdbx_memory_barrier(void) {
 #define MDBX_CACHE_IS_COHERENT 0
 #endif
 
+/* Batch the data-pages writes through io_uring, when a kernel allows.
+ * This is opt-in, since for buffered writes of scattered pages it is not
+ * faster than pwritev(). But it keeps many writes in flight, which is what
+ * the MDBX_DIRECTWRITE mode needs. */
+#ifndef MDBX_USE_IOURING
+#define MDBX_USE_IOURING 0
+#elif MDBX_USE_IOURING && !defined(__linux__)
+#error "MDBX_USE_IOURING is only for Linux"
+#endif
+
 #ifndef MDBX_CACHELINE_SIZE
 #if defined(SYSTEM_CACHE_ALIGNMENT_SIZE)
 #define MDBX_CACHELINE_SIZE SYSTEM_CACHE_ALIGNMENT_SIZE
@@ -414,6 +427,8 @@ int mdbx_condmutex_lock(mdbx_condmutex_t *condmutex);
 int mdbx_condmutex_unlock(mdbx_condmutex_t *condmutex);
 int mdbx_condmutex_signal(mdbx_condmutex_t *condmutex);
 int mdbx_condmutex_wait(mdbx_condmutex_t *condmutex);
+/* Returns MDBX_RESULT_TRUE if the timeout expired without a signal. */
+int mdbx_condmutex_timedwait(mdbx_condmutex_t *condmutex, unsigned timeout_ms);
 int mdbx_condmutex_destroy(mdbx_condmutex_t *condmutex);
 
 int mdbx_fastmutex_init(mdbx_fastmutex_t *fastmutex);
@@ -424,6 +439,23 @@ int mdbx_fastmutex_destroy(mdbx_fastmutex_t *fastmutex);
 int mdbx_pwritev(mdbx_filehandle_t fd, struct iovec *iov, int iovcnt,
                  uint64_t offset, size_t expected_written);
 int mdbx_pread(mdbx_filehandle_t fd, void *buf, size_t count, uint64_t offset);
+#if MDBX_USE_IOURING
+/* A queue of positional writes, which are submitted to a kernel in batches
+ * and completed by mdbx_ioring_wait(). The iovecs and buffers must be kept
+ * intact until then. The mdbx_ioring_create() fails, if the io_uring is not
+ * supported or not allowed, so a caller should fallback to mdbx_pwritev(). */
+typedef struct mdbx_ioring mdbx_ioring_t;
+int mdbx_ioring_create(mdbx_ioring_t **ring, unsigned entries);
+void mdbx_ioring_destroy(mdbx_ioring_t *ring);
+int mdbx_ioring_pwritev(mdbx_ioring_t *ring, mdbx_filehandle_t fd,
+                        struct iovec *iov, int iovcnt, uint64_t offset,
+                        size_t expected_written);
+/* Queues a sync, which is started after all previously queued writes. */
+int mdbx_ioring_filesync(mdbx_ioring_t *ring, mdbx_filehandle_t fd,
+                         bool fullsync);
+/* Returns the first error of all queued operations. */
+int mdbx_ioring_wait(mdbx_ioring_t *ring);
+#endif /* MDBX_USE_IOURING */
 int mdbx_pwrite(mdbx_filehandle_t fd, const void *buf, size_t count,
                 uint64_t offset);
 int mdbx_write(mdbx_filehandle_t fd, const void *buf, size_t count);
@@ -465,6 +497,8 @@ int mdbx_mmap(int flags, mdbx_mmap_t *map, size_t must, size_t limit);
 int mdbx_munmap(mdbx_mmap_t *map);
 int mdbx_mresize(int flags, mdbx_mmap_t *map, size_t current, size_t wanna);
 int mdbx_msync(mdbx_mmap_t *map, size_t offset, size_t length, int async);
+/* Starts writeback of the range to disk, without waiting for it. */
+int mdbx_mwriteback(mdbx_mmap_t *map, size_t offset, size_t length);
 
 static __inline mdbx_pid_t mdbx_getpid(void) {
 #if defined(_WIN32) || defined(_WIN64)
@@ -483,6 +517,8 @@ static __inline mdbx_tid_t mdbx_thread_self(void) {
 }
 
 void mdbx_osal_jitter(bool tiny);
+/* Returns a monotonic time in nanoseconds, suitable only for intervals. */
+uint64_t mdbx_osal_monotime(void);
 
 /*----------------------------------------------------------------------------*/
 /* lck stuff */
@@ -32,6 +32,8 @@ flagbit dbflags[] = {{MDBX_DUPSORT, "dupsort"},
                      {MDBX_REVERSEKEY, "reversekey"},
                      {MDBX_DUPFIXED, "dupfixed"},
                      {MDBX_REVERSEDUP, "reversedup"},
+                     {MDBX_COUNTED, "counted"},
+                     {MDBX_FPRINT, "fprint"},
                      {MDBX_INTEGERDUP, "integerdup"},
                      {0, NULL}};
 
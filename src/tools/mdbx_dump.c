@@ -37,6 +37,8 @@ flagbit dbflags[] = {{MDBX_REVERSEKEY, "reversekey"},
                      {MDBX_DUPFIXED, "dupfixed"},
                      {MDBX_INTEGERDUP, "integerdup"},
                      {MDBX_REVERSEDUP, "reversedup"},
+                     {MDBX_COUNTED, "counted"},
+                     {MDBX_FPRINT, "fprint"},
                      {0, NULL}};
 
 #if defined(_WIN32) || defined(_WIN64)
@@ -74,6 +74,8 @@ flagbit dbflags[] = {{MDBX_REVERSEKEY, S("reversekey")},
                      {MDBX_DUPFIXED, S("dupfixed")},
                      {MDBX_INTEGERDUP, S("integerdup")},
                      {MDBX_REVERSEDUP, S("reversedup")},
+                     {MDBX_COUNTED, S("counted")},
+                     {MDBX_FPRINT, S("fprint")},
                      {0, NULL, 0}};
 
 static void readhdr(void) {
@@ -303,6 +305,26 @@ static int readline(MDBX_val *out, MDBX_val *buf) {
   return 0;
 }
 
+/* Feeds mdbx_bulk_load() with pairs from the input,
+ * the last pair is also kept within the context. */
+static int bulk_next(void *context, MDBX_val *key, MDBX_val *data) {
+  MDBX_val *last = context;
+  if (user_break)
+    return MDBX_EINTR;
+
+  if (readline(key, &kbuf)) /* rc == EOF */
+    return MDBX_NOTFOUND;
+
+  if (readline(data, &dbuf)) {
+    fprintf(stderr, "%s: line %" PRIiSIZE ": failed to read key value\n", prog,
+            lineno);
+    return MDBX_ENODATA;
+  }
+  last[0] = *key;
+  last[1] = *data;
+  return MDBX_SUCCESS;
+}
+
 static void usage(void) {
   fprintf(stderr, "usage: %s [-V] [-f input] [-n] [-s name] [-N] [-T] dbpath\n",
           prog);
@@ -427,7 +449,9 @@ int main(int argc, char *argv[]) {
     }
 
     MDBX_val key, data;
-    int batch = 0;
+    int batch = 0, pending = 0;
+    unsigned flags = 0;
+    MDBX_stat st;
 
     rc = mdbx_txn_begin(env, NULL, 0, &txn);
     if (rc) {
@@ -442,6 +466,28 @@ int main(int argc, char *argv[]) {
       goto txn_abort;
     }
 
+    /* An empty database is built bottom-up while the input is sorted,
+     * the rest of the input (if any) is loaded by puts. */
+    if (mdbx_dbi_flags(txn, dbi, &flags) == MDBX_SUCCESS &&
+        !(flags & MDBX_DUPSORT) &&
+        mdbx_dbi_stat(txn, dbi, &st, sizeof(st)) == MDBX_SUCCESS &&
+        st.ms_entries == 0) {
+      MDBX_val last[2];
+      rc = mdbx_bulk_load(txn, dbi, bulk_next, last, 0);
+      if (rc == MDBX_EKEYMISMATCH) {
+        key = last[0];
+        data = last[1];
+        pending = 1;
+      } else if (rc == MDBX_ENODATA)
+        goto txn_abort;
+      else if (rc) {
+        fprintf(stderr, "mdbx_bulk_load failed, error %d %s\n", rc,
+                mdbx_strerror(rc));
+        goto txn_abort;
+      } else
+        goto txn_commit;
+    }
+
     rc = mdbx_cursor_open(txn, dbi, &mc);
     if (rc) {
       fprintf(stderr, "mdbx_cursor_open failed, error %d %s\n", rc,
@@ -450,15 +496,19 @@ int main(int argc, char *argv[]) {
     }
 
     while (1) {
-      rc = readline(&key, &kbuf);
-      if (rc) /* rc == EOF */
-        break;
+      if (pending)
+        pending = 0;
+      else {
+        rc = readline(&key, &kbuf);
+        if (rc) /* rc == EOF */
+          break;
 
-      rc = readline(&data, &dbuf);
-      if (rc) {
-        fprintf(stderr, "%s: line %" PRIiSIZE ": failed to read key value\n",
-                prog, lineno);
-        goto txn_abort;
+        rc = readline(&data, &dbuf);
+        if (rc) {
+          fprintf(stderr, "%s: line %" PRIiSIZE ": failed to read key value\n",
+                  prog, lineno);
+          goto txn_abort;
+        }
       }
 
       rc = mdbx_cursor_put(mc, &key, &data, putflags);
@@ -492,6 +542,7 @@ int main(int argc, char *argv[]) {
         batch = 0;
       }
     }
+  txn_commit:
     rc = mdbx_txn_commit(txn);
     txn = NULL;
     if (rc) {
@@ -0,0 +1,123 @@
+/*
+ * Copyright 2017 Leonid Yuriev <leo@yuriev.ru>
+ * and other libmdbx authors: please see AUTHORS file.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted only as authorized by the OpenLDAP
+ * Public License.
+ *
+ * A copy of this license is available in the file LICENSE in the
+ * top-level directory of the distribution or, alternatively, at
+ * <http://www.OpenLDAP.org/license.html>.
+ */
+
+#include "test.h"
+
+bool testcase_commit::setup() {
+  log_trace(">> setup");
+  if (!inherited::setup())
+    return false;
+
+  log_trace("<< setup");
+  return true;
+}
+
+/* Commits the given number of tiny write transactions, each of them puts
+ * a single unique key, which is made from the writer number and a serial. */
+static void commit_worker(MDBX_env *env, MDBX_dbi dbi, unsigned writer,
+                          uint64_t base, uint64_t count) {
+  for (uint64_t serial = base; serial < base + count; ++serial) {
+    MDBX_txn *txn = nullptr;
+    int rc = mdbx_txn_begin(env, nullptr, 0, &txn);
+    if (unlikely(rc != MDBX_SUCCESS))
+      failure_perror("mdbx_txn_begin()", rc);
+
+    uint64_t key_value = (uint64_t)writer << 40 | serial;
+    MDBX_val key = {&key_value, sizeof(key_value)};
+    MDBX_val data = {&key_value, sizeof(key_value)};
+    rc = mdbx_put(txn, dbi, &key, &data, MDBX_NOOVERWRITE);
+    if (unlikely(rc != MDBX_SUCCESS)) {
+      mdbx_txn_abort(txn);
+      failure_perror("mdbx_put(insert)", rc);
+    }
+
+    rc = mdbx_txn_commit(txn);
+    if (unlikely(rc != MDBX_SUCCESS))
+      failure_perror("mdbx_txn_commit()", rc);
+  }
+}
+
+bool testcase_commit::run() {
+  db_open();
+
+  txn_begin(false);
+  MDBX_dbi dbi = db_table_open(true);
+  txn_end(false);
+
+  /* замеряем пропускную способность фиксаций мелких транзакций
+   * несколькими писателями, сначала поодиночке (каждая фиксация делает
+   * свой fsync), а затем в режиме MDBX_GROUPCOMMIT. Для этого режимы
+   * без fsync на время теста выключаются. */
+  MDBX_env *env = db_guard.get();
+  int rc = mdbx_env_set_flags(
+      env, MDBX_NOSYNC | MDBX_NOMETASYNC | MDBX_MAPASYNC, 0);
+  if (unlikely(rc != MDBX_SUCCESS))
+    failure_perror("mdbx_env_set_flags()", rc);
+
+  const unsigned nthreads = config.params.nthreads;
+  const uint64_t per_thread =
+      (config.params.test_nops ? config.params.test_nops : 1000) / nthreads + 1;
+  uint64_t base = 0;
+  double plain = 0;
+  static const char *const modes[] = {"plain", "groupcommit"};
+  for (unsigned mode = 0; mode < 2; ++mode) {
+    rc = mdbx_env_set_flags(env, MDBX_GROUPCOMMIT, mode);
+    if (unlikely(rc != MDBX_SUCCESS))
+      failure_perror("mdbx_env_set_flags()", rc);
+
+    std::vector<std::thread> writers;
+    const chrono::time start = chrono::now_motonic();
+    for (unsigned i = 0; i < nthreads; ++i)
+      writers.emplace_back(commit_worker, env, dbi, i, base, per_thread);
+    for (auto &writer : writers)
+      writer.join();
+    const double elapsed =
+        (chrono::now_motonic().fixedpoint - start.fixedpoint) /
+        (double)UINT64_C(4294967296);
+    base += per_thread;
+
+    const double rate = (elapsed > 0) ? nthreads * per_thread / elapsed : 0;
+    if (mode == 0)
+      plain = rate;
+    log_notice("commit: %s, %u writers, %" PRIu64
+               " commits, %.6f seconds, %.1f commits/s, speedup %.2f",
+               modes[mode], nthreads, nthreads * per_thread, elapsed, rate,
+               (plain > 0) ? rate / plain : 0.0);
+  }
+
+  txn_begin(true);
+  MDBX_stat stat;
+  rc = mdbx_dbi_stat(txn_guard.get(), dbi, &stat, sizeof(stat));
+  if (unlikely(rc != MDBX_SUCCESS))
+    failure_perror("mdbx_dbi_stat()", rc);
+  txn_end(true);
+  if (unlikely(stat.ms_entries < base * nthreads))
+    failure("commit: %" PRIu64 " items, expected at least %" PRIu64,
+            stat.ms_entries, base * nthreads);
+
+  if (dbi) {
+    if (config.params.drop_table && !mode_readonly()) {
+      txn_begin(false);
+      db_table_drop(dbi);
+      txn_end(false);
+    } else
+      db_table_close(dbi);
+  }
+  return true;
+}
+
+bool testcase_commit::teardown() {
+  log_trace(">> teardown");
+  return inherited::teardown();
+}
@@ -232,7 +232,9 @@ const struct option_verb mode_bits[] = {
     {"writemap", MDBX_WRITEMAP},      {"notls", MDBX_NOTLS},
     {"nordahead", MDBX_NORDAHEAD},    {"nomeminit", MDBX_NOMEMINIT},
     {"coalesce", MDBX_COALESCE},      {"lifo", MDBX_LIFORECLAIM},
-    {"perturb", MDBX_PAGEPERTURB},    {nullptr, 0}};
+    {"perturb", MDBX_PAGEPERTURB},    {"groupcommit", MDBX_GROUPCOMMIT},
+    {"directwrite", MDBX_DIRECTWRITE}, {"writeback", MDBX_WRITEBACK},
+    {nullptr, 0}};
 
 const struct option_verb table_bits[] = {
     {"key.reverse", MDBX_REVERSEKEY},
@@ -292,6 +294,10 @@ void dump(const char *title) {
 
     log_info("database: %s, size %" PRIu64 "\n", i->params.pathname_db.c_str(),
              i->params.size);
+    if (i->params.syncbytes)
+      log_info("syncbytes: %" PRIu64 "\n", i->params.syncbytes);
+    if (i->params.maxdirty)
+      log_info("maxdirty: %" PRIu64 "\n", i->params.maxdirty);
 
     dump_verbs("mode", i->params.mode_flags, mode_bits);
     dump_verbs("table", i->params.table_flags, table_bits);
@@ -26,7 +26,10 @@ enum actor_testcase {
   ac_deadread,
   ac_deadwrite,
   ac_jitter,
-  ac_try
+  ac_try,
+  ac_scan,
+  ac_commit,
+  ac_regress
 };
 
 enum actor_status {
@@ -204,6 +207,8 @@ struct actor_params_pod {
   unsigned mode_flags;
   unsigned table_flags;
   uint64_t size;
+  uint64_t syncbytes;
+  uint64_t maxdirty;
 
   unsigned test_duration;
   unsigned test_nops;
@@ -41,6 +41,8 @@ void actor_params::set_defaults(void) {
                MDBX_NOMEMINIT | MDBX_COALESCE | MDBX_LIFORECLAIM;
   table_flags = MDBX_DUPSORT;
   size = 1024 * 1024 * 4;
+  syncbytes = 0;
+  maxdirty = 0;
 
   keygen.seed = 1;
   keygen.keycase = kc_random;
@@ -158,6 +160,12 @@ int main(int argc, char *const argv[]) {
     if (config::parse_option(argc, argv, narg, "size", params.size,
                              config::binary, 4096 * 4))
       continue;
+    if (config::parse_option(argc, argv, narg, "syncbytes", params.syncbytes,
+                             config::binary))
+      continue;
+    if (config::parse_option(argc, argv, narg, "maxdirty", params.maxdirty,
+                             config::decimal, 1024))
+      continue;
 
     if (config::parse_option(argc, argv, narg, "keygen.width",
                              params.keygen.width, 1, 64))
@@ -263,6 +271,18 @@ int main(int argc, char *const argv[]) {
       configure_actor(last_space_id, ac_jitter, value, params);
       continue;
     }
+    if (config::parse_option(argc, argv, narg, "scan", nullptr)) {
+      configure_actor(last_space_id, ac_scan, value, params);
+      continue;
+    }
+    if (config::parse_option(argc, argv, narg, "commit", nullptr)) {
+      configure_actor(last_space_id, ac_commit, value, params);
+      continue;
+    }
+    if (config::parse_option(argc, argv, narg, "regress", nullptr)) {
+      configure_actor(last_space_id, ac_regress, value, params);
+      continue;
+    }
     if (config::parse_option(argc, argv, narg, "dead.reader", nullptr)) {
       configure_actor(last_space_id, ac_deadread, value, params);
       continue;
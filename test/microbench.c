@@ -0,0 +1,712 @@
+/*
+ * Copyright 2017 Leonid Yuriev <leo@yuriev.ru>
+ * and other libmdbx authors: please see AUTHORS file.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted only as authorized by the OpenLDAP
+ * Public License.
+ *
+ * A copy of this license is available in the file LICENSE in the
+ * top-level directory of the distribution or, alternatively, at
+ * <http://www.OpenLDAP.org/license.html>.
+ */
+
+/* Microbenchmarks for internal primitives of libmdbx.
+ *
+ * The engine is included as-is, so the static functions could be measured
+ * directly, without any env/txn overhead. Usage:
+ *   test/microbench [suite...]
+ * where no suite means all of them. */
+
+#include "../src/mdbx.c"
+
+#include <stdio.h>
+#include <time.h>
+
+static uint64_t bench_now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * UINT64_C(1000000000) + ts.tv_nsec;
+}
+
+static uint64_t bench_rand_state = UINT64_C(0x9E3779B97F4A7C15);
+
+static uint64_t bench_rand(void) {
+  /* xorshift64* */
+  bench_rand_state ^= bench_rand_state >> 12;
+  bench_rand_state ^= bench_rand_state << 25;
+  bench_rand_state ^= bench_rand_state >> 27;
+  return bench_rand_state * UINT64_C(2685821657736338717);
+}
+
+static void *bench_malloc(size_t bytes) {
+  void *ptr = malloc(bytes);
+  if (!ptr) {
+    fprintf(stderr, "out of memory (%zu bytes)\n", bytes);
+    exit(EXIT_FAILURE);
+  }
+  return ptr;
+}
+
+/*----------------------------------------------------------------------------*/
+/* search: lower-bound within LEAF2-page for fixed-width integer keys */
+
+#define BENCH_SEARCH_QUERIES 4096
+#define BENCH_SEARCH_LOOKUPS 4000000
+
+/* Emulates the former loop of mdbx_node_search() for LEAF2-pages,
+ * i.e. the binary search with the comparator called by pointer. */
+static MDBX_cmp_func *volatile bench_search_cmp = mdbx_cmp_int_ua;
+
+static unsigned bench_search_generic(const uint8_t *base, unsigned n,
+                                     size_t width, const MDBX_val *key) {
+  MDBX_cmp_func *cmp = bench_search_cmp;
+  MDBX_val nodekey;
+  int low = 0, high = (int)n - 1, rc = 0;
+  unsigned i = 0;
+  nodekey.iov_len = width;
+  while (low <= high) {
+    i = (low + high) >> 1;
+    nodekey.iov_base = (void *)(base + i * width);
+    rc = cmp(key, &nodekey);
+    if (rc == 0)
+      break;
+    if (rc > 0)
+      low = i + 1;
+    else
+      high = i - 1;
+  }
+  return (rc > 0) ? i + 1 : i;
+}
+
+static double bench_search_run(const char *name, mdbx_search_fixed_func *fn,
+                               const uint8_t *base, unsigned n, size_t width,
+                               const uint64_t *queries, const unsigned *expect) {
+  const uint64_t start = bench_now_ns();
+  for (unsigned i = 0; i < BENCH_SEARCH_LOOKUPS; ++i) {
+    const unsigned q = i % BENCH_SEARCH_QUERIES;
+    unsigned r;
+    if (fn)
+      r = fn(base, n, queries[q]);
+    else {
+      MDBX_val key;
+      key.iov_base = (void *)&queries[q];
+      key.iov_len = width;
+      r = bench_search_generic(base, n, width, &key);
+    }
+    if (unlikely(r != expect[q])) {
+      fprintf(stderr, "search/%s: mismatch %u != %u\n", name, r, expect[q]);
+      exit(EXIT_FAILURE);
+    }
+  }
+  const uint64_t elapsed = bench_now_ns() - start;
+  return (double)elapsed / BENCH_SEARCH_LOOKUPS;
+}
+
+static void bench_search_page(unsigned psize, size_t width) {
+  const unsigned n = (unsigned)((psize - PAGEHDRSZ) / width);
+  uint8_t *base = bench_malloc(n * width);
+  uint64_t *queries = bench_malloc(BENCH_SEARCH_QUERIES * sizeof(uint64_t));
+  unsigned *expect = bench_malloc(BENCH_SEARCH_QUERIES * sizeof(unsigned));
+  const uint64_t mask = (width == 4) ? UINT32_MAX : UINT64_MAX;
+  const uint64_t step = mask / (n + 1);
+
+  uint64_t value = 0;
+  for (unsigned i = 0; i < n; ++i) {
+    value += 1 + bench_rand() % step;
+    if (width == 4) {
+      const uint32_t v32 = (uint32_t)value;
+      memcpy(base + i * width, &v32, width);
+    } else
+      memcpy(base + i * width, &value, width);
+  }
+
+  for (unsigned i = 0; i < BENCH_SEARCH_QUERIES; ++i) {
+    /* a half of queries are hits, and a half are misses */
+    if (i & 1) {
+      const unsigned j = bench_rand() % n;
+      queries[i] = (width == 4) ? mdbx_peek_u32(base + j * width)
+                                : mdbx_peek_u64(base + j * width);
+    } else
+      queries[i] = bench_rand() & mask;
+    /* keep the value in the native layout for the generic comparator */
+    if (width == 4) {
+      const uint32_t v32 = (uint32_t)queries[i];
+      memcpy(&queries[i], &v32, sizeof(v32));
+      expect[i] = mdbx_search_u32_scalar(base, n, v32);
+    } else
+      expect[i] = mdbx_search_u64_scalar(base, n, queries[i]);
+  }
+
+  const double generic =
+      bench_search_run("generic", NULL, base, n, width, queries, expect);
+  printf("  %5u %u %5u  generic %6.1f ns", psize, (unsigned)width * 8, n,
+         generic);
+
+  /* native kernels take the key by value */
+  if (width == 4)
+    for (unsigned i = 0; i < BENCH_SEARCH_QUERIES; ++i)
+      queries[i] = mdbx_peek_u32(&queries[i]);
+
+  struct {
+    const char *name;
+    mdbx_search_fixed_func *fn;
+    bool available;
+  } variants[] = {
+    {"scalar", (width == 4) ? mdbx_search_u32_scalar : mdbx_search_u64_scalar,
+     true},
+#if MDBX_SEARCH_X86
+    {"sse4.2", (width == 4) ? mdbx_search_u32_sse42 : mdbx_search_u64_sse42,
+     __builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("popcnt")},
+    {"avx2", (width == 4) ? mdbx_search_u32_avx2 : mdbx_search_u64_avx2,
+     __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")},
+#endif /* MDBX_SEARCH_X86 */
+  };
+
+  for (size_t i = 0; i < sizeof(variants) / sizeof(variants[0]); ++i) {
+    if (!variants[i].available)
+      continue;
+    const double ns = bench_search_run(variants[i].name, variants[i].fn, base,
+                                       n, width, queries, expect);
+    printf(", %s %6.1f ns (x%.2f)", variants[i].name, ns, generic / ns);
+  }
+  printf("\n");
+
+  free(expect);
+  free(queries);
+  free(base);
+}
+
+static void bench_search(void) {
+  printf("search: lower-bound within LEAF2-page, %u lookups per case\n",
+         BENCH_SEARCH_LOOKUPS);
+  printf("  psize bits keys\n");
+#if MDBX_SEARCH_X86
+  __builtin_cpu_init();
+#endif /* MDBX_SEARCH_X86 */
+  for (unsigned psize = MIN_PAGESIZE; psize <= MAX_PAGESIZE; psize <<= 1) {
+    bench_search_page(psize, 4);
+    bench_search_page(psize, 8);
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+/* node-search: random point reads within leaf-pages of scattered nodes */
+
+#define BENCH_NODE_KEYLEN 16
+#define BENCH_NODE_DATALEN 8
+#define BENCH_NODE_ARENA (UINT64_C(256) << 20)
+#define BENCH_NODE_QUERIES 65536
+#define BENCH_NODE_LOOKUPS 4000000
+
+static int bench_node_cmpkey(const void *a, const void *b) {
+  return memcmp(a, b, BENCH_NODE_KEYLEN);
+}
+
+/* Emulates the former loop of mdbx_node_search() for non-LEAF2 pages,
+ * optionally with prefetching of the next probes. */
+static MDBX_cmp_func *volatile bench_node_cmp = mdbx_cmp_memn;
+
+static unsigned bench_node_search_plain(MDBX_page *mp, MDBX_val *key,
+                                        int *exact, bool prefetch) {
+  MDBX_cmp_func *cmp = bench_node_cmp;
+  MDBX_val nodekey;
+  int low = 0, high = (int)NUMKEYS(mp) - 1, rc = 0;
+  unsigned i = 0;
+  while (low <= high) {
+    i = (low + high) >> 1;
+    if (prefetch)
+      mdbx_node_search_prefetch(mp, low, i, high);
+    MDBX_node *node = NODEPTR(mp, i);
+    nodekey.iov_len = NODEKSZ(node);
+    nodekey.iov_base = NODEKEY(node);
+    rc = cmp(key, &nodekey);
+    if (rc == 0)
+      break;
+    if (rc > 0)
+      low = i + 1;
+    else
+      high = i - 1;
+  }
+  *exact = (rc == 0);
+  return (rc > 0) ? i + 1 : i;
+}
+
+/* Makes a random key, which starts with the given number of zeroes. */
+static void bench_node_key(uint8_t *key, unsigned prefix) {
+  for (unsigned j = 0; j < BENCH_NODE_KEYLEN; ++j)
+    key[j] = (j < prefix) ? '0' : "0123456789abcdef"[bench_rand() & 15];
+}
+
+/* fills the leaf-page with sorted random keys, but places nodes in
+ * random order, as after random inserts. */
+static void bench_node_fill(MDBX_page *mp, unsigned psize, uint8_t *keys,
+                            unsigned nkeys, unsigned prefix, unsigned flags) {
+  const unsigned nodesize =
+      EVEN(NODESIZE + BENCH_NODE_KEYLEN + BENCH_NODE_DATALEN);
+  unsigned *order = bench_malloc(nkeys * sizeof(unsigned));
+
+  for (unsigned i = 0; i < nkeys; ++i)
+    bench_node_key(keys + i * BENCH_NODE_KEYLEN, prefix);
+  qsort(keys, nkeys, BENCH_NODE_KEYLEN, bench_node_cmpkey);
+
+  for (unsigned i = 0; i < nkeys; ++i)
+    order[i] = i;
+  for (unsigned i = nkeys; i > 1; --i) {
+    const unsigned j = bench_rand() % i, t = order[i - 1];
+    order[i - 1] = order[j];
+    order[j] = t;
+  }
+
+  memset(mp, 0, PAGEHDRSZ);
+  mp->mp_flags = (uint16_t)flags;
+  mp->mp_lower = (indx_t)(PAGELOWER0(mp) + nkeys * PAGESLOTSZ(mp));
+  mp->mp_upper = (indx_t)(psize - PAGEHDRSZ);
+  for (unsigned i = 0; i < nkeys; ++i) {
+    mp->mp_upper -= nodesize;
+    PAGEPTR(mp, order[i]) = mp->mp_upper;
+  }
+  for (unsigned i = 0; i < nkeys; ++i) {
+    MDBX_node *node = NODEPTR(mp, i);
+    memset(node, 0, nodesize);
+    node->mn_ksize = BENCH_NODE_KEYLEN;
+    node->mn_dsize = BENCH_NODE_DATALEN;
+    memcpy(NODEKEY(node), keys + i * BENCH_NODE_KEYLEN, BENCH_NODE_KEYLEN);
+  }
+  if (IS_FPRINT(mp))
+    mdbx_fprint_rebuild(mp);
+  free(order);
+}
+
+/* the same pages are filled twice, in the current layout and with
+ * fingerprints of keys (P_FPRINT), so the number of keys per page is taken
+ * for the latter, which needs 2 more bytes per key. */
+static void bench_node_search_psize(unsigned psize, unsigned prefix) {
+  const unsigned nodesize =
+      EVEN(NODESIZE + BENCH_NODE_KEYLEN + BENCH_NODE_DATALEN);
+  const unsigned nkeys = (psize - PAGEHDRSZ - 2 * sizeof(indx_t)) /
+                         (nodesize + 2 * sizeof(indx_t));
+  const size_t npages = (size_t)(BENCH_NODE_ARENA / psize);
+  uint8_t *arena[2] = {bench_malloc(npages * psize),
+                       bench_malloc(npages * psize)};
+  uint8_t *keys = bench_malloc((size_t)nkeys * BENCH_NODE_KEYLEN);
+  struct {
+    size_t page;
+    uint8_t key[BENCH_NODE_KEYLEN];
+    unsigned expect;
+    int exact;
+  } *queries = bench_malloc(BENCH_NODE_QUERIES * sizeof(*queries));
+
+  const uint64_t seed = bench_rand_state;
+  for (unsigned a = 0; a < 2; ++a) {
+    bench_rand_state = seed;
+    for (size_t n = 0; n < npages; ++n)
+      bench_node_fill((MDBX_page *)(arena[a] + n * psize), psize, keys, nkeys,
+                      prefix, a ? P_LEAF | P_FPRINT : P_LEAF);
+  }
+
+  for (unsigned q = 0; q < BENCH_NODE_QUERIES; ++q) {
+    const size_t page = bench_rand() % npages;
+    MDBX_page *mp = (MDBX_page *)(arena[0] + page * psize);
+    queries[q].page = page;
+    /* a half of queries are hits, and a half are misses */
+    if (q & 1)
+      memcpy(queries[q].key, NODEKEY(NODEPTR(mp, bench_rand() % nkeys)),
+             BENCH_NODE_KEYLEN);
+    else
+      bench_node_key(queries[q].key, prefix);
+    MDBX_val key = {queries[q].key, BENCH_NODE_KEYLEN};
+    queries[q].expect =
+        bench_node_search_plain(mp, &key, &queries[q].exact, false);
+  }
+
+  static const char *const names[] = {"plain", "prefetch", "engine",
+                                      "fprint"};
+  double ns[4];
+  for (unsigned v = 0; v < 4; ++v) {
+    const uint64_t start = bench_now_ns();
+    for (unsigned i = 0; i < BENCH_NODE_LOOKUPS; ++i) {
+      const unsigned q = i % BENCH_NODE_QUERIES;
+      MDBX_page *mp =
+          (MDBX_page *)(arena[v > 2] + queries[q].page * (size_t)psize);
+      MDBX_val key = {queries[q].key, BENCH_NODE_KEYLEN};
+      int exact;
+      const unsigned r =
+          (v < 2) ? bench_node_search_plain(mp, &key, &exact, v > 0)
+                  : (v < 3) ? mdbx_node_search_memn_prefixed(mp, &key, &exact)
+                            : mdbx_node_search_fprint(mp, &key, &exact);
+      if (unlikely(r != queries[q].expect ||
+                   (r < nkeys && exact != queries[q].exact))) {
+        fprintf(stderr, "node-search/%s: mismatch %u != %u\n", names[v], r,
+                queries[q].expect);
+        exit(EXIT_FAILURE);
+      }
+    }
+    ns[v] = (double)(bench_now_ns() - start) / BENCH_NODE_LOOKUPS;
+  }
+
+  printf("  %5u %5u  plain %6.1f ns, prefetch %6.1f ns (x%.2f), "
+         "engine %6.1f ns (x%.2f), fprint %6.1f ns (x%.2f)\n",
+         psize, nkeys, ns[0], ns[1], ns[0] / ns[1], ns[2], ns[0] / ns[2],
+         ns[3], ns[0] / ns[3]);
+
+  free(queries);
+  free(keys);
+  free(arena[1]);
+  free(arena[0]);
+}
+
+static void bench_node_search(void) {
+  printf("node-search: random point reads within %u MiB of leaf-pages, "
+         "%u-byte keys, %u lookups per case\n",
+         (unsigned)(BENCH_NODE_ARENA >> 20), BENCH_NODE_KEYLEN,
+         BENCH_NODE_LOOKUPS);
+  for (unsigned prefix = 0; prefix <= 8; prefix += 8) {
+    printf("  psize  keys, with %u-byte common prefix\n", prefix);
+    for (unsigned psize = 1024; psize <= MAX_PAGESIZE; psize <<= 1)
+      bench_node_search_psize(psize, prefix);
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+/* pnl-sort: sorting of page number lists */
+
+#define BENCH_PNL_SORT_ITEMS 20000000
+
+static MDBX_PNL bench_pnl_random(unsigned n) {
+  MDBX_PNL pnl = mdbx_pnl_alloc(n);
+  if (!pnl) {
+    fprintf(stderr, "out of memory (%u pages)\n", n);
+    exit(EXIT_FAILURE);
+  }
+  /* distinct pgno scattered within the DB of 4 times more pages,
+   * then shuffled, as befree-pages after random updates */
+  pgno_t pgno = NUM_METAS;
+  for (unsigned i = 1; i <= n; ++i) {
+    pgno += 1 + bench_rand() % 7;
+    pnl[i] = pgno;
+  }
+  for (unsigned i = n; i > 1; --i) {
+    const unsigned j = 1 + bench_rand() % i;
+    const pgno_t t = pnl[i];
+    pnl[i] = pnl[j];
+    pnl[j] = t;
+  }
+  pnl[0] = n;
+  return pnl;
+}
+
+static void bench_pnl_sort_radix(MDBX_PNL pnl) {
+  if (!mdbx_pnl_radixsort(pnl)) {
+    fprintf(stderr, "out of memory (%u pages)\n", pnl[0]);
+    exit(EXIT_FAILURE);
+  }
+}
+
+static void bench_pnl_sort_size(unsigned n) {
+  const unsigned reps =
+      (n < BENCH_PNL_SORT_ITEMS) ? BENCH_PNL_SORT_ITEMS / n : 1;
+  MDBX_PNL origin = bench_pnl_random(n);
+  MDBX_PNL expect = mdbx_pnl_alloc(n), work = mdbx_pnl_alloc(n);
+  if (!expect || !work) {
+    fprintf(stderr, "out of memory (%u pages)\n", n);
+    exit(EXIT_FAILURE);
+  }
+  MDBX_PNL_CPY(expect, origin);
+  mdbx_pnl_qsort(expect);
+  if (!mdbx_pnl_check(expect)) {
+    fprintf(stderr, "pnl-sort/qsort: unordered\n");
+    exit(EXIT_FAILURE);
+  }
+
+  static const char *const names[] = {"qsort", "radix", "engine"};
+  void (*const sorts[])(MDBX_PNL) = {mdbx_pnl_qsort, bench_pnl_sort_radix,
+                                     mdbx_pnl_sort};
+  double ns[3];
+  for (unsigned v = 0; v < 3; ++v) {
+    uint64_t elapsed = 0;
+    for (unsigned r = 0; r < reps; ++r) {
+      MDBX_PNL_CPY(work, origin);
+      const uint64_t start = bench_now_ns();
+      sorts[v](work);
+      elapsed += bench_now_ns() - start;
+      if (memcmp(work, expect, MDBX_PNL_SIZEOF(expect)) != 0) {
+        fprintf(stderr, "pnl-sort/%s: mismatch\n", names[v]);
+        exit(EXIT_FAILURE);
+      }
+    }
+    ns[v] = (double)elapsed / reps / n;
+  }
+
+  printf("  %8u  qsort %5.1f ns, radix %5.1f ns (x%.2f), "
+         "engine %5.1f ns (x%.2f)\n",
+         n, ns[0], ns[1], ns[0] / ns[1], ns[2], ns[0] / ns[2]);
+
+  mdbx_pnl_free(work);
+  mdbx_pnl_free(expect);
+  mdbx_pnl_free(origin);
+}
+
+static void bench_pnl_sort(void) {
+  printf("pnl-sort: shuffled %s PNL, per item, radix threshold %u\n",
+         MDBX_PNL_ASCENDING ? "ascending" : "descending",
+         (unsigned)MDBX_PNL_RADIXSORT_THRESHOLD);
+  printf("     items\n");
+  static const unsigned sizes[] = {64,    256,    1000,    4096,
+                                   100000, 1000000, 10000000};
+  for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+    bench_pnl_sort_size(sizes[i]);
+}
+
+/*----------------------------------------------------------------------------*/
+/* pnl-search, pnl-merge: lower-bound and merge of sorted page number lists */
+
+#define BENCH_PNL_SEARCH_LOOKUPS 4000000
+#define BENCH_PNL_MERGE_ITEMS 20000000
+
+static const struct {
+  const char *name;
+  mdbx_pnl_search_func *search;
+  mdbx_pnl_xmerge_func *xmerge;
+} bench_pnl_kernels[] = {
+    {"scalar", mdbx_pnl_search_scalar, mdbx_pnl_xmerge_scalar},
+#if MDBX_SEARCH_X86
+    {"sse4.1", mdbx_pnl_search_sse41, mdbx_pnl_xmerge_sse41},
+    {"avx2", mdbx_pnl_search_avx2, mdbx_pnl_xmerge_avx2},
+#endif /* MDBX_SEARCH_X86 */
+#if MDBX_SEARCH_NEON
+    {"neon", mdbx_pnl_search_neon, mdbx_pnl_xmerge_neon},
+#endif /* MDBX_SEARCH_NEON */
+};
+
+static bool bench_pnl_kernel_available(size_t i) {
+#if MDBX_SEARCH_X86
+  const char *name = bench_pnl_kernels[i].name;
+  if (strcmp(name, "sse4.1") == 0)
+    return __builtin_cpu_supports("sse4.1") && __builtin_cpu_supports("popcnt");
+  if (strcmp(name, "avx2") == 0)
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt");
+#endif /* MDBX_SEARCH_X86 */
+  (void)i;
+  return true;
+}
+
+/* A sorted PNL of n distinct pgno, as the reclaimed list of GC */
+static MDBX_PNL bench_pnl_sorted(unsigned n) {
+  MDBX_PNL pnl = bench_pnl_random(n);
+  mdbx_pnl_sort(pnl);
+  return pnl;
+}
+
+/* Plain binary search with the comparison per step */
+static unsigned bench_pnl_search_plain(const pgno_t *pnl, pgno_t id) {
+  unsigned low = 1, high = pnl[0] + 1;
+  while (low < high) {
+    const unsigned middle = low + ((high - low) >> 1);
+    if (MDBX_PNL_ORDERED(pnl[middle], id))
+      low = middle + 1;
+    else
+      high = middle;
+  }
+  return low;
+}
+
+static double bench_pnl_search_run(const char *name, mdbx_pnl_search_func *fn,
+                                   const pgno_t *pnl, const pgno_t *queries,
+                                   const unsigned *expect) {
+  const uint64_t start = bench_now_ns();
+  for (unsigned i = 0; i < BENCH_PNL_SEARCH_LOOKUPS; ++i) {
+    const unsigned q = i % BENCH_SEARCH_QUERIES;
+    const unsigned r = fn(pnl, queries[q]);
+    if (unlikely(r != expect[q])) {
+      fprintf(stderr, "pnl-search/%s: mismatch %u != %u\n", name, r, expect[q]);
+      exit(EXIT_FAILURE);
+    }
+  }
+  const uint64_t elapsed = bench_now_ns() - start;
+  return (double)elapsed / BENCH_PNL_SEARCH_LOOKUPS;
+}
+
+static void bench_pnl_search_size(unsigned n) {
+  MDBX_PNL pnl = bench_pnl_sorted(n);
+  pgno_t *queries = bench_malloc(BENCH_SEARCH_QUERIES * sizeof(pgno_t));
+  unsigned *expect = bench_malloc(BENCH_SEARCH_QUERIES * sizeof(unsigned));
+  const pgno_t first = MDBX_PNL_ASCENDING ? pnl[1] : pnl[n];
+  const pgno_t last = MDBX_PNL_ASCENDING ? pnl[n] : pnl[1];
+  for (unsigned i = 0; i < BENCH_SEARCH_QUERIES; ++i) {
+    /* a half of queries are hits, and a half are mostly misses,
+     * including ones out of the range */
+    queries[i] = (i & 1) ? pnl[1 + bench_rand() % n]
+                         : first - 2 + bench_rand() % (last - first + 5);
+    expect[i] = bench_pnl_search_plain(pnl, queries[i]);
+  }
+
+  const double plain = bench_pnl_search_run("plain", bench_pnl_search_plain,
+                                            pnl, queries, expect);
+  printf("  %8u  plain %6.1f ns", n, plain);
+  const size_t kernels =
+      sizeof(bench_pnl_kernels) / sizeof(bench_pnl_kernels[0]);
+  for (size_t i = 0; i < kernels; ++i) {
+    if (!bench_pnl_kernel_available(i))
+      continue;
+    const double ns = bench_pnl_search_run(
+        bench_pnl_kernels[i].name, bench_pnl_kernels[i].search, pnl, queries,
+        expect);
+    printf(", %s %6.1f ns (x%.2f)", bench_pnl_kernels[i].name, ns, plain / ns);
+  }
+  printf("\n");
+
+  free(expect);
+  free(queries);
+  mdbx_pnl_free(pnl);
+}
+
+static void bench_pnl_search(void) {
+  printf("pnl-search: lower-bound within %s PNL, %u lookups per case\n",
+         MDBX_PNL_ASCENDING ? "ascending" : "descending",
+         BENCH_PNL_SEARCH_LOOKUPS);
+  printf("     items\n");
+#if MDBX_SEARCH_X86
+  __builtin_cpu_init();
+#endif /* MDBX_SEARCH_X86 */
+  static const unsigned sizes[] = {5, 16, 100, 1000, 10000, 100000, 1000000};
+  for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+    bench_pnl_search_size(sizes[i]);
+}
+
+/* Splits a sorted PNL of n + m items into two sorted ones of about n and m
+ * items, i.e. randomly interleaved. */
+static void bench_pnl_split(unsigned n, unsigned m, MDBX_PNL *dst,
+                            MDBX_PNL *src) {
+  MDBX_PNL all = bench_pnl_sorted(n + m);
+  *dst = mdbx_pnl_alloc(n + m);
+  *src = mdbx_pnl_alloc(n + m);
+  if (!*dst || !*src) {
+    fprintf(stderr, "out of memory (%u pages)\n", n + m);
+    exit(EXIT_FAILURE);
+  }
+  (*dst)[0] = (*src)[0] = 0;
+  for (unsigned i = 1; i <= n + m; ++i) {
+    MDBX_PNL into = (bench_rand() % (n + m) < n) ? *dst : *src;
+    into[into[0] += 1] = all[i];
+  }
+  mdbx_pnl_free(all);
+}
+
+static void bench_pnl_merge_engine(pgno_t *pnl, const pgno_t *merge) {
+  mdbx_pnl_xmerge(pnl, (MDBX_PNL)merge);
+}
+
+static double bench_pnl_merge_run(const char *name, mdbx_pnl_xmerge_func *fn,
+                                  MDBX_PNL work, const MDBX_PNL dst,
+                                  const MDBX_PNL src, const MDBX_PNL expect) {
+  const unsigned total = dst[0] + src[0];
+  const unsigned reps =
+      (total < BENCH_PNL_MERGE_ITEMS) ? BENCH_PNL_MERGE_ITEMS / total : 1;
+  uint64_t elapsed = 0;
+  for (unsigned r = 0; r < reps; ++r) {
+    MDBX_PNL_CPY(work, dst);
+    const uint64_t start = bench_now_ns();
+    fn(work, src);
+    elapsed += bench_now_ns() - start;
+    work[0] = total;
+    if (memcmp(work, expect, MDBX_PNL_SIZEOF(expect)) != 0) {
+      fprintf(stderr, "pnl-merge/%s: mismatch\n", name);
+      exit(EXIT_FAILURE);
+    }
+  }
+  return (double)elapsed / reps / total;
+}
+
+static void bench_pnl_merge_size(unsigned n, unsigned m) {
+  MDBX_PNL dst, src;
+  bench_pnl_split(n, m, &dst, &src);
+  MDBX_PNL expect = mdbx_pnl_alloc(n + m), work = mdbx_pnl_alloc(n + m);
+  if (!expect || !work) {
+    fprintf(stderr, "out of memory (%u pages)\n", n + m);
+    exit(EXIT_FAILURE);
+  }
+  MDBX_PNL_CPY(expect, dst);
+  memcpy(expect + dst[0] + 1, src + 1, src[0] * sizeof(pgno_t));
+  expect[0] = dst[0] + src[0];
+  mdbx_pnl_sort(expect);
+
+  printf("  %8u %8u", dst[0], src[0]);
+  double scalar = 0;
+  const size_t kernels =
+      sizeof(bench_pnl_kernels) / sizeof(bench_pnl_kernels[0]);
+  for (size_t i = 0; i < kernels; ++i) {
+    if (!bench_pnl_kernel_available(i) ||
+        (i && (dst[0] < MDBX_SEARCH_BLOCK || src[0] < MDBX_SEARCH_BLOCK)))
+      continue;
+    const double ns = bench_pnl_merge_run(bench_pnl_kernels[i].name,
+                                          bench_pnl_kernels[i].xmerge, work,
+                                          dst, src, expect);
+    if (i == 0) {
+      scalar = ns;
+      printf("  %s %5.2f ns", bench_pnl_kernels[i].name, ns);
+    } else
+      printf(", %s %5.2f ns (x%.2f)", bench_pnl_kernels[i].name, ns,
+             scalar / ns);
+  }
+  const double ns = bench_pnl_merge_run("engine", bench_pnl_merge_engine, work,
+                                        dst, src, expect);
+  printf(", engine %5.2f ns (x%.2f)\n", ns, scalar / ns);
+
+  mdbx_pnl_free(work);
+  mdbx_pnl_free(expect);
+  mdbx_pnl_free(src);
+  mdbx_pnl_free(dst);
+}
+
+static void bench_pnl_merge(void) {
+  printf("pnl-merge: interleaved %s PNLs, per item, SIMD threshold %u\n",
+         MDBX_PNL_ASCENDING ? "ascending" : "descending",
+         (unsigned)MDBX_PNL_SIMD_THRESHOLD);
+  printf("      into    merge\n");
+#if MDBX_SEARCH_X86
+  __builtin_cpu_init();
+#endif /* MDBX_SEARCH_X86 */
+  static const unsigned sizes[][2] = {
+      {8, 8},           {16, 16},         {32, 32},          {64, 64},
+      {1000, 1000},     {100000, 100000}, {1000000, 1000000}, {1000, 10},
+      {100000, 100},    {100000, 1000},   {1000, 100000}};
+  for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+    bench_pnl_merge_size(sizes[i][0], sizes[i][1]);
+}
+
+/*----------------------------------------------------------------------------*/
+
+static const struct {
+  const char *name;
+  void (*run)(void);
+} bench_suites[] = {
+    {"search", bench_search},
+    {"node-search", bench_node_search},
+    {"pnl-sort", bench_pnl_sort},
+    {"pnl-search", bench_pnl_search},
+    {"pnl-merge", bench_pnl_merge},
+};
+
+int main(int argc, char *argv[]) {
+  const size_t count = sizeof(bench_suites) / sizeof(bench_suites[0]);
+  for (int narg = 1; narg < argc; ++narg) {
+    size_t i = 0;
+    while (i < count && strcmp(argv[narg], bench_suites[i].name) != 0)
+      ++i;
+    if (i == count) {
+      fprintf(stderr, "unknown suite '%s'\n", argv[narg]);
+      return EXIT_FAILURE;
+    }
+  }
+
+  for (size_t i = 0; i < count; ++i) {
+    bool selected = argc < 2;
+    for (int narg = 1; !selected && narg < argc; ++narg)
+      selected = strcmp(argv[narg], bench_suites[i].name) == 0;
+    if (selected)
+      bench_suites[i].run();
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,294 @@
+/*
+ * Copyright 2017 Leonid Yuriev <leo@yuriev.ru>
+ * and other libmdbx authors: please see AUTHORS file.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted only as authorized by the OpenLDAP
+ * Public License.
+ *
+ * A copy of this license is available in the file LICENSE in the
+ * top-level directory of the distribution or, alternatively, at
+ * <http://www.OpenLDAP.org/license.html>.
+ */
+
+#include "test.h"
+
+bool testcase_regress::setup() {
+  log_trace(">> setup");
+  if (!inherited::setup())
+    return false;
+
+  log_trace("<< setup");
+  return true;
+}
+
+MDBX_dbi testcase_regress::regress_table_open(const char *name,
+                                              unsigned flags) {
+  char tablename[32];
+  int rc = snprintf(tablename, sizeof(tablename), "%s%04u", name,
+                    config.space_id);
+  if (rc < 4 || rc >= (int)sizeof(tablename) - 1)
+    failure("snprintf(tablename): %d", rc);
+
+  MDBX_dbi handle = 0;
+  rc = mdbx_dbi_open(txn_guard.get(), tablename, flags | MDBX_CREATE,
+                     &handle);
+  if (unlikely(rc != MDBX_SUCCESS))
+    failure_perror("mdbx_dbi_open()", rc);
+  return handle;
+}
+
+/* ключи и значения для проверок, значение заполнено байтом от номера,
+ * чтобы подмена страницы была видна при чтении. Байт не ASCII, чтобы
+ * отладочная печать длинного значения обрезалась, а не срабатывал assert. */
+static char regress_byte(unsigned n) { return (char)(128 + n % 128); }
+
+static void regress_put(MDBX_txn *txn, MDBX_dbi dbi, unsigned n, size_t len) {
+  char key_buf[16];
+  snprintf(key_buf, sizeof(key_buf), "regress%04u", n);
+  std::string value(len, regress_byte(n));
+  MDBX_val key = {key_buf, strlen(key_buf)};
+  MDBX_val data = {(void *)value.data(), value.size()};
+  int rc = mdbx_put(txn, dbi, &key, &data, 0);
+  if (unlikely(rc != MDBX_SUCCESS))
+    failure_perror("mdbx_put()", rc);
+}
+
+static void regress_del(MDBX_txn *txn, MDBX_dbi dbi, unsigned n) {
+  char key_buf[16];
+  snprintf(key_buf, sizeof(key_buf), "regress%04u", n);
+  MDBX_val key = {key_buf, strlen(key_buf)};
+  int rc = mdbx_del(txn, dbi, &key, nullptr);
+  if (unlikely(rc != MDBX_SUCCESS))
+    failure_perror("mdbx_del()", rc);
+}
+
+static void regress_check(MDBX_txn *txn, MDBX_dbi dbi, unsigned n,
+                          size_t len) {
+  char key_buf[16];
+  snprintf(key_buf, sizeof(key_buf), "regress%04u", n);
+  MDBX_val key = {key_buf, strlen(key_buf)}, data;
+  int rc = mdbx_get(txn, dbi, &key, &data);
+  if (len == 0) {
+    if (unlikely(rc != MDBX_NOTFOUND))
+      failure("regress: %s %s", key_buf,
+              (rc == MDBX_SUCCESS) ? "isn't deleted" : mdbx_strerror(rc));
+    return;
+  }
+  if (unlikely(rc != MDBX_SUCCESS))
+    failure_perror("mdbx_get()", rc);
+  if (unlikely(data.iov_len != len ||
+               memcmp(data.iov_base, std::string(len, regress_byte(n)).data(),
+                      len) != 0))
+    failure("regress: %s has a wrong value", key_buf);
+}
+
+/* хеш-индекс несортированного хвоста dirty-списка должен очищаться,
+ * когда хвост опустошается. Иначе после удаления из хвоста страниц
+ * переполнения и удалений из сортированной части остаются ссылки за конец
+ * списка, и повторно выделенные страницы находятся по ним. */
+void testcase_regress::regress_dirtylist() {
+  log_verbose("regress: dirtylist");
+  /* хеш-индекса нет в режиме MDBX_WRITEMAP, поэтому проверка идет
+   * в отдельной БД, которая каждый раз создается заново. */
+  const std::string pathname = config.params.pathname_db + "-regress";
+  std::remove(pathname.c_str());
+  std::remove((pathname + "-lck").c_str());
+  MDBX_env *env = db_guard.get();
+  int rc = mdbx_env_open(
+      env, pathname.c_str(),
+      ((unsigned)config.params.mode_flags | MDBX_NOSUBDIR) & ~MDBX_WRITEMAP,
+      0640);
+  if (unlikely(rc != MDBX_SUCCESS))
+    failure_perror("mdbx_env_open()", rc);
+
+  MDBX_stat stat;
+  rc = mdbx_env_stat(env, &stat, sizeof(stat));
+  if (unlikely(rc != MDBX_SUCCESS))
+    failure_perror("mdbx_env_stat()", rc);
+  const size_t big = stat.ms_psize * 3;
+
+  /* заполняем и освобождаем половину страниц, затем несколько
+   * транзакций, чтобы эти страницы стали доступны для переработки */
+  txn_begin(false);
+  const MDBX_dbi dbi = regress_table_open("DPL", 0);
+  for (unsigned n = 0; n < 40; ++n)
+    regress_put(txn_guard.get(), dbi, n, big);
+  txn_restart(false, false);
+  for (unsigned n = 0; n < 40; n += 2)
+    regress_del(txn_guard.get(), dbi, n);
+  for (unsigned n = 0; n < 3; ++n) {
+    txn_restart(false, false);
+    regress_put(txn_guard.get(), dbi, 1000 + n, 1);
+  }
+  txn_restart(false, false);
+
+  MDBX_txn *txn = txn_guard.get();
+  for (unsigned n = 100; n < 108; ++n)
+    regress_put(txn, dbi, n, big);
+  /* фиксация вложенной транзакции сортирует dirty-список целиком */
+  MDBX_txn *nested = nullptr;
+  rc = mdbx_txn_begin(env, txn, 0, &nested);
+  if (unlikely(rc != MDBX_SUCCESS))
+    failure_perror("mdbx_txn_begin(nested)", rc);
+  rc = mdbx_txn_commit(nested);
+  if (unlikely(rc != MDBX_SUCCESS))
+    failure_perror("mdbx_txn_commit(nested)", rc);
+
+  /* освобожденные страницы вновь выделяются в хвост, который затем
+   * опустошается, и сортированная часть укорачивается */
+  regress_del(txn, dbi, 101);
+  regress_del(txn, dbi, 102);
+  regress_put(txn, dbi, 108, big);
+  regress_put(txn, dbi, 111, big);
+  regress_del(txn, dbi, 108);
+  regress_del(txn, dbi, 111);
+  regress_del(txn, dbi, 107);
+  regress_del(txn, dbi, 106);
+  regress_put(txn, dbi, 109, big);
+  regress_put(txn, dbi, 110, big);
+  regress_check(txn, dbi, 109, big);
+  regress_check(txn, dbi, 110, big);
+  regress_del(txn, dbi, 110);
+  regress_put(txn, dbi, 110, big);
+  regress_check(txn, dbi, 110, big);
+  txn_restart(false, true);
+
+  txn = txn_guard.get();
+  for (unsigned n = 100; n < 112; ++n)
+    regress_check(txn, dbi, n,
+                  (n == 100 || (n >= 103 && n <= 105) || n >= 109) && n < 111
+                      ? big
+                      : 0);
+  txn_end(true);
+  db_close();
+}
+
+/* пакетные операции упорядочивают ключи до того, как mdbx_cursor_set()
+ * или mdbx_cursor_put() проверят их размер, а сравнение ключей неверного
+ * размера для MDBX_INTEGERKEY завершается аварийно. */
+void testcase_regress::regress_batch() {
+  log_verbose("regress: batch");
+  db_open();
+  txn_begin(false);
+  const MDBX_dbi dbi = regress_table_open("INT", MDBX_INTEGERKEY);
+
+  const uint64_t a = 42, b = 7;
+  const char c[3] = {1, 2, 3};
+  const MDBX_val keys[3] = {
+      {(void *)&a, sizeof(a)}, {(void *)c, sizeof(c)}, {(void *)&b, sizeof(b)}};
+  MDBX_val data[3] = {
+      {(void *)&a, sizeof(a)}, {(void *)c, sizeof(c)}, {(void *)&b, sizeof(b)}};
+
+  int rc = mdbx_put_batch(txn_guard.get(), dbi, keys, 3, data, 0);
+  if (unlikely(rc != MDBX_BAD_VALSIZE))
+    failure("regress: mdbx_put_batch() returns %d instead of %d", rc,
+            MDBX_BAD_VALSIZE);
+  rc = mdbx_get_batch(txn_guard.get(), dbi, keys, 3, data, 0);
+  if (unlikely(rc != MDBX_BAD_VALSIZE))
+    failure("regress: mdbx_get_batch() returns %d instead of %d", rc,
+            MDBX_BAD_VALSIZE);
+
+  txn_end(true);
+  db_close();
+}
+
+/* страницы MDBX_FPRINT хранят отпечатки ключей после общего префикса
+ * страницы, который укорачивается при вставке ключа без этого префикса
+ * и удлиняется при разделении страницы. */
+void testcase_regress::regress_fprint() {
+  log_verbose("regress: fprint");
+  db_open();
+  txn_begin(false);
+  MDBX_dbi dbi = 0;
+  int rc = mdbx_dbi_open(txn_guard.get(), "regress-fprint",
+                         MDBX_FPRINT | MDBX_INTEGERKEY | MDBX_CREATE, &dbi);
+  if (unlikely(rc != MDBX_EINVAL))
+    failure("regress: mdbx_dbi_open() returns %d instead of %d", rc,
+            MDBX_EINVAL);
+  dbi = regress_table_open("FP", MDBX_FPRINT);
+
+  for (unsigned n = 0; n < 3000; ++n)
+    regress_put(txn_guard.get(), dbi, n, 1 + n % 32);
+  txn_restart(false, false);
+  for (unsigned n = 0; n < 3000; n += 3)
+    regress_del(txn_guard.get(), dbi, n);
+
+  static const char *const edges[] = {"", "a", "regress", "regress0", "zzz"};
+  for (const char *edge : edges) {
+    MDBX_val key = {(void *)edge, strlen(edge)};
+    MDBX_val data = key;
+    rc = mdbx_put(txn_guard.get(), dbi, &key, &data, 0);
+    if (unlikely(rc != MDBX_SUCCESS))
+      failure_perror("mdbx_put()", rc);
+  }
+  txn_restart(false, true);
+
+  MDBX_txn *txn = txn_guard.get();
+  for (unsigned n = 0; n < 3000; ++n)
+    regress_check(txn, dbi, n, (n % 3) ? 1 + n % 32 : 0);
+  for (const char *edge : edges) {
+    MDBX_val key = {(void *)edge, strlen(edge)}, data;
+    rc = mdbx_get(txn, dbi, &key, &data);
+    if (unlikely(rc != MDBX_SUCCESS))
+      failure_perror("mdbx_get()", rc);
+    if (unlikely(data.iov_len != key.iov_len ||
+                 memcmp(data.iov_base, edge, key.iov_len) != 0))
+      failure("regress: '%s' has a wrong value", edge);
+  }
+  txn_end(true);
+  db_close();
+}
+
+/* Запись таблицы в новой транзакции остается устаревшей до первого чтения
+ * корня. Смена политики разделения страниц без ее обновления сохраняла
+ * запись из прерванной транзакции, ссылающуюся на освобожденные страницы. */
+void testcase_regress::regress_policy() {
+  log_verbose("regress: policy");
+  db_open();
+  txn_begin(false);
+  const MDBX_dbi dbi = regress_table_open("POL", 0);
+  for (unsigned n = 0; n < 500; ++n)
+    regress_put(txn_guard.get(), dbi, n, 1 + n % 32);
+  txn_restart(false, false);
+  for (unsigned n = 500; n < 2000; ++n)
+    regress_put(txn_guard.get(), dbi, n, 1 + n % 32);
+  txn_restart(true, false);
+
+  int rc = mdbx_dbi_set_policy(txn_guard.get(), dbi, MDBX_SPLIT_APPEND, 10);
+  if (unlikely(rc != MDBX_SUCCESS))
+    failure_perror("mdbx_dbi_set_policy()", rc);
+  txn_restart(false, true);
+
+  MDBX_stat stat;
+  rc = mdbx_dbi_stat(txn_guard.get(), dbi, &stat, sizeof(stat));
+  if (unlikely(rc != MDBX_SUCCESS))
+    failure_perror("mdbx_dbi_stat()", rc);
+  if (unlikely(stat.ms_entries != 500))
+    failure("regress: %" PRIu64 " entries instead of 500",
+            (uint64_t)stat.ms_entries);
+  unsigned policy, merge;
+  rc = mdbx_dbi_get_policy(txn_guard.get(), dbi, &policy, &merge);
+  if (unlikely(rc != MDBX_SUCCESS))
+    failure_perror("mdbx_dbi_get_policy()", rc);
+  if (unlikely(policy != MDBX_SPLIT_APPEND || merge != 10))
+    failure("regress: policy %u/%u isn't stored", policy, merge);
+  for (unsigned n = 0; n < 2000; ++n)
+    regress_check(txn_guard.get(), dbi, n, (n < 500) ? 1 + n % 32 : 0);
+  txn_end(true);
+  db_close();
+}
+
+bool testcase_regress::run() {
+  regress_dirtylist();
+  regress_batch();
+  regress_fprint();
+  regress_policy();
+  return true;
+}
+
+bool testcase_regress::teardown() {
+  log_trace(">> teardown");
+  return inherited::teardown();
+}
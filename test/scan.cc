@@ -0,0 +1,175 @@
+/*
+ * Copyright 2017 Leonid Yuriev <leo@yuriev.ru>
+ * and other libmdbx authors: please see AUTHORS file.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted only as authorized by the OpenLDAP
+ * Public License.
+ *
+ * A copy of this license is available in the file LICENSE in the
+ * top-level directory of the distribution or, alternatively, at
+ * <http://www.OpenLDAP.org/license.html>.
+ */
+
+#include "test.h"
+
+bool testcase_scan::setup() {
+  log_trace(">> setup");
+  if (!inherited::setup())
+    return false;
+
+  log_trace("<< setup");
+  return true;
+}
+
+struct scan_counter {
+  uint64_t items, bytes;
+};
+
+static int scan_count(void *ctx, const MDBX_val *key, const MDBX_val *data) {
+  scan_counter *counter = (scan_counter *)ctx;
+  counter->items += 1;
+  counter->bytes += key->iov_len + data->iov_len;
+  return MDBX_RESULT_FALSE;
+}
+
+/* Scans the ranges [bounds[i-1], bounds[i]) for every i-th range assigned
+ * to the worker, within its own read-only transaction of the snapshot. */
+static void scan_worker(MDBX_env *env, MDBX_dbi dbi, uint64_t snapshot,
+                        const std::vector<MDBX_val> &bounds, size_t first,
+                        size_t step, scan_counter *counter) {
+  MDBX_txn *txn = nullptr;
+  int rc = mdbx_txn_begin(env, nullptr, MDBX_RDONLY, &txn);
+  if (unlikely(rc != MDBX_SUCCESS))
+    failure_perror("mdbx_txn_begin()", rc);
+  scoped_txn_guard txn_guard(txn);
+  if (unlikely(mdbx_txn_id(txn) != snapshot))
+    failure("scan: snapshot %" PRIu64 " changed to %" PRIu64, snapshot,
+            mdbx_txn_id(txn));
+
+  MDBX_cursor *cursor = nullptr;
+  rc = mdbx_cursor_open(txn, dbi, &cursor);
+  if (unlikely(rc != MDBX_SUCCESS))
+    failure_perror("mdbx_cursor_open()", rc);
+  scoped_cursor_guard cursor_guard(cursor);
+
+  const size_t nranges = bounds.size() + 1;
+  for (size_t i = first; i < nranges; i += step) {
+    rc = mdbx_cursor_scan(cursor, i ? &bounds[i - 1] : nullptr,
+                          (i < bounds.size()) ? &bounds[i] : nullptr,
+                          scan_count, counter, 0);
+    if (unlikely(rc != MDBX_SUCCESS))
+      failure_perror("mdbx_cursor_scan()", rc);
+  }
+}
+
+bool testcase_scan::run() {
+  db_open();
+
+  txn_begin(false);
+  MDBX_dbi dbi = db_table_open(true);
+  txn_end(false);
+
+  /* сначала наполняем таблицу, затем сканируем её целиком в один и
+   * в несколько потоков, разделяя на диапазоны посредством
+   * mdbx_dbi_partition(), и сравниваем время. */
+  keyvalue_maker.setup(config.params, 0 /* thread_number */);
+  key = keygen::alloc(config.params.keylen_max);
+  data = keygen::alloc(config.params.datalen_max);
+
+  const unsigned insert_flags = (config.params.table_flags & MDBX_DUPSORT)
+                                    ? MDBX_NODUPDATA
+                                    : MDBX_NODUPDATA | MDBX_NOOVERWRITE;
+
+  uint64_t serial_count = 0;
+  unsigned txn_nops = 0;
+  txn_begin(false);
+  while (should_continue()) {
+    log_trace("scan: insert %" PRIu64, serial_count);
+    generate_pair(serial_count);
+    int rc = mdbx_put(txn_guard.get(), dbi, &key->value, &data->value,
+                      insert_flags);
+    if (unlikely(rc != MDBX_SUCCESS))
+      failure_perror("mdbx_put(insert)", rc);
+
+    if (++txn_nops >= config.params.batch_write) {
+      txn_restart(false, false);
+      txn_nops = 0;
+    }
+
+    report(1);
+    if (!keyvalue_maker.increment(serial_count, 1))
+      break; /* дошли до границы пространства ключей */
+  }
+  txn_end(false);
+
+  txn_begin(true);
+  const uint64_t snapshot = mdbx_txn_id(txn_guard.get());
+  MDBX_stat stat;
+  int rc = mdbx_dbi_stat(txn_guard.get(), dbi, &stat, sizeof(stat));
+  if (unlikely(rc != MDBX_SUCCESS))
+    failure_perror("mdbx_dbi_stat()", rc);
+
+  double single = 0;
+  for (unsigned nthreads = 1;; nthreads <<= 1) {
+    if (nthreads > config.params.nthreads)
+      nthreads = config.params.nthreads;
+
+    /* диапазонов больше чем потоков, чтобы сгладить их неравенство. */
+    size_t nranges = nthreads * 4;
+    std::vector<MDBX_val> bounds(nranges - 1);
+    rc = mdbx_dbi_partition(txn_guard.get(), dbi, &nranges, bounds.data());
+    if (unlikely(rc != MDBX_SUCCESS))
+      failure_perror("mdbx_dbi_partition()", rc);
+    bounds.resize(nranges - 1);
+
+    std::vector<scan_counter> counters(nthreads);
+    std::vector<std::thread> workers;
+    const chrono::time start = chrono::now_motonic();
+    for (unsigned i = 0; i < nthreads; ++i) {
+      counters[i].items = counters[i].bytes = 0;
+      workers.emplace_back(scan_worker, db_guard.get(), dbi, snapshot,
+                           std::cref(bounds), i, nthreads, &counters[i]);
+    }
+    for (auto &worker : workers)
+      worker.join();
+    const double elapsed =
+        (chrono::now_motonic().fixedpoint - start.fixedpoint) /
+        (double)UINT64_C(4294967296);
+
+    uint64_t items = 0, bytes = 0;
+    for (const auto &counter : counters) {
+      items += counter.items;
+      bytes += counter.bytes;
+    }
+    if (unlikely(items != stat.ms_entries))
+      failure("scan: %" PRIu64 " items scanned by %u threads, expected %" PRIu64,
+              items, nthreads, stat.ms_entries);
+
+    if (nthreads == 1)
+      single = elapsed;
+    log_notice("scan: %u threads, %" PRIuSIZE " ranges, %" PRIu64
+               " items, %" PRIu64 " bytes, %.6f seconds, speedup %.2f",
+               nthreads, nranges, items, bytes, elapsed,
+               (elapsed > 0) ? single / elapsed : 0.0);
+    if (nthreads == config.params.nthreads)
+      break;
+  }
+  txn_end(true);
+
+  if (dbi) {
+    if (config.params.drop_table && !mode_readonly()) {
+      txn_begin(false);
+      db_table_drop(dbi);
+      txn_end(false);
+    } else
+      db_table_close(dbi);
+  }
+  return true;
+}
+
+bool testcase_scan::teardown() {
+  log_trace(">> teardown");
+  return inherited::teardown();
+}
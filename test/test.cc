@@ -31,6 +31,12 @@ const char *testcase2str(const actor_testcase testcase) {
     return "jitter";
   case ac_try:
     return "try";
+  case ac_scan:
+    return "scan";
+  case ac_commit:
+    return "commit";
+  case ac_regress:
+    return "regress";
   }
 }
 
@@ -153,6 +159,18 @@ void testcase::db_prepare() {
   if (unlikely(rc != MDBX_SUCCESS))
     failure_perror("mdbx_env_set_mapsize()", rc);
 
+  if (config.params.syncbytes) {
+    rc = mdbx_env_set_syncbytes(env, (size_t)config.params.syncbytes);
+    if (unlikely(rc != MDBX_SUCCESS))
+      failure_perror("mdbx_env_set_syncbytes()", rc);
+  }
+
+  if (config.params.maxdirty) {
+    rc = mdbx_env_set_maxdirty(env, (size_t)config.params.maxdirty);
+    if (unlikely(rc != MDBX_SUCCESS))
+      failure_perror("mdbx_env_set_maxdirty()", rc);
+  }
+
   log_trace("<< db_prepare");
 }
 
@@ -184,6 +202,7 @@ void testcase::txn_begin(bool readonly, unsigned flags) {
   assert(!txn_guard);
 
   MDBX_txn *txn = nullptr;
+  txn_readonly = readonly;
   int rc = mdbx_txn_begin(db_guard.get(), nullptr,
                           readonly ? flags | MDBX_RDONLY : flags, &txn);
   if (unlikely(rc != MDBX_SUCCESS))
@@ -204,9 +223,13 @@ void testcase::txn_end(bool abort) {
     if (unlikely(rc != MDBX_SUCCESS))
       failure_perror("mdbx_txn_abort()", rc);
   } else {
+    const chrono::time start = chrono::now_motonic();
     int rc = mdbx_txn_commit(txn);
     if (unlikely(rc != MDBX_SUCCESS))
       failure_perror("mdbx_txn_commit()", rc);
+    if (!txn_readonly)
+      commit_latency.push_back(chrono::now_motonic().fixedpoint -
+                               start.fixedpoint);
   }
 
   log_trace("<< txn_end(%s)", abort ? "abort" : "commit");
@@ -305,8 +328,28 @@ bool testcase::setup() {
   return true;
 }
 
+void testcase::report_commit_latency() {
+  if (commit_latency.empty())
+    return;
+
+  /* перцентили задержки фиксации пишущих транзакций, в миллисекундах */
+  std::vector<uint64_t> sorted(commit_latency);
+  std::sort(sorted.begin(), sorted.end());
+  auto percentile = [&sorted](unsigned permille) {
+    size_t i = sorted.size() * permille / 1000;
+    if (i >= sorted.size())
+      i = sorted.size() - 1;
+    return sorted[i] * 1e3 / UINT64_C(4294967296);
+  };
+  log_notice("commit-latency: %" PRIuSIZE " commits, p50 %.3f, p90 %.3f, "
+             "p99 %.3f, p99.9 %.3f, max %.3f ms",
+             sorted.size(), percentile(500), percentile(900), percentile(990),
+             percentile(999), percentile(1000));
+}
+
 bool testcase::teardown() {
   log_trace(">> testcase::teardown");
+  report_commit_latency();
   signal();
   db_close();
   log_trace("<< testcase::teardown");
@@ -451,6 +494,15 @@ bool test_execute(const actor_config &config) {
     case ac_try:
       test.reset(new testcase_try(config, pid));
       break;
+    case ac_scan:
+      test.reset(new testcase_scan(config, pid));
+      break;
+    case ac_commit:
+      test.reset(new testcase_commit(config, pid));
+      break;
+    case ac_regress:
+      test.reset(new testcase_regress(config, pid));
+      break;
     default:
       test.reset(new testcase(config, pid));
       break;
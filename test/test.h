@@ -86,6 +86,8 @@ protected:
   scoped_txn_guard txn_guard;
   scoped_cursor_guard cursor_guard;
   bool signalled;
+  bool txn_readonly;
+  std::vector<uint64_t> commit_latency; /* in chrono::time fixedpoint */
 
   size_t nops_completed;
   chrono::time start_timestamp;
@@ -110,6 +112,7 @@ protected:
   void fetch_canary();
   void update_canary(uint64_t increment);
   void kick_progress(bool active) const;
+  void report_commit_latency();
 
   MDBX_dbi db_table_open(bool create);
   void db_table_drop(MDBX_dbi handle);
@@ -136,7 +139,8 @@ protected:
 
 public:
   testcase(const actor_config &config, const mdbx_pid_t pid)
-      : config(config), pid(pid), signalled(false), nops_completed(0) {
+      : config(config), pid(pid), signalled(false), txn_readonly(false),
+        nops_completed(0) {
     start_timestamp.reset();
     memset(&last, 0, sizeof(last));
   }
@@ -201,3 +205,41 @@ public:
   bool run();
   bool teardown();
 };
+
+class testcase_scan : public testcase {
+  typedef testcase inherited;
+
+public:
+  testcase_scan(const actor_config &config, const mdbx_pid_t pid)
+      : testcase(config, pid) {}
+  bool setup();
+  bool run();
+  bool teardown();
+};
+
+class testcase_commit : public testcase {
+  typedef testcase inherited;
+
+public:
+  testcase_commit(const actor_config &config, const mdbx_pid_t pid)
+      : testcase(config, pid) {}
+  bool setup();
+  bool run();
+  bool teardown();
+};
+
+class testcase_regress : public testcase {
+  typedef testcase inherited;
+  MDBX_dbi regress_table_open(const char *name, unsigned flags);
+  void regress_dirtylist();
+  void regress_batch();
+  void regress_fprint();
+  void regress_policy();
+
+public:
+  testcase_regress(const actor_config &config, const mdbx_pid_t pid)
+      : testcase(config, pid) {}
+  bool setup();
+  bool run();
+  bool teardown();
+};